@@ -15,6 +15,9 @@
  */
 
 #include "hello_cardboard_app.h"
+
+#include <algorithm>
+
 #include "myLogic.h"
 
 namespace ndk_hello_cardboard {
@@ -40,6 +43,9 @@ constexpr float kAngleLimit = 0.2f;
 // Number of different possible targets
 constexpr int kTargetMeshCount = 3;
 
+// Eye texels per screen pixel where the lenses need the most texels.
+constexpr float kEyeTextureQuality = 1.0f;
+
 float angle = 5.0f;
 float angle_cat = 5.0f;
 
@@ -107,6 +113,8 @@ HelloCardboardApp::HelloCardboardApp(JavaVM* vm, jobject obj, jobject asset_mgr_
       device_params_changed_(false),
       screen_width_(0),
       screen_height_(0),
+      eye_texture_width_(0),
+      eye_texture_height_(0),
       depthRenderBuffer_(0),
       framebuffer_(0),
       texture_(0),
@@ -273,8 +281,8 @@ void HelloCardboardApp::OnDrawFrame() {
 
   // Draw eyes views
   for (int eye = 0; eye < 2; ++eye) {
-    glViewport(eye == kLeft ? 0 : screen_width_ / 2, 0, screen_width_ / 2,
-               screen_height_);
+    glViewport(eye == kLeft ? 0 : eye_texture_width_, 0, eye_texture_width_,
+               eye_texture_height_);
 
     Matrix4x4 eye_matrix = GetMatrixFromGlArray(eye_matrices_[eye]);
     Matrix4x4 eye_view = eye_matrix * head_view_;
@@ -396,6 +404,20 @@ bool HelloCardboardApp::UpdateDeviceParams() {
 
   CardboardQrCode_destroy(buffer);
 
+  // Both eyes share one side by side texture, sized for the eye needing the
+  // most texels. It is clamped to the screen size so that it never costs more
+  // fill rate than rendering at screen resolution.
+  int left_width, left_height, right_width, right_height;
+  CardboardLensDistortion_getRecommendedEyeTextureSize(
+      lens_distortion_, kLeft, kEyeTextureQuality, &left_width, &left_height);
+  CardboardLensDistortion_getRecommendedEyeTextureSize(
+      lens_distortion_, kRight, kEyeTextureQuality, &right_width,
+      &right_height);
+  eye_texture_width_ =
+      std::min(std::max(left_width, right_width), screen_width_ / 2);
+  eye_texture_height_ =
+      std::min(std::max(left_height, right_height), screen_height_);
+
   GlSetup();
 
   CardboardDistortionRenderer_destroy(distortion_renderer_);
@@ -445,8 +467,8 @@ void HelloCardboardApp::GlSetup() {
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, screen_width_, screen_height_, 0,
-               GL_RGB, GL_UNSIGNED_BYTE, 0);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 2 * eye_texture_width_,
+               eye_texture_height_, 0, GL_RGB, GL_UNSIGNED_BYTE, 0);
 
   left_eye_texture_description_.texture = texture_;
   left_eye_texture_description_.left_u = 0;
@@ -463,8 +485,8 @@ void HelloCardboardApp::GlSetup() {
   // Generate depth buffer to perform depth test.
   glGenRenderbuffers(1, &depthRenderBuffer_);
   glBindRenderbuffer(GL_RENDERBUFFER, depthRenderBuffer_);
-  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, screen_width_,
-                        screen_height_);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16,
+                        2 * eye_texture_width_, eye_texture_height_);
   CHECKGLERROR("Create Render buffer");
 
   // Create render target.
@@ -196,6 +196,9 @@ class HelloCardboardApp {
   bool device_params_changed_;
   int screen_width_;
   int screen_height_;
+  // Size of each eye in the side by side eye texture.
+  int eye_texture_width_;
+  int eye_texture_height_;
 
   float projection_matrices_[2][16];
   float eye_matrices_[2][16];
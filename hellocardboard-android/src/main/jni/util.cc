@@ -29,6 +29,8 @@
 
 #include <GLES2/gl2.h>
 
+#include "cardboard.h"
+
 namespace ndk_hello_cardboard {
 
 namespace {
@@ -455,6 +457,12 @@ int RandomUniformInt(int max_val) {
 }
 
 void CheckGlError(const char* file, int line, const char* label) {
+  // Follows the SDK validation level, as glGetError() syncs the GL pipeline on
+  // many drivers.
+  if (CardboardDistortionRenderer_getGlValidationLevel() !=
+      kGlValidationSynchronous) {
+    return;
+  }
   int gl_error = glGetError();
   if (gl_error != GL_NO_ERROR) {
     LOGE("%s : %d > GL error @ %s: %d", file, line, label, gl_error);
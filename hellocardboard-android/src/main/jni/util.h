@@ -118,7 +118,8 @@ int RandomUniformInt(int max_val);
 
 /**
  * Checks for OpenGL errors, and crashes if one has occurred.  Note that this
- * can be an expensive call, so real applications should call this rarely.
+ * can be an expensive call, so it is a no-op unless the Cardboard SDK GL
+ * validation level is kGlValidationSynchronous.
  *
  * @param file File name
  * @param line Line number
@@ -126,7 +127,12 @@ int RandomUniformInt(int max_val);
  */
 void CheckGlError(const char* file, int line, const char* label);
 
+// Checks are compiled out when CARDBOARD_DISABLE_GL_VALIDATION is defined.
+#ifdef CARDBOARD_DISABLE_GL_VALIDATION
+#define CHECKGLERROR(label)
+#else
 #define CHECKGLERROR(label) CheckGlError(__FILE__, __LINE__, label)
+#endif
 
 /**
  * Converts a string into an OpenGL ES shader.
@@ -22,18 +22,24 @@
 #include "lens_distortion.h"
 #include "qr_code.h"
 #include "qrcode/cardboard_v1/cardboard_v1.h"
+#include "rendering/compositor.h"
+#include "rendering/gl_validation.h"
 #include "screen_params.h"
+#include "sensors/gyroscope_bias_storage.h"
 #include "util/is_arg_null.h"
 #include "util/is_initialized.h"
 #include "util/logging.h"
+#include "util/metrics.h"
 #ifdef __ANDROID__
 #include "device_params/android/device_params.h"
+#include "rendering/android/egl_compositor_backend.h"
 #endif
 
 // TODO(b/134142617): Revisit struct/class hierarchy.
 struct CardboardLensDistortion : cardboard::LensDistortion {};
 struct CardboardDistortionRenderer : cardboard::DistortionRenderer {};
 struct CardboardHeadTracker : cardboard::HeadTracker {};
+struct CardboardCompositor : cardboard::rendering::Compositor {};
 
 namespace {
 
@@ -69,6 +75,30 @@ void GetDefaultDistortionMesh(CardboardMesh* mesh) {
   }
 }
 
+// Highest eye texture quality, in texels per screen pixel.
+constexpr float kMaxEyeTextureQuality = 2.0f;
+
+// Returns true if quality is in (0, kMaxEyeTextureQuality]. Otherwise, it
+// prints an error log. NaN is out of range.
+bool IsEyeTextureQualityValid(float quality) {
+  if (quality > 0.0f && quality <= kMaxEyeTextureQuality) {
+    return true;
+  }
+  CARDBOARD_LOGE("Eye texture quality %f is out of the (0, %f] range.",
+                 quality, kMaxEyeTextureQuality);
+  return false;
+}
+
+// Return default (zero) eye texture size.
+void GetDefaultEyeTextureSize(int* width, int* height) {
+  if (width != nullptr) {
+    *width = 0;
+  }
+  if (height != nullptr) {
+    *height = 0;
+  }
+}
+
 // Return default (empty) encoded device params.
 void GetDefaultEncodedDeviceParams(uint8_t** encoded_device_params, int* size) {
   if (encoded_device_params != nullptr) {
@@ -88,6 +118,29 @@ void GetDefaultPosition(float* position) {
   }
 }
 
+// Return default (zero) angular velocity or acceleration.
+void GetDefaultAngularDerivative(float* angular_derivative) {
+  if (angular_derivative != nullptr) {
+    angular_derivative[0] = 0.0f;
+    angular_derivative[1] = 0.0f;
+    angular_derivative[2] = 0.0f;
+  }
+}
+
+// Return default (zero) latency statistics.
+void GetDefaultLatencyStats(CardboardLatencyStats* stats) {
+  if (stats != nullptr) {
+    *stats = {0, 0, 0, 0, 0, 0};
+  }
+}
+
+// Return default (zero) metrics.
+void GetDefaultMetrics(CardboardMetrics* metrics) {
+  if (metrics != nullptr) {
+    *metrics = {0.0f, 0.0f, 0, 0, 0, 0, 0, 0, 0};
+  }
+}
+
 // Return default (identity quaternion) orientation.
 void GetDefaultOrientation(float* orientation) {
   if (orientation != nullptr) {
@@ -114,6 +167,7 @@ void Cardboard_initializeAndroid(JavaVM* vm, jobject context) {
   cardboard::qrcode::initializeAndroid(vm, global_context);
   cardboard::screen_params::initializeAndroid(vm, global_context);
   cardboard::DeviceParams::initializeAndroid(vm, global_context);
+  cardboard::gyroscope_bias_storage::initializeAndroid(vm, global_context);
 
   cardboard::util::SetIsInitialized();
 }
@@ -181,6 +235,19 @@ void CardboardLensDistortion_getFieldOfView(
       ->GetEyeFieldOfView(eye, field_of_view);
 }
 
+void CardboardLensDistortion_getRecommendedEyeTextureSize(
+    CardboardLensDistortion* lens_distortion, CardboardEye eye, float quality,
+    int* width, int* height) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() ||
+      CARDBOARD_IS_ARG_NULL(lens_distortion) || CARDBOARD_IS_ARG_NULL(width) ||
+      CARDBOARD_IS_ARG_NULL(height) || !IsEyeTextureQualityValid(quality)) {
+    GetDefaultEyeTextureSize(width, height);
+    return;
+  }
+  static_cast<cardboard::LensDistortion*>(lens_distortion)
+      ->GetRecommendedEyeTextureSize(eye, quality, width, height);
+}
+
 void CardboardLensDistortion_getDistortionMesh(
     CardboardLensDistortion* lens_distortion, CardboardEye eye,
     CardboardMesh* mesh) {
@@ -193,6 +260,18 @@ void CardboardLensDistortion_getDistortionMesh(
               ->GetDistortionMesh(eye);
 }
 
+void CardboardLensDistortion_getHiddenAreaMesh(
+    CardboardLensDistortion* lens_distortion, CardboardEye eye,
+    CardboardMesh* mesh) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() ||
+      CARDBOARD_IS_ARG_NULL(lens_distortion) || CARDBOARD_IS_ARG_NULL(mesh)) {
+    GetDefaultDistortionMesh(mesh);
+    return;
+  }
+  *mesh = static_cast<cardboard::LensDistortion*>(lens_distortion)
+              ->GetHiddenAreaMesh(eye);
+}
+
 CardboardUv CardboardLensDistortion_undistortedUvForDistortedUv(
     CardboardLensDistortion* lens_distortion, const CardboardUv* distorted_uv,
     CardboardEye eye) {
@@ -267,6 +346,73 @@ void CardboardDistortionRenderer_setMesh(CardboardDistortionRenderer* renderer,
   static_cast<cardboard::DistortionRenderer*>(renderer)->SetMesh(mesh, eye);
 }
 
+void CardboardDistortionRenderer_setEyeTextureLayout(
+    CardboardDistortionRenderer* renderer, CardboardEyeTextureLayout layout) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(renderer)) {
+    return;
+  }
+  static_cast<cardboard::DistortionRenderer*>(renderer)->SetEyeTextureLayout(
+      layout);
+}
+
+void CardboardDistortionRenderer_setGlValidationLevel(
+    CardboardGlValidationLevel level) {
+  if (CARDBOARD_IS_NOT_INITIALIZED()) {
+    return;
+  }
+  cardboard::rendering::SetGlValidationLevel(level);
+}
+
+CardboardGlValidationLevel CardboardDistortionRenderer_getGlValidationLevel() {
+  if (CARDBOARD_IS_NOT_INITIALIZED()) {
+    return kGlValidationNone;
+  }
+  return cardboard::rendering::GetGlValidationLevel();
+}
+
+void CardboardDistortionRenderer_enableReprojection(
+    CardboardDistortionRenderer* renderer, CardboardHeadTracker* head_tracker,
+    CardboardLensDistortion* lens_distortion) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(renderer) ||
+      CARDBOARD_IS_ARG_NULL(head_tracker) ||
+      CARDBOARD_IS_ARG_NULL(lens_distortion)) {
+    return;
+  }
+  std::array<float, 4> left_fov;
+  std::array<float, 4> right_fov;
+  const auto* distortion =
+      static_cast<cardboard::LensDistortion*>(lens_distortion);
+  distortion->GetEyeFieldOfView(kLeft, &left_fov[0]);
+  distortion->GetEyeFieldOfView(kRight, &right_fov[0]);
+  static_cast<cardboard::DistortionRenderer*>(renderer)
+      ->GetReprojection()
+      .Enable(static_cast<cardboard::HeadTracker*>(head_tracker), left_fov,
+              right_fov);
+}
+
+void CardboardDistortionRenderer_disableReprojection(
+    CardboardDistortionRenderer* renderer) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(renderer)) {
+    return;
+  }
+  static_cast<cardboard::DistortionRenderer*>(renderer)
+      ->GetReprojection()
+      .Disable();
+}
+
+void CardboardDistortionRenderer_setRenderPose(
+    CardboardDistortionRenderer* renderer, int64_t timestamp_ns,
+    const float* orientation) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(renderer) ||
+      CARDBOARD_IS_ARG_NULL(orientation)) {
+    return;
+  }
+  static_cast<cardboard::DistortionRenderer*>(renderer)
+      ->GetReprojection()
+      .SetRenderPose(timestamp_ns, {orientation[0], orientation[1],
+                                    orientation[2], orientation[3]});
+}
+
 void CardboardDistortionRenderer_renderEyeToDisplay(
     CardboardDistortionRenderer* renderer, int target_display, int x, int y,
     int width, int height, const CardboardEyeTextureDescription* left_eye,
@@ -279,6 +425,62 @@ void CardboardDistortionRenderer_renderEyeToDisplay(
       target_display, x, y, width, height, left_eye, right_eye);
 }
 
+#ifdef __ANDROID__
+CardboardCompositor* CardboardCompositor_create(
+    ANativeWindow* window, CardboardHeadTracker* head_tracker,
+    CardboardLensDistortion* lens_distortion, int64_t display_period_ns) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(window) ||
+      CARDBOARD_IS_ARG_NULL(head_tracker) ||
+      CARDBOARD_IS_ARG_NULL(lens_distortion)) {
+    return nullptr;
+  }
+  return reinterpret_cast<CardboardCompositor*>(
+      new cardboard::rendering::Compositor(
+          std::unique_ptr<cardboard::rendering::CompositorBackend>(
+              new cardboard::rendering::EglCompositorBackend(
+                  window, head_tracker, lens_distortion)),
+          std::unique_ptr<cardboard::rendering::DisplayClock>(
+              new cardboard::rendering::SwapPacedDisplayClock(
+                  display_period_ns))));
+}
+#endif
+
+void CardboardCompositor_destroy(CardboardCompositor* compositor) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(compositor)) {
+    return;
+  }
+  delete compositor;
+}
+
+int CardboardCompositor_acquireFrame(CardboardCompositor* compositor) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(compositor)) {
+    return -1;
+  }
+  return static_cast<cardboard::rendering::Compositor*>(compositor)
+      ->AcquireFrame();
+}
+
+void CardboardCompositor_submitFrame(
+    CardboardCompositor* compositor, int frame_index,
+    const CardboardEyeTextureDescription* left_eye,
+    const CardboardEyeTextureDescription* right_eye, int64_t timestamp_ns,
+    const float* orientation) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(compositor) ||
+      CARDBOARD_IS_ARG_NULL(left_eye) || CARDBOARD_IS_ARG_NULL(right_eye) ||
+      CARDBOARD_IS_ARG_NULL(orientation)) {
+    return;
+  }
+  cardboard::rendering::CompositorFrame frame;
+  frame.left_eye = *left_eye;
+  frame.right_eye = *right_eye;
+  frame.render_timestamp_ns = timestamp_ns;
+  frame.render_orientation = {orientation[0], orientation[1], orientation[2],
+                              orientation[3]};
+  frame.fence = nullptr;
+  static_cast<cardboard::rendering::Compositor*>(compositor)
+      ->SubmitFrame(frame_index, frame);
+}
+
 CardboardHeadTracker* CardboardHeadTracker_create() {
   if (CARDBOARD_IS_NOT_INITIALIZED()) {
     return nullptr;
@@ -324,6 +526,186 @@ void CardboardHeadTracker_getPose(CardboardHeadTracker* head_tracker,
   std::memcpy(orientation, &out_orientation[0], 4 * sizeof(float));
 }
 
+void CardboardHeadTracker_getPoseWithDerivatives(
+    CardboardHeadTracker* head_tracker, int64_t timestamp_ns, float* position,
+    float* orientation, float* angular_velocity, float* angular_acceleration) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker) ||
+      CARDBOARD_IS_ARG_NULL(position) || CARDBOARD_IS_ARG_NULL(orientation) ||
+      CARDBOARD_IS_ARG_NULL(angular_velocity) ||
+      CARDBOARD_IS_ARG_NULL(angular_acceleration)) {
+    GetDefaultPosition(position);
+    GetDefaultOrientation(orientation);
+    GetDefaultAngularDerivative(angular_velocity);
+    GetDefaultAngularDerivative(angular_acceleration);
+    return;
+  }
+  std::array<float, 3> out_position;
+  std::array<float, 4> out_orientation;
+  std::array<float, 3> out_angular_velocity;
+  std::array<float, 3> out_angular_acceleration;
+  static_cast<cardboard::HeadTracker*>(head_tracker)
+      ->GetPose(timestamp_ns, out_position, out_orientation,
+                out_angular_velocity, out_angular_acceleration);
+  std::memcpy(position, &out_position[0], 3 * sizeof(float));
+  std::memcpy(orientation, &out_orientation[0], 4 * sizeof(float));
+  std::memcpy(angular_velocity, &out_angular_velocity[0], 3 * sizeof(float));
+  std::memcpy(angular_acceleration, &out_angular_acceleration[0],
+              3 * sizeof(float));
+}
+
+void CardboardHeadTracker_getPoses(CardboardHeadTracker* head_tracker,
+                                   const int64_t* timestamps_ns, int count,
+                                   float* positions, float* orientations) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker) ||
+      CARDBOARD_IS_ARG_NULL(timestamps_ns) || CARDBOARD_IS_ARG_NULL(positions) ||
+      CARDBOARD_IS_ARG_NULL(orientations) || count <= 0) {
+    for (int i = 0; i < count; ++i) {
+      GetDefaultPosition(positions != nullptr ? positions + 3 * i : nullptr);
+      GetDefaultOrientation(orientations != nullptr ? orientations + 4 * i
+                                                    : nullptr);
+    }
+    return;
+  }
+  static_cast<cardboard::HeadTracker*>(head_tracker)
+      ->GetPoses(timestamps_ns, count, positions, orientations);
+}
+
+void CardboardHeadTracker_setViewportOrientation(
+    CardboardHeadTracker* head_tracker,
+    CardboardViewportOrientation viewport_orientation) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker)) {
+    return;
+  }
+  cardboard::HeadTracker::ViewportOrientation orientation;
+  switch (viewport_orientation) {
+    case kLandscapeRight:
+      orientation = cardboard::HeadTracker::ViewportOrientation::kLandscapeRight;
+      break;
+    case kPortrait:
+      orientation = cardboard::HeadTracker::ViewportOrientation::kPortrait;
+      break;
+    case kPortraitUpsideDown:
+      orientation =
+          cardboard::HeadTracker::ViewportOrientation::kPortraitUpsideDown;
+      break;
+    case kLandscapeLeft:
+    default:
+      orientation = cardboard::HeadTracker::ViewportOrientation::kLandscapeLeft;
+      break;
+  }
+  static_cast<cardboard::HeadTracker*>(head_tracker)
+      ->SetViewportOrientation(orientation);
+}
+
+void CardboardHeadTracker_setSensorRateHint(CardboardHeadTracker* head_tracker,
+                                            CardboardSensorRateHint hint) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker)) {
+    return;
+  }
+  static_cast<cardboard::HeadTracker*>(head_tracker)
+      ->SetSensorRateHint(hint == kSensorRateLow
+                              ? cardboard::SensorRatePolicy::Hint::kLow
+                              : cardboard::SensorRatePolicy::Hint::kDefault);
+}
+
+void CardboardHeadTracker_setAccelerometerCorrectionRate(
+    CardboardHeadTracker* head_tracker, float rate_hz) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker)) {
+    return;
+  }
+  static_cast<cardboard::HeadTracker*>(head_tracker)
+      ->SetAccelerometerCorrectionRate(rate_hz);
+}
+
+float CardboardHeadTracker_getSensorSamplingRate(
+    CardboardHeadTracker* head_tracker) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker)) {
+    return 0.0f;
+  }
+  return static_cast<cardboard::HeadTracker*>(head_tracker)
+      ->GetSensorSamplingRate();
+}
+
+CardboardTrackingState CardboardHeadTracker_getTrackingState(
+    CardboardHeadTracker* head_tracker) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker)) {
+    return kTrackingFullRate;
+  }
+  return static_cast<cardboard::HeadTracker*>(head_tracker)
+                 ->IsLowPowerTracking()
+             ? kTrackingLowPower
+             : kTrackingFullRate;
+}
+
+void CardboardHeadTracker_getLatencyStats(CardboardHeadTracker* head_tracker,
+                                          CardboardLatencyStage stage,
+                                          CardboardLatencyStats* out_stats) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker) ||
+      CARDBOARD_IS_ARG_NULL(out_stats)) {
+    GetDefaultLatencyStats(out_stats);
+    return;
+  }
+  cardboard::HeadTracker::LatencyStage latency_stage;
+  switch (stage) {
+    case kLatencySensorToCallback:
+      latency_stage = cardboard::HeadTracker::LatencyStage::kSensorToCallback;
+      break;
+    case kLatencyCallbackToFusion:
+      latency_stage = cardboard::HeadTracker::LatencyStage::kCallbackToFusion;
+      break;
+    case kLatencyFusionToPose:
+    default:
+      latency_stage = cardboard::HeadTracker::LatencyStage::kFusionToPose;
+      break;
+  }
+  const cardboard::LatencyHistogram::Stats stats =
+      static_cast<cardboard::HeadTracker*>(head_tracker)
+          ->GetLatencyStats(latency_stage);
+  out_stats->sample_count = stats.count;
+  out_stats->mean_ns = stats.mean_ns;
+  out_stats->p50_ns = stats.p50_ns;
+  out_stats->p90_ns = stats.p90_ns;
+  out_stats->p99_ns = stats.p99_ns;
+  out_stats->max_ns = stats.max_ns;
+}
+
+void CardboardHeadTracker_resetLatencyStats(
+    CardboardHeadTracker* head_tracker) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker)) {
+    return;
+  }
+  static_cast<cardboard::HeadTracker*>(head_tracker)->ResetLatencyStats();
+}
+
+void CardboardMetrics_getSnapshot(CardboardMetrics* out_metrics) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(out_metrics)) {
+    GetDefaultMetrics(out_metrics);
+    return;
+  }
+  const cardboard::Metrics::Snapshot snapshot =
+      cardboard::Metrics::GetInstance().GetSnapshot();
+  out_metrics->accelerometer_rate_hz = snapshot.accelerometer_rate_hz;
+  out_metrics->gyroscope_rate_hz = snapshot.gyroscope_rate_hz;
+  out_metrics->accelerometer_outdated_samples =
+      snapshot.accelerometer_outdated_samples;
+  out_metrics->gyroscope_outdated_samples = snapshot.gyroscope_outdated_samples;
+  out_metrics->gyroscope_timestep_fallbacks =
+      snapshot.gyroscope_timestep_fallbacks;
+  out_metrics->fusion_time_mean_ns = snapshot.fusion_time.mean_ns;
+  out_metrics->fusion_time_p99_ns = snapshot.fusion_time.p99_ns;
+  out_metrics->distortion_submit_time_mean_ns =
+      snapshot.distortion_submit_time.mean_ns;
+  out_metrics->distortion_submit_time_p99_ns =
+      snapshot.distortion_submit_time.p99_ns;
+}
+
+void CardboardMetrics_reset() {
+  if (CARDBOARD_IS_NOT_INITIALIZED()) {
+    return;
+  }
+  cardboard::Metrics::GetInstance().Reset();
+}
+
 void CardboardQrCode_getSavedDeviceParams(uint8_t** encoded_device_params,
                                           int* size) {
   if (CARDBOARD_IS_NOT_INITIALIZED() ||
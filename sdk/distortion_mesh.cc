@@ -26,7 +26,8 @@ DistortionMesh::DistortionMesh(
     // Units of the following parameters are tan-angle units.
     float screen_width, float screen_height, float x_eye_offset_screen,
     float y_eye_offset_screen, float texture_width, float texture_height,
-    float x_eye_offset_texture, float y_eye_offset_texture) {
+    float x_eye_offset_texture, float y_eye_offset_texture,
+    float visible_min_u_screen, float visible_max_u_screen) {
   vertex_data_.resize(kResolution * kResolution *
                       2);                           // 2 components per vertex
   uvs_data_.resize(kResolution * kResolution * 2);  // 2 components per uv
@@ -110,6 +111,8 @@ DistortionMesh::DistortionMesh(
     }
     vertex_offset = vertex_offset + kResolution;
   }
+
+  ComputeHiddenAreaMesh(visible_min_u_screen, visible_max_u_screen);
 }
 
 CardboardMesh DistortionMesh::GetMesh() const {
@@ -122,4 +125,83 @@ CardboardMesh DistortionMesh::GetMesh() const {
   return mesh;
 }
 
+CardboardMesh DistortionMesh::GetHiddenAreaMesh() const {
+  CardboardMesh mesh;
+  mesh.indices = const_cast<int*>(hidden_area_index_data_.data());
+  mesh.vertices = const_cast<float*>(hidden_area_vertex_data_.data());
+  mesh.uvs = const_cast<float*>(hidden_area_uvs_data_.data());
+  mesh.n_indices = hidden_area_index_data_.size();
+  mesh.n_vertices = hidden_area_vertex_data_.size() / 2;
+  return mesh;
+}
+
+void DistortionMesh::ComputeHiddenAreaMesh(float visible_min_u_screen,
+                                           float visible_max_u_screen) {
+  // Visible screen rectangle in NDC.
+  const float min_x = 2 * visible_min_u_screen - 1;
+  const float max_x = 2 * visible_max_u_screen - 1;
+  const auto x = [this](int row, int col) {
+    return vertex_data_[(row * kResolution + col) * 2];
+  };
+  const auto y = [this](int row, int col) {
+    return vertex_data_[(row * kResolution + col) * 2 + 1];
+  };
+  // A texture cell is displayed by the mesh quad with the same corners. Both
+  // quad triangles lie within the convex hull of those corners, so the cell
+  // is never displayed when all of them are beyond one side of the visible
+  // rectangle.
+  const auto is_hidden = [&](int row, int col) {
+    bool left = true, right = true, bottom = true, top = true;
+    for (int corner = 0; corner < 4; corner++) {
+      const int corner_row = row + corner / 2;
+      const int corner_col = col + corner % 2;
+      left = left && x(corner_row, corner_col) < min_x;
+      right = right && x(corner_row, corner_col) > max_x;
+      bottom = bottom && y(corner_row, corner_col) < -1;
+      top = top && y(corner_row, corner_col) > 1;
+    }
+    return left || right || bottom || top;
+  };
+
+  // Grid vertex index to hidden area vertex index, or -1 if unused.
+  std::vector<int> vertex_map(kResolution * kResolution, -1);
+  const auto add_vertex = [&](int row, int col) {
+    int& index = vertex_map[row * kResolution + col];
+    if (index < 0) {
+      index = hidden_area_vertex_data_.size() / 2;
+      const float u = static_cast<float>(col) / (kResolution - 1);
+      const float v = static_cast<float>(row) / (kResolution - 1);
+      hidden_area_vertex_data_.push_back(2 * u - 1);
+      hidden_area_vertex_data_.push_back(2 * v - 1);
+      hidden_area_uvs_data_.push_back(u);
+      hidden_area_uvs_data_.push_back(v);
+    }
+    return index;
+  };
+
+  // Each run of hidden cells in a row is covered by one quad, as two
+  // counterclockwise triangles.
+  for (int row = 0; row < kResolution - 1; row++) {
+    int col = 0;
+    while (col < kResolution - 1) {
+      if (!is_hidden(row, col)) {
+        col++;
+        continue;
+      }
+      const int run_start = col;
+      while (col < kResolution - 1 && is_hidden(row, col)) {
+        col++;
+      }
+      const int bottom_left = add_vertex(row, run_start);
+      const int bottom_right = add_vertex(row, col);
+      const int top_left = add_vertex(row + 1, run_start);
+      const int top_right = add_vertex(row + 1, col);
+      hidden_area_index_data_.insert(
+          hidden_area_index_data_.end(),
+          {bottom_left, bottom_right, top_left, top_left, bottom_right,
+           top_right});
+    }
+  }
+}
+
 }  // namespace cardboard
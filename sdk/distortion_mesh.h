@@ -30,15 +30,28 @@ class DistortionMesh {
                  float screen_width, float screen_height,
                  float x_eye_offset_screen, float y_eye_offset_screen,
                  float texture_width, float texture_height,
-                 float x_eye_offset_texture, float y_eye_offset_texture);
+                 float x_eye_offset_texture, float y_eye_offset_texture,
+                 // Range of normalized [0, 1] screen u coordinates the eye is
+                 // displayed on. The rest of the screen is scissored out.
+                 float visible_min_u_screen, float visible_max_u_screen);
   virtual ~DistortionMesh() = default;
   CardboardMesh GetMesh() const;
+  // Returns the triangle list covering the eye texture cells that the mesh
+  // never displays. Vertices are in eye texture NDC and uvs in eye texture
+  // [0, 1] coordinates.
+  CardboardMesh GetHiddenAreaMesh() const;
 
  private:
+  void ComputeHiddenAreaMesh(float visible_min_u_screen,
+                             float visible_max_u_screen);
+
   static constexpr int kResolution = 40;
   std::vector<int> index_data_;
   std::vector<float> vertex_data_;
   std::vector<float> uvs_data_;
+  std::vector<int> hidden_area_index_data_;
+  std::vector<float> hidden_area_vertex_data_;
+  std::vector<float> hidden_area_uvs_data_;
 };
 
 }  // namespace cardboard
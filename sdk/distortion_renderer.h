@@ -20,6 +20,7 @@
 #include <cstdio>
 
 #include "include/cardboard.h"
+#include "rendering/rotational_reprojection.h"
 
 namespace cardboard {
 
@@ -29,10 +30,17 @@ class DistortionRenderer {
  public:
   virtual ~DistortionRenderer() = default;
   virtual void SetMesh(const CardboardMesh* mesh, CardboardEye eye) = 0;
+  virtual void SetEyeTextureLayout(CardboardEyeTextureLayout layout) = 0;
   virtual void RenderEyeToDisplay(
       int target_display, int x, int y, int width, int height,
       const CardboardEyeTextureDescription* left_eye,
       const CardboardEyeTextureDescription* right_eye) const = 0;
+
+  // Returns the rotational reprojection applied by RenderEyeToDisplay().
+  rendering::RotationalReprojection& GetReprojection() { return reprojection_; }
+
+ protected:
+  rendering::RotationalReprojection reprojection_;
 };
 
 }  // namespace cardboard
@@ -15,31 +15,102 @@
  */
 #include "head_tracker.h"
 
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+
+#include "sensors/device_gyroscope_sensor.h"
+#include "sensors/gyroscope_bias_storage.h"
 #include "sensors/neck_model.h"
 #include "sensors/pose_prediction.h"
 #include "util/logging.h"
+#include "util/simd_math.h"
+#include "util/trace.h"
 #include "util/vector.h"
 #include "util/vectorutils.h"
 #include "util/logging.h"
 
 namespace cardboard {
 
+namespace {
+
+// Rotations from sensor space to display space, as [x, y, z, w] quaternions,
+// indexed by HeadTracker::ViewportOrientation. They rotate around the z axis,
+// which points out of the screen in both spaces.
+constexpr std::array<std::array<float, 4>, 4> kSensorToDisplayRotations = {{
+    // kLandscapeLeft: pi / 2.
+    {{0.0f, 0.0f, 0.7071067812f, 0.7071067812f}},
+    // kLandscapeRight: -pi / 2.
+    {{0.0f, 0.0f, -0.7071067812f, 0.7071067812f}},
+    // kPortrait: identity.
+    {{0.0f, 0.0f, 0.0f, 1.0f}},
+    // kPortraitUpsideDown: pi.
+    {{0.0f, 0.0f, 1.0f, 0.0f}},
+}};
+
+// Rotation from the EKF start space to the head tracker space, as a [x, y, z,
+// w] quaternion. Equals Rotation::FromYawPitchRoll(-pi / 2, 0, -pi / 2).
+constexpr std::array<float, 4> kEkfToHeadTrackerRotation = {
+    {0.5f, -0.5f, -0.5f, 0.5f}};
+
+// Hamilton product of two [x, y, z, w] quaternions, same as Rotation::operator*
+// without the normalization.
+std::array<float, 4> QuaternionMultiply(const std::array<float, 4>& a,
+                                        const std::array<float, 4>& b) {
+  std::array<float, 4> result;
+  simd_math::QuaternionMultiply(a.data(), b.data(), result.data());
+  return result;
+}
+
+// Returns the current time of the clock sensor timestamps are based on.
+int64_t GetSensorClockTimeNs() {
+#if defined(__ANDROID__)
+  // Sensor events are timestamped in the elapsedRealtimeNanos() time base.
+  timespec now;
+  clock_gettime(CLOCK_BOOTTIME, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+#elif defined(__APPLE__)
+  // CMLogItem timestamps are the time since boot, not counting sleep.
+  return static_cast<int64_t>(clock_gettime_nsec_np(CLOCK_UPTIME_RAW));
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+}  // namespace
+
 HeadTracker::HeadTracker()
     : is_tracking_(false),
       sensor_fusion_(new SensorFusionEkf()),
       latest_gyroscope_data_({0, 0, Vector3::Zero()}),
       accel_sensor_(new SensorEventProducer<AccelerometerData>()),
-      gyro_sensor_(new SensorEventProducer<GyroscopeData>()) {
+      gyro_sensor_(new SensorEventProducer<GyroscopeData>()),
+      is_system_gyroscope_bias_checked_(false),
+      viewport_orientation_(ViewportOrientation::kLandscapeLeft),
+      latest_fusion_time_ns_(0) {
   sensor_fusion_->SetBiasEstimationEnabled(/*kGyroBiasEstimationEnabled*/ true);
+  // Start from the bias estimated by a previous session, if any, so drift
+  // correction does not need to wait for the device to be static.
+  Vector3 saved_gyroscope_bias;
+  if (gyroscope_bias_storage::readGyroscopeBias(&saved_gyroscope_bias)) {
+    sensor_fusion_->SetInitialGyroscopeBias(saved_gyroscope_bias);
+  }
   on_accel_callback_ = [&](const AccelerometerData& event) {
     OnAccelerometerData(event);
   };
   on_gyro_callback_ = [&](const GyroscopeData& event) {
-    OnGyroscopeData(event);
+    OnGyroscopeCallback(event);
   };
 }
 
-HeadTracker::~HeadTracker() { UnregisterCallbacks(); }
+HeadTracker::~HeadTracker() {
+  UnregisterCallbacks();
+  SaveGyroscopeBias();
+}
 
 void HeadTracker::Pause() {
   if (!is_tracking_) {
@@ -57,9 +128,13 @@ void HeadTracker::Pause() {
   OnGyroscopeData(event);
 
   is_tracking_ = false;
+  // Poses queried while paused are not waiting for sensor fusion.
+  latest_fusion_time_ns_ = 0;
+  SaveGyroscopeBias();
 }
 
 void HeadTracker::Resume() {
+  is_system_gyroscope_bias_checked_ = false;
   is_tracking_ = true;
   RegisterCallbacks();
 }
@@ -67,38 +142,116 @@ void HeadTracker::Resume() {
 void HeadTracker::GetPose(int64_t timestamp_ns,
                           std::array<float, 3>& out_position,
                           std::array<float, 4>& out_orientation) const {
-  Rotation predicted_rotation;
+  CARDBOARD_TRACE_SCOPE("HeadTracker::GetPose");
   const PoseState pose_state = sensor_fusion_->GetLatestPoseState();
-  if (!sensor_fusion_->IsFullyInitialized()) {
+  const bool is_fully_initialized = sensor_fusion_->IsFullyInitialized();
+  RecordPoseLatency();
+  if (!is_fully_initialized) {
     CARDBOARD_LOGI(
         "Head Tracker not fully initialized yet. Using pose prediction only.");
-    predicted_rotation = pose_prediction::PredictPose(timestamp_ns, pose_state);
-  } else {
-    predicted_rotation = pose_state.sensor_from_start_rotation;
   }
+  GetPoseFromState(pose_state, is_fully_initialized, timestamp_ns,
+                   out_position, out_orientation);
+}
 
-  // In order to update our pose as the sensor changes, we begin with the
-  // inverse default orientation (the orientation returned by a reset sensor),
-  // apply the current sensor transformation, and then transform into display
-  // space.
-  // TODO(b/135488467): Support different screen orientations.
-  const Rotation ekf_to_head_tracker =
-      Rotation::FromYawPitchRoll(-M_PI / 2.0, 0, -M_PI / 2.0);
+void HeadTracker::GetPose(int64_t timestamp_ns,
+                          std::array<float, 3>& out_position,
+                          std::array<float, 4>& out_orientation,
+                          std::array<float, 3>& out_angular_velocity,
+                          std::array<float, 3>& out_angular_acceleration) const {
+  CARDBOARD_TRACE_SCOPE("HeadTracker::GetPose");
+  const PoseState pose_state = sensor_fusion_->GetLatestPoseState();
+  const bool is_fully_initialized = sensor_fusion_->IsFullyInitialized();
+  RecordPoseLatency();
+  if (!is_fully_initialized) {
+    CARDBOARD_LOGI(
+        "Head Tracker not fully initialized yet. Using pose prediction only.");
+  }
+  GetPoseFromState(pose_state, is_fully_initialized, timestamp_ns,
+                   out_position, out_orientation);
+
+  const std::array<float, 4>& q =
+      kSensorToDisplayRotations[static_cast<int>(viewport_orientation_.load())];
   const Rotation sensor_to_display =
-      Rotation::FromAxisAndAngle(Vector3(0, 0, 1), M_PI / 2.0);
+      Rotation::FromQuaternion(Vector4(q[0], q[1], q[2], q[3]));
+  const Vector3 angular_velocity =
+      sensor_to_display * pose_state.sensor_from_start_rotation_velocity;
+  const Vector3 angular_acceleration =
+      sensor_to_display * pose_state.sensor_from_start_rotation_acceleration;
+  for (int i = 0; i < 3; ++i) {
+    out_angular_velocity[i] = static_cast<float>(angular_velocity[i]);
+    out_angular_acceleration[i] = static_cast<float>(angular_acceleration[i]);
+  }
+}
 
-  const Vector4 q =
-      (sensor_to_display * predicted_rotation * ekf_to_head_tracker)
-          .GetQuaternion();
-  Rotation rotation;
-  rotation.SetQuaternion(q);
+void HeadTracker::GetPoses(const int64_t* timestamps_ns, int count,
+                           float* out_positions,
+                           float* out_orientations) const {
+  CARDBOARD_TRACE_SCOPE("HeadTracker::GetPoses");
+  // All poses are computed from the same filter state so they are consistent
+  // with each other, and the fusion lock is only taken once.
+  const PoseState pose_state = sensor_fusion_->GetLatestPoseState();
+  const bool is_fully_initialized = sensor_fusion_->IsFullyInitialized();
+  RecordPoseLatency();
+  if (!is_fully_initialized) {
+    CARDBOARD_LOGI(
+        "Head Tracker not fully initialized yet. Using pose prediction only.");
+  }
+  std::array<float, 3> position;
+  std::array<float, 4> orientation;
+  for (int i = 0; i < count; ++i) {
+    GetPoseFromState(pose_state, is_fully_initialized, timestamps_ns[i],
+                     position, orientation);
+    std::copy(position.begin(), position.end(), out_positions + 3 * i);
+    std::copy(orientation.begin(), orientation.end(), out_orientations + 4 * i);
+  }
+}
 
-  out_orientation[0] = static_cast<float>(rotation.GetQuaternion()[0]);
-  out_orientation[1] = static_cast<float>(rotation.GetQuaternion()[1]);
-  out_orientation[2] = static_cast<float>(rotation.GetQuaternion()[2]);
-  out_orientation[3] = static_cast<float>(rotation.GetQuaternion()[3]);
+void HeadTracker::SetSensorRateHint(SensorRatePolicy::Hint hint) {
+  std::unique_lock<std::mutex> lock(sensor_rate_mutex_);
+  if (sensor_rate_policy_.SetHint(hint)) {
+    ApplySensorSamplingPeriod();
+  }
+}
 
-  out_position = ApplyNeckModel(out_orientation, 1.0);
+void HeadTracker::SetAccelerometerCorrectionRate(float rate_hz) {
+  sensor_fusion_->SetAccelerometerCorrectionRate(rate_hz);
+}
+
+void HeadTracker::SetViewportOrientation(
+    ViewportOrientation viewport_orientation) {
+  viewport_orientation_ = viewport_orientation;
+}
+
+float HeadTracker::GetSensorSamplingRate() const {
+  const int sampling_period_us = gyro_sensor_->GetSamplingPeriod();
+  if (sampling_period_us <= 0) {
+    return 0.0f;
+  }
+  return 1e6f / static_cast<float>(sampling_period_us);
+}
+
+bool HeadTracker::IsLowPowerTracking() const {
+  return sensor_fusion_->IsLowPowerTracking();
+}
+
+LatencyHistogram::Stats HeadTracker::GetLatencyStats(
+    LatencyStage stage) const {
+  switch (stage) {
+    case LatencyStage::kSensorToCallback:
+      return sensor_to_callback_latency_.GetStats();
+    case LatencyStage::kCallbackToFusion:
+      return callback_to_fusion_latency_.GetStats();
+    case LatencyStage::kFusionToPose:
+    default:
+      return fusion_to_pose_latency_.GetStats();
+  }
+}
+
+void HeadTracker::ResetLatencyStats() {
+  sensor_to_callback_latency_.Reset();
+  callback_to_fusion_latency_.Reset();
+  fusion_to_pose_latency_.Reset();
 }
 
 Rotation HeadTracker::GetDefaultOrientation() const {
@@ -106,6 +259,45 @@ Rotation HeadTracker::GetDefaultOrientation() const {
       Matrix3x3(0.0, -1.0, 0.0, 0.0, 0.0, 1.0, -1.0, 0.0, 0.0));
 }
 
+void HeadTracker::GetPoseFromState(const PoseState& pose_state,
+                                   bool is_fully_initialized,
+                                   int64_t timestamp_ns,
+                                   std::array<float, 3>& out_position,
+                                   std::array<float, 4>& out_orientation) const {
+  Rotation predicted_rotation;
+  if (!is_fully_initialized) {
+    predicted_rotation = pose_prediction::PredictPose(timestamp_ns, pose_state);
+  } else {
+    predicted_rotation = pose_state.sensor_from_start_rotation;
+  }
+
+  // In order to update our pose as the sensor changes, we begin with the
+  // inverse default orientation (the orientation returned by a reset sensor),
+  // apply the current sensor transformation, and then transform into display
+  // space. The composition runs in single precision with constant rotations,
+  // and is normalized once.
+  const Vector4& r = predicted_rotation.GetQuaternion();
+  const std::array<float, 4> sensor_from_start = {
+      {static_cast<float>(r[0]), static_cast<float>(r[1]),
+       static_cast<float>(r[2]), static_cast<float>(r[3])}};
+  out_orientation = QuaternionMultiply(
+      QuaternionMultiply(
+          kSensorToDisplayRotations[static_cast<int>(
+              viewport_orientation_.load())],
+          sensor_from_start),
+      kEkfToHeadTrackerRotation);
+  const float inverse_norm =
+      1.0f / std::sqrt(out_orientation[0] * out_orientation[0] +
+                       out_orientation[1] * out_orientation[1] +
+                       out_orientation[2] * out_orientation[2] +
+                       out_orientation[3] * out_orientation[3]);
+  for (float& component : out_orientation) {
+    component *= inverse_norm;
+  }
+
+  out_position = ApplyNeckModel(out_orientation, 1.0);
+}
+
 void HeadTracker::RegisterCallbacks() {
   accel_sensor_->StartSensorPolling(&on_accel_callback_);
   gyro_sensor_->StartSensorPolling(&on_gyro_callback_);
@@ -116,19 +308,74 @@ void HeadTracker::UnregisterCallbacks() {
   gyro_sensor_->StopSensorPolling();
 }
 
+void HeadTracker::ApplySensorSamplingPeriod() {
+  const int sampling_period_us = sensor_rate_policy_.GetSamplingPeriodUs();
+  CARDBOARD_TRACE_COUNTER("HeadTracker::SamplingPeriodUs", sampling_period_us);
+  accel_sensor_->SetSamplingPeriod(sampling_period_us);
+  gyro_sensor_->SetSamplingPeriod(sampling_period_us);
+}
+
+void HeadTracker::UpdateSensorSamplingPeriod() {
+  // Lower the sensors rate while the device is static, even more in low power
+  // tracking mode, and restore it as soon as it moves.
+  std::unique_lock<std::mutex> lock(sensor_rate_mutex_);
+  if (sensor_rate_policy_.Update(sensor_fusion_->IsDeviceStatic(),
+                                 sensor_fusion_->IsLowPowerTracking())) {
+    ApplySensorSamplingPeriod();
+  }
+}
+
+void HeadTracker::SaveGyroscopeBias() const {
+  Vector3 gyroscope_bias;
+  if (sensor_fusion_->GetConvergedGyroscopeBias(&gyroscope_bias)) {
+    gyroscope_bias_storage::writeGyroscopeBias(gyroscope_bias);
+  }
+}
+
 void HeadTracker::OnAccelerometerData(const AccelerometerData& event) {
   if (!is_tracking_) {
     return;
   }
   sensor_fusion_->ProcessAccelerometerSample(event);
+  // The accelerometer may detect motion in low power tracking mode.
+  UpdateSensorSamplingPeriod();
+}
+
+void HeadTracker::OnGyroscopeCallback(const GyroscopeData& event) {
+  const int64_t callback_time_ns = GetSensorClockTimeNs();
+  sensor_to_callback_latency_.Record(
+      callback_time_ns - static_cast<int64_t>(event.sensor_timestamp_ns));
+  OnGyroscopeData(event);
+  const int64_t fusion_time_ns = GetSensorClockTimeNs();
+  callback_to_fusion_latency_.Record(fusion_time_ns - callback_time_ns);
+  latest_fusion_time_ns_ = fusion_time_ns;
+}
+
+void HeadTracker::RecordPoseLatency() const {
+  const int64_t latest_fusion_time_ns = latest_fusion_time_ns_;
+  if (latest_fusion_time_ns != 0) {
+    fusion_to_pose_latency_.Record(GetSensorClockTimeNs() -
+                                   latest_fusion_time_ns);
+  }
 }
 
 void HeadTracker::OnGyroscopeData(const GyroscopeData& event) {
   if (!is_tracking_) {
     return;
   }
+  // The system bias is only available once the first gyroscope sample has
+  // been polled. When provided, it takes precedence over the saved one.
+  if (!is_system_gyroscope_bias_checked_) {
+    is_system_gyroscope_bias_checked_ = true;
+    const Vector3 system_gyroscope_bias =
+        DeviceGyroscopeSensor::GetInitialSystemBias();
+    if (LengthSquared(system_gyroscope_bias) > 0.0) {
+      sensor_fusion_->SetInitialGyroscopeBias(system_gyroscope_bias);
+    }
+  }
   latest_gyroscope_data_ = event;
   sensor_fusion_->ProcessGyroscopeSample(event);
+  UpdateSensorSamplingPeriod();
 }
 
 }  // namespace cardboard
@@ -22,8 +22,11 @@
 
 #include "sensors/accelerometer_data.h"
 #include "sensors/gyroscope_data.h"
+#include "sensors/pose_state.h"
 #include "sensors/sensor_event_producer.h"
 #include "sensors/sensor_fusion_ekf.h"
+#include "sensors/sensor_rate_policy.h"
+#include "util/latency_histogram.h"
 #include "util/rotation.h"
 
 namespace cardboard {
@@ -33,6 +36,25 @@ namespace cardboard {
 // This pose tracker reports poses in display space.
 class HeadTracker {
  public:
+  // Orientation of the display with respect to the device natural (portrait)
+  // orientation.
+  enum class ViewportOrientation {
+    kLandscapeLeft = 0,
+    kLandscapeRight = 1,
+    kPortrait = 2,
+    kPortraitUpsideDown = 3,
+  };
+
+  // Stages of the head tracking pipeline whose latency is measured.
+  enum class LatencyStage {
+    // From the gyroscope sample sensor timestamp to the sensor callback.
+    kSensorToCallback = 0,
+    // From the sensor callback to the end of the sensor fusion of the sample.
+    kCallbackToFusion = 1,
+    // From the end of the latest sensor fusion to a pose query.
+    kFusionToPose = 2,
+  };
+
   HeadTracker();
   virtual ~HeadTracker();
 
@@ -43,10 +65,53 @@ class HeadTracker {
   void Resume();
 
   // Gets the predicted pose for a given timestamp.
-  // TODO(b/135488467): Support different display to sensor orientations.
   void GetPose(int64_t timestamp_ns, std::array<float, 3>& out_position,
                std::array<float, 4>& out_orientation) const;
 
+  // Gets the predicted pose for a given timestamp along with the angular
+  // velocity and the low-pass filtered angular acceleration of the head. Both
+  // derivatives are bias corrected and expressed in display space axes.
+  void GetPose(int64_t timestamp_ns, std::array<float, 3>& out_position,
+               std::array<float, 4>& out_orientation,
+               std::array<float, 3>& out_angular_velocity,
+               std::array<float, 3>& out_angular_acceleration) const;
+
+  // Gets the predicted poses for several timestamps. All poses are computed
+  // from the same snapshot of the sensor fusion state.
+  //
+  // @param timestamps_ns timestamps of the poses, count elements.
+  // @param count number of poses.
+  // @param out_positions 3 * count floats receiving the positions.
+  // @param out_orientations 4 * count floats receiving the orientations.
+  void GetPoses(const int64_t* timestamps_ns, int count, float* out_positions,
+                float* out_orientations) const;
+
+  // Sets the display orientation poses are reported for. Landscape left by
+  // default.
+  void SetViewportOrientation(ViewportOrientation viewport_orientation);
+
+  // Sets a hint about the sensor sampling rate the app needs.
+  void SetSensorRateHint(SensorRatePolicy::Hint hint);
+
+  // Sets the rate at which accelerometer measurements correct the pose, see
+  // SensorFusionEkf::SetAccelerometerCorrectionRate.
+  void SetAccelerometerCorrectionRate(float rate_hz);
+
+  // Returns the current gyroscope sampling rate in Hz, or zero when the
+  // sensors are not running.
+  float GetSensorSamplingRate() const;
+
+  // Returns true if tracking is in low power mode, see
+  // SensorFusionEkf::IsLowPowerTracking.
+  bool IsLowPowerTracking() const;
+
+  // Returns the latencies measured for a stage of the pipeline since the last
+  // reset.
+  LatencyHistogram::Stats GetLatencyStats(LatencyStage stage) const;
+
+  // Clears the latencies measured for all stages.
+  void ResetLatencyStats();
+
  private:
   // Function called when receiving AccelerometerData.
   //
@@ -58,6 +123,15 @@ class HeadTracker {
   // @param event sensor event.
   void OnGyroscopeData(const GyroscopeData& event);
 
+  // Callback registered to the gyroscope SensorEventProducer. It measures the
+  // sensor and fusion latencies around OnGyroscopeData.
+  //
+  // @param event sensor event.
+  void OnGyroscopeCallback(const GyroscopeData& event);
+
+  // Records the latency from the latest sensor fusion to a pose query.
+  void RecordPoseLatency() const;
+
   // Registers this as a listener for data from the accel and gyro sensors. This
   // is useful for informing the sensors that they may need to start polling for
   // data.
@@ -69,6 +143,25 @@ class HeadTracker {
 
   Rotation GetDefaultOrientation() const;
 
+  // Computes the pose in display space at a given timestamp from a snapshot of
+  // the sensor fusion state.
+  void GetPoseFromState(const PoseState& pose_state, bool is_fully_initialized,
+                        int64_t timestamp_ns,
+                        std::array<float, 3>& out_position,
+                        std::array<float, 4>& out_orientation) const;
+
+  // Requests the sampling period decided by sensor_rate_policy_ to the
+  // sensors. Must be called with sensor_rate_mutex_ held.
+  void ApplySensorSamplingPeriod();
+
+  // Updates sensor_rate_policy_ with the sensor fusion state and applies the
+  // sampling period if it changed.
+  void UpdateSensorSamplingPeriod();
+
+  // Saves the gyroscope bias estimate, if it converged, so the next session
+  // can start from it.
+  void SaveGyroscopeBias() const;
+
   std::atomic<bool> is_tracking_;
   // Sensor Fusion object that stores the internal state of the filter.
   std::unique_ptr<SensorFusionEkf> sensor_fusion_;
@@ -80,9 +173,30 @@ class HeadTracker {
   std::shared_ptr<SensorEventProducer<AccelerometerData>> accel_sensor_;
   std::shared_ptr<SensorEventProducer<GyroscopeData>> gyro_sensor_;
 
+  // Decides the sensors sampling rate.
+  SensorRatePolicy sensor_rate_policy_;
+  // Serializes the sensor_rate_policy_ updates from the sensor thread and the
+  // app hints with the sampling period requests, so that the last requested
+  // period is always the one the policy decided last.
+  std::mutex sensor_rate_mutex_;
+
   // Callback functions registered to the input SingleTypeEventProducer.
   std::function<void(AccelerometerData)> on_accel_callback_;
   std::function<void(GyroscopeData)> on_gyro_callback_;
+
+  // Whether the bias provided by the system was already looked up since the
+  // sensors were resumed.
+  std::atomic<bool> is_system_gyroscope_bias_checked_;
+
+  // Display orientation poses are reported for.
+  std::atomic<ViewportOrientation> viewport_orientation_;
+
+  // Latencies of the pipeline stages, see LatencyStage.
+  LatencyHistogram sensor_to_callback_latency_;
+  LatencyHistogram callback_to_fusion_latency_;
+  mutable LatencyHistogram fusion_to_pose_latency_;
+  // Sensor clock time at which the latest sensor fusion ended, zero if none.
+  std::atomic<int64_t> latest_fusion_time_ns_;
 };
 
 }  // namespace cardboard
@@ -17,6 +17,7 @@
 #define CARDBOARD_SDK_INCLUDE_CARDBOARD_H_
 
 #ifdef __ANDROID__
+#include <android/native_window.h>
 #include <jni.h>
 #endif
 
@@ -42,6 +43,117 @@ typedef enum CardboardEye {
   kRight = 1,
 } CardboardEye;
 
+/// Enum to hint the head tracker about the sensor sampling rate the app needs.
+typedef enum CardboardSensorRateHint {
+  /// Sensors run at full rate, and at a reduced rate while the device is
+  /// static.
+  kSensorRateDefault = 0,
+  /// Sensors run at a reduced rate, e.g. while the app shows a menu.
+  kSensorRateLow = 1,
+} CardboardSensorRateHint;
+
+/// Enum to distinguish the head tracker tracking states.
+typedef enum CardboardTrackingState {
+  /// Sensors are fused at the sampling rate.
+  kTrackingFullRate = 0,
+  /// The device has been static for a while. Sensors run at a low rate and
+  /// gyroscope samples are only integrated until motion is detected.
+  kTrackingLowPower = 1,
+} CardboardTrackingState;
+
+/// Enum to distinguish the stages of the head tracking pipeline whose latency
+/// is measured.
+typedef enum CardboardLatencyStage {
+  /// From the gyroscope sample timestamp to the sensor callback.
+  kLatencySensorToCallback = 0,
+  /// From the sensor callback to the end of the sensor fusion of the sample.
+  kLatencyCallbackToFusion = 1,
+  /// From the end of the latest sensor fusion to a pose query.
+  kLatencyFusionToPose = 2,
+} CardboardLatencyStage;
+
+/// Struct to hold the latencies measured for a stage of the head tracking
+/// pipeline. Percentiles are approximated by fixed histogram buckets, with at
+/// most 25% relative error.
+typedef struct CardboardLatencyStats {
+  /// Number of measured latencies.
+  int64_t sample_count;
+  /// Mean latency in nanoseconds.
+  int64_t mean_ns;
+  /// Median latency in nanoseconds.
+  int64_t p50_ns;
+  /// 90th percentile latency in nanoseconds.
+  int64_t p90_ns;
+  /// 99th percentile latency in nanoseconds.
+  int64_t p99_ns;
+  /// Maximum latency in nanoseconds.
+  int64_t max_ns;
+} CardboardLatencyStats;
+
+/// Struct to hold a snapshot of the SDK runtime metrics.
+typedef struct CardboardMetrics {
+  /// Effective accelerometer sampling rate in Hz.
+  float accelerometer_rate_hz;
+  /// Effective gyroscope sampling rate in Hz.
+  float gyroscope_rate_hz;
+  /// Number of accelerometer samples discarded as outdated.
+  int64_t accelerometer_outdated_samples;
+  /// Number of gyroscope samples discarded as outdated.
+  int64_t gyroscope_outdated_samples;
+  /// Number of gyroscope samples received too late after the previous one,
+  /// whose timestep was replaced by the filtered timestep.
+  int64_t gyroscope_timestep_fallbacks;
+  /// Mean sensor fusion time per sample in nanoseconds.
+  int64_t fusion_time_mean_ns;
+  /// 99th percentile sensor fusion time per sample in nanoseconds.
+  int64_t fusion_time_p99_ns;
+  /// Mean CPU time to submit the distortion pass in nanoseconds.
+  int64_t distortion_submit_time_mean_ns;
+  /// 99th percentile CPU time to submit the distortion pass in nanoseconds.
+  int64_t distortion_submit_time_p99_ns;
+} CardboardMetrics;
+
+/// Enum to distinguish the display orientations head poses are reported for.
+typedef enum CardboardViewportOrientation {
+  /// Landscape, with the device rotated counterclockwise from portrait.
+  kLandscapeLeft = 0,
+  /// Landscape, with the device rotated clockwise from portrait.
+  kLandscapeRight = 1,
+  /// Portrait.
+  kPortrait = 2,
+  /// Portrait, upside down.
+  kPortraitUpsideDown = 3,
+} CardboardViewportOrientation;
+
+/// Enum to distinguish how the eye textures are laid out when they are passed
+/// to the distortion renderer.
+typedef enum CardboardEyeTextureLayout {
+  /// Each eye is sampled from the texture of its own description. Eyes are
+  /// rendered one after the other.
+  kEyeTextureLayoutSeparate = 0,
+  /// Both eyes are sampled from the 2D texture of the left eye description,
+  /// e.g. a side-by-side texture. Each eye description still selects its UV
+  /// rectangle. Both eyes are rendered with a single draw call.
+  kEyeTextureLayoutSideBySide = 1,
+  /// Both eyes are sampled from the 2D texture array of the left eye
+  /// description, with the left eye in layer 0 and the right eye in layer 1.
+  /// Each eye description still selects its UV rectangle. Both eyes are
+  /// rendered with a single draw call. Only supported by OpenGL ES 3.0.
+  kEyeTextureLayoutArray = 2,
+} CardboardEyeTextureLayout;
+
+/// Enum to distinguish how OpenGL errors are checked.
+typedef enum CardboardGlValidationLevel {
+  /// Errors are not checked.
+  kGlValidationNone = 0,
+  /// Errors are logged through the KHR_debug extension, without syncing the
+  /// GL pipeline. Errors are not checked when the extension is unavailable.
+  kGlValidationDebugOutput = 1,
+  /// glGetError() is called after each rendering step. This syncs the GL
+  /// pipeline on many drivers.
+  kGlValidationSynchronous = 2,
+} CardboardGlValidationLevel;
+
 /// Struct representing a 3D mesh with 3D vertices and corresponding UV
 /// coordinates.
 typedef struct CardboardMesh {
@@ -71,6 +183,36 @@ typedef struct CardboardEyeTextureDescription {
   float bottom_v;
 } CardboardEyeTextureDescription;
 
+/// Struct describing an image in CPU memory, used by the software distortion
+/// renderer. Pixels have four 8-bit channels, e.g. RGBA. Rows are stored from
+/// bottom to top, like OpenGL textures and glReadPixels() output, so the first
+/// row has v = 0.
+typedef struct CardboardSoftwareImage {
+  /// Pixel buffer, 4 bytes per pixel.
+  uint8_t* pixels;
+  /// Width in pixels.
+  int width;
+  /// Height in pixels.
+  int height;
+  /// Number of bytes between the starts of two consecutive rows.
+  int stride;
+} CardboardSoftwareImage;
+
+/// Struct to hold information about an eye image of the software distortion
+/// renderer.
+typedef struct CardboardSoftwareEyeTextureDescription {
+  /// The image with eye pixels.
+  const CardboardSoftwareImage* image;
+  /// u coordinate of the left side of the eye.
+  float left_u;
+  /// u coordinate of the right side of the eye.
+  float right_u;
+  /// v coordinate of the top side of the eye.
+  float top_v;
+  /// v coordinate of the bottom side of the eye.
+  float bottom_v;
+} CardboardSoftwareEyeTextureDescription;
+
 /// An opaque Lens Distortion object.
 typedef struct CardboardLensDistortion CardboardLensDistortion;
 
@@ -80,6 +222,9 @@ typedef struct CardboardDistortionRenderer CardboardDistortionRenderer;
 /// An opaque Head Tracker object.
 typedef struct CardboardHeadTracker CardboardHeadTracker;
 
+/// An opaque Compositor object.
+typedef struct CardboardCompositor CardboardCompositor;
+
 /// @}
 
 #ifdef __cplusplus
@@ -207,6 +352,34 @@ void CardboardLensDistortion_getFieldOfView(
     CardboardLensDistortion* lens_distortion, CardboardEye eye,
     float* field_of_view);
 
+/// Gets the recommended eye texture size for a particular eye.
+///
+/// The lens magnifies the center of the eye texture and minifies its edges.
+/// The size is derived from the peak texel density the lens needs over the
+/// part of the eye texture that reaches the screen, rather than from the
+/// screen size.
+///
+/// @pre @p lens_distortion Must not be null.
+/// @pre @p width Must not be null.
+/// @pre @p height Must not be null.
+/// @pre @p quality Must be greater than 0 and at most 2.
+/// When it is unmet, a call to this function results in a no-op and a default
+/// value is returned (zero size).
+///
+/// @param[in]      lens_distortion         Lens distortion object pointer.
+/// @param[in]      eye                     Desired eye.
+/// @param[in]      quality                 Texels per screen pixel where the
+///                                         texel density is the highest, in
+///                                         (0, 2]. 1 gives at least one texel
+///                                         per screen pixel over the whole
+///                                         eye, lower values trade sharpness
+///                                         for fill rate.
+/// @param[out]     width                   Eye texture width in pixels.
+/// @param[out]     height                  Eye texture height in pixels.
+void CardboardLensDistortion_getRecommendedEyeTextureSize(
+    CardboardLensDistortion* lens_distortion, CardboardEye eye, float quality,
+    int* width, int* height);
+
 /// Gets the distortion mesh for a particular eye.
 ///
 /// @pre @p lens_distortion Must not be null.
@@ -224,6 +397,37 @@ void CardboardLensDistortion_getDistortionMesh(
     CardboardLensDistortion* lens_distortion, CardboardEye eye,
     CardboardMesh* mesh);
 
+/// Gets the hidden area mesh for a particular eye.
+///
+/// The hidden area mesh covers the eye texture regions that the distortion
+/// mesh never displays, because the lenses map them outside the eye's half of
+/// the screen. Rendering it into the depth or stencil buffer before drawing
+/// the scene into the eye texture lets the GPU skip shading those pixels.
+///
+/// Vertices are in eye texture normalized device coordinates ([-1, 1] range)
+/// and uvs in eye texture [0, 1] coordinates. Unlike the distortion mesh,
+/// indices describe a counterclockwise triangle list. The mesh is empty when
+/// the whole eye texture is displayed, which is the case for viewers with
+/// barrel distortion correction (positive distortion coefficients).
+///
+/// Late rotational reprojection shifts the sampled texture coordinates, so it
+/// may sample texels along the hidden area boundary.
+///
+/// @pre @p lens_distortion Must not be null.
+/// @pre @p mesh Must not be null.
+/// When it is unmet, a call to this function results in a no-op and a default
+/// value is returned (empty values).
+///
+/// Important: The hidden area mesh that is returned by this function becomes
+/// invalid if CardboardLensDistortion is destroyed.
+///
+/// @param[in]      lens_distortion         Lens distortion object pointer.
+/// @param[in]      eye                     Desired eye.
+/// @param[out]     mesh                    Hidden area mesh.
+void CardboardLensDistortion_getHiddenAreaMesh(
+    CardboardLensDistortion* lens_distortion, CardboardEye eye,
+    CardboardMesh* mesh);
+
 /// Applies lens inverse distortion function to a point normalized [0,1] in
 /// pre-distortion (eye texture) space.
 ///
@@ -291,6 +495,68 @@ CardboardDistortionRenderer* CardboardMetalDistortionRenderer_create();
 /// @return         Distortion renderer object pointer
 CardboardDistortionRenderer* CardboardVulkanDistortionRenderer_create();
 
+/// Creates a new distortion renderer object. It renders on the CPU, e.g. for
+/// headless rendering or as a reference for the other renderers, and can be
+/// called from any thread.
+///
+/// Eye images are rendered with
+/// CardboardSoftwareDistortionRenderer_renderEyeToDisplay() into the image set
+/// by CardboardSoftwareDistortionRenderer_setTargetImage().
+/// CardboardDistortionRenderer_renderEyeToDisplay() cannot render with this
+/// renderer, since its eye textures are not images in CPU memory. The output
+/// follows the OpenGL ES renderers: the whole target image is cleared to
+/// opaque black, and pixels are covered by the mesh triangles containing their
+/// center.
+///
+/// @param[in]      thread_count            Number of threads rendering the
+///                                         target image tiles. Values lower
+///                                         than 1 select the number of CPU
+///                                         cores.
+///
+/// @return         Distortion renderer object pointer
+CardboardDistortionRenderer* CardboardSoftwareDistortionRenderer_create(
+    int thread_count);
+
+/// Sets the image the software distortion renderer renders into.
+///
+/// @pre @p renderer Must not be null and must be created by
+///     CardboardSoftwareDistortionRenderer_create().
+/// @pre @p image Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      renderer                Distortion renderer object pointer.
+/// @param[in]      image                   Target image. The struct is copied,
+///                                         and its pixels must stay valid
+///                                         while rendering.
+void CardboardSoftwareDistortionRenderer_setTargetImage(
+    CardboardDistortionRenderer* renderer, const CardboardSoftwareImage* image);
+
+/// Renders eye images to a rectangle in the target image. Eye images are
+/// sampled bilinearly with clamp to edge addressing. In the side by side eye
+/// texture layout, both eyes sample the left eye image.
+///
+/// @pre @p renderer Must not be null and must be created by
+///     CardboardSoftwareDistortionRenderer_create().
+/// @pre @p left_eye Must not be null.
+/// @pre @p right_eye Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      renderer                Distortion renderer object pointer.
+/// @param[in]      x                       x coordinate of the rectangle's
+///                                         lower left corner in pixels.
+/// @param[in]      y                       y coordinate of the rectangle's
+///                                         lower left corner in pixels.
+/// @param[in]      width                   Size in pixels of the rectangle's
+///                                         width.
+/// @param[in]      height                  Size in pixels of the rectangle's
+///                                         height.
+/// @param[in]      left_eye                Left eye image description.
+/// @param[in]      right_eye               Right eye image description.
+void CardboardSoftwareDistortionRenderer_renderEyeToDisplay(
+    CardboardDistortionRenderer* renderer, int x, int y, int width, int height,
+    const CardboardSoftwareEyeTextureDescription* left_eye,
+    const CardboardSoftwareEyeTextureDescription* right_eye);
+
 /// Destroys and releases memory used by the provided distortion renderer
 /// object. Must be called from render thread.
 ///
@@ -314,6 +580,92 @@ void CardboardDistortionRenderer_setMesh(CardboardDistortionRenderer* renderer,
                                          const CardboardMesh* mesh,
                                          CardboardEye eye);
 
+/// Sets how eye textures are laid out in subsequent calls to
+/// CardboardDistortionRenderer_renderEyeToDisplay(). Must be called from
+/// render thread. The default layout is kEyeTextureLayoutSeparate.
+///
+/// @pre @p renderer Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+/// When the layout is not supported by the renderer, a call to this function
+/// results in a no-op.
+///
+/// @param[in]      renderer                Distortion renderer object pointer.
+/// @param[in]      layout                  Eye texture layout.
+void CardboardDistortionRenderer_setEyeTextureLayout(
+    CardboardDistortionRenderer* renderer, CardboardEyeTextureLayout layout);
+
+/// Sets how OpenGL errors are checked by the distortion renderers. The default
+/// level is kGlValidationSynchronous in debug builds of the SDK and
+/// kGlValidationNone in release builds (NDEBUG). kGlValidationDebugOutput
+/// takes effect for OpenGL ES distortion renderers created afterwards: they
+/// enable GL_DEBUG_OUTPUT_KHR on the current context and install a debug
+/// message callback, unless the app already installed one. Other levels never
+/// change the debug output state of the context.
+///
+/// @param[in]      level                   OpenGL validation level.
+void CardboardDistortionRenderer_setGlValidationLevel(
+    CardboardGlValidationLevel level);
+
+/// Gets how OpenGL errors are checked by the distortion renderers, so apps can
+/// apply the same level to their own checks.
+///
+/// @return         OpenGL validation level. When the SDK is not initialized,
+///     kGlValidationNone.
+CardboardGlValidationLevel CardboardDistortionRenderer_getGlValidationLevel();
+
+/// Enables late-latched rotational reprojection in subsequent calls to
+/// CardboardDistortionRenderer_renderEyeToDisplay(). Right before rendering,
+/// the renderer queries the head tracker again for the timestamp passed to
+/// CardboardDistortionRenderer_setRenderPose(). It then rotates the eye
+/// textures by the difference between that pose and the render pose, which
+/// hides head rotation since the eye textures were rendered. Must be called
+/// from render thread.
+///
+/// @pre @p renderer Must not be null.
+/// @pre @p head_tracker Must not be null.
+/// @pre @p lens_distortion Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      renderer                Distortion renderer object pointer.
+/// @param[in]      head_tracker            Head tracker object pointer. It
+///                                         must not be destroyed while
+///                                         reprojection is enabled.
+/// @param[in]      lens_distortion         Lens distortion object pointer
+///                                         that eye textures are rendered
+///                                         with. It is only read by this call.
+void CardboardDistortionRenderer_enableReprojection(
+    CardboardDistortionRenderer* renderer, CardboardHeadTracker* head_tracker,
+    CardboardLensDistortion* lens_distortion);
+
+/// Disables rotational reprojection. Must be called from render thread.
+///
+/// @pre @p renderer Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      renderer                Distortion renderer object pointer.
+void CardboardDistortionRenderer_disableReprojection(
+    CardboardDistortionRenderer* renderer);
+
+/// Sets the head pose that the eye textures were rendered with. It applies to
+/// subsequent calls to CardboardDistortionRenderer_renderEyeToDisplay() until
+/// it is set again, so it should be set for each new pair of eye textures.
+/// Must be called from render thread.
+///
+/// @pre @p renderer Must not be null.
+/// @pre @p orientation Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      renderer                Distortion renderer object pointer.
+/// @param[in]      timestamp_ns            The timestamp passed to
+///                                         CardboardHeadTracker_getPose() to
+///                                         get the render pose.
+/// @param[in]      orientation             4 floats for quaternion of the
+///                                         render pose, as returned by
+///                                         CardboardHeadTracker_getPose().
+void CardboardDistortionRenderer_setRenderPose(
+    CardboardDistortionRenderer* renderer, int64_t timestamp_ns,
+    const float* orientation);
+
 /// Renders eye textures to a rectangle in the display. Must be called from
 /// render thread.
 ///
@@ -341,6 +693,103 @@ void CardboardDistortionRenderer_renderEyeToDisplay(
 
 /// @}
 
+/////////////////////////////////////////////////////////////////////////////
+// Compositor
+/////////////////////////////////////////////////////////////////////////////
+/// @defgroup compositor Compositor
+/// @brief This module runs the distortion pass on a dedicated thread at the
+///     display refresh rate. When the app misses a frame, the latest eye
+///     textures are presented again with rotational reprojection for the new
+///     display time, instead of showing a judder frame. The app owns three
+///     sets of eye textures, indexed 0 to 2, and hands them over to the
+///     compositor one frame at a time.
+/// @{
+
+#ifdef __ANDROID__
+/// Creates a new compositor object and starts its thread. The compositor
+/// thread creates an EGL context sharing objects with the current one, so
+/// this must be called from render thread with the app EGL context current.
+///
+/// @pre @p window Must not be null.
+/// @pre @p head_tracker Must not be null.
+/// @pre @p lens_distortion Must not be null.
+/// When it is unmet, a call to this function results in a no-op and returns
+/// a nullptr.
+///
+/// @param[in]      window                  Window to present to. It must not
+///                                         have another EGL surface, so the
+///                                         app renders eye textures
+///                                         off-screen.
+/// @param[in]      head_tracker            Head tracker object pointer. It
+///                                         must outlive the compositor.
+/// @param[in]      lens_distortion         Lens distortion object pointer
+///                                         that eye textures are rendered
+///                                         with. It is only read by this call.
+/// @param[in]      display_period_ns       Display refresh period in
+///                                         nanoseconds. The compositor is
+///                                         paced by its buffer swaps, which
+///                                         wait for the display vsync. The
+///                                         period only predicts display
+///                                         times for reprojection: one period
+///                                         after a frame is composed.
+///
+/// @return         Compositor object pointer.
+CardboardCompositor* CardboardCompositor_create(
+    ANativeWindow* window, CardboardHeadTracker* head_tracker,
+    CardboardLensDistortion* lens_distortion, int64_t display_period_ns);
+#endif
+
+/// Stops the compositor thread and destroys the compositor object.
+///
+/// @pre @p compositor Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      compositor              Compositor object pointer.
+void CardboardCompositor_destroy(CardboardCompositor* compositor);
+
+/// Acquires a set of eye textures the app may render to. It blocks while the
+/// compositor owns all three sets, which only happens when frames are
+/// acquired without being submitted.
+///
+/// @pre @p compositor Must not be null.
+/// When it is unmet, a call to this function results in a no-op and returns
+/// -1.
+///
+/// @param[in]      compositor              Compositor object pointer.
+///
+/// @return         Index of the eye texture set, from 0 to 2, or -1 if the
+///                 compositor thread failed to start.
+int CardboardCompositor_acquireFrame(CardboardCompositor* compositor);
+
+/// Submits eye textures rendered to an acquired set. Their ownership goes to
+/// the compositor until CardboardCompositor_acquireFrame() returns the same
+/// index again. Must be called from render thread.
+///
+/// @pre @p compositor Must not be null.
+/// @pre @p left_eye Must not be null.
+/// @pre @p right_eye Must not be null.
+/// @pre @p orientation Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      compositor              Compositor object pointer.
+/// @param[in]      frame_index             Index returned by
+///                                         CardboardCompositor_acquireFrame().
+/// @param[in]      left_eye                Left eye texture description.
+/// @param[in]      right_eye               Right eye texture description.
+/// @param[in]      timestamp_ns            The timestamp passed to
+///                                         CardboardHeadTracker_getPose() to
+///                                         get the render pose.
+/// @param[in]      orientation             4 floats for quaternion of the
+///                                         render pose, as returned by
+///                                         CardboardHeadTracker_getPose().
+void CardboardCompositor_submitFrame(
+    CardboardCompositor* compositor, int frame_index,
+    const CardboardEyeTextureDescription* left_eye,
+    const CardboardEyeTextureDescription* right_eye, int64_t timestamp_ns,
+    const float* orientation);
+
+/// @}
+
 /////////////////////////////////////////////////////////////////////////////
 // Head Tracker
 /////////////////////////////////////////////////////////////////////////////
@@ -398,6 +847,183 @@ void CardboardHeadTracker_getPose(CardboardHeadTracker* head_tracker,
                                   int64_t timestamp_ns, float* position,
                                   float* orientation);
 
+/// Gets the predicted head pose for a given timestamp along with the angular
+/// velocity and angular acceleration of the head, e.g. for engine side
+/// extrapolation, reprojection or motion blur.
+///
+/// Both derivatives are expressed around the x, y and z axes of the head
+/// (display) frame, following the right hand rule. The angular velocity is the
+/// bias corrected gyroscope rate and the angular acceleration is low-pass
+/// filtered.
+///
+/// @pre @p head_tracker Must not be null.
+/// @pre @p position Must not be null.
+/// @pre @p orientation Must not be null.
+/// @pre @p angular_velocity Must not be null.
+/// @pre @p angular_acceleration Must not be null.
+/// When it is unmet, a call to this function results in a no-op and default
+/// values are returned (zero values, identity quaternion, zero values and
+/// zero values, respectively).
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @param[in]      timestamp_ns            The timestamp for the pose in
+///     nanoseconds in system monotonic clock.
+/// @param[out]     position                3 floats for (x, y, z).
+/// @param[out]     orientation             4 floats for quaternion
+/// @param[out]     angular_velocity        3 floats for (x, y, z) in radians
+///     per second.
+/// @param[out]     angular_acceleration    3 floats for (x, y, z) in radians
+///     per second squared.
+void CardboardHeadTracker_getPoseWithDerivatives(
+    CardboardHeadTracker* head_tracker, int64_t timestamp_ns, float* position,
+    float* orientation, float* angular_velocity, float* angular_acceleration);
+
+/// Gets the predicted head poses for several timestamps, e.g. one per eye or
+/// per rendered layer. All poses are computed from the same head tracker
+/// state, which is cheaper than calling CardboardHeadTracker_getPose() for
+/// each timestamp and keeps the poses consistent with each other.
+///
+/// @pre @p head_tracker Must not be null.
+/// @pre @p timestamps_ns Must not be null.
+/// @pre @p positions Must not be null.
+/// @pre @p orientations Must not be null.
+/// @pre @p count Must be positive.
+/// When it is unmet, a call to this function results in a no-op and default
+/// values are returned (zero values and identity quaternions, respectively)
+/// for each of the @p count poses when the output arrays are not null.
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @param[in]      timestamps_ns           @p count timestamps for the poses
+///     in nanoseconds in system monotonic clock.
+/// @param[in]      count                   Number of poses.
+/// @param[out]     positions               3 * @p count floats for (x, y, z)
+///     of each pose.
+/// @param[out]     orientations            4 * @p count floats for the
+///     quaternion of each pose.
+void CardboardHeadTracker_getPoses(CardboardHeadTracker* head_tracker,
+                                   const int64_t* timestamps_ns, int count,
+                                   float* positions, float* orientations);
+
+/// Sets the display orientation the head tracker reports poses for. Poses are
+/// reported for kLandscapeLeft until this function is called.
+///
+/// @pre @p head_tracker Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @param[in]      viewport_orientation    Display orientation.
+void CardboardHeadTracker_setViewportOrientation(
+    CardboardHeadTracker* head_tracker,
+    CardboardViewportOrientation viewport_orientation);
+
+/// Hints the head tracker about the sensor sampling rate the app needs.
+/// With kSensorRateDefault, sensors are sampled at full rate while the device
+/// moves and at a reduced rate while it is static. With kSensorRateLow, they
+/// are sampled at the reduced rate even while the device moves. With either
+/// hint, they are sampled at an even lower rate in low power tracking, see
+/// CardboardHeadTracker_getTrackingState.
+///
+/// @pre @p head_tracker Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @param[in]      hint                    Sampling rate hint.
+void CardboardHeadTracker_setSensorRateHint(CardboardHeadTracker* head_tracker,
+                                            CardboardSensorRateHint hint);
+
+/// Sets the minimum rate at which accelerometer measurements correct the head
+/// pose. Accelerometer samples received between two corrections are averaged,
+/// which saves most of the sensor fusion CPU time at the cost of a slower and
+/// less accurate gravity alignment while the head rotates. The rate rises
+/// while the measured gravity deviates from the estimated one, e.g. after the
+/// gyroscope drifted. Gyroscope samples are always integrated at full rate. By
+/// default, every accelerometer sample corrects the pose.
+///
+/// @pre @p head_tracker Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @param[in]      rate_hz                 Minimum correction rate in Hz. Zero
+///                                         or a negative value corrects with
+///                                         every accelerometer sample.
+void CardboardHeadTracker_setAccelerometerCorrectionRate(
+    CardboardHeadTracker* head_tracker, float rate_hz);
+
+/// Gets the rate at which the gyroscope is currently sampled.
+///
+/// @pre @p head_tracker Must not be null.
+/// When it is unmet, a call to this function results in a no-op and a default
+/// value is returned (zero).
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @return         Gyroscope sampling rate in Hz, or zero if the head tracker
+///     is paused.
+float CardboardHeadTracker_getSensorSamplingRate(
+    CardboardHeadTracker* head_tracker);
+
+/// Gets the current tracking state. The head tracker enters low power tracking
+/// once the device has been static for a while, and resumes full rate tracking
+/// with the first sensor sample that shows motion.
+///
+/// @pre @p head_tracker Must not be null.
+/// When it is unmet, a call to this function results in a no-op and a default
+/// value is returned (kTrackingFullRate).
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @return         Current tracking state.
+CardboardTrackingState CardboardHeadTracker_getTrackingState(
+    CardboardHeadTracker* head_tracker);
+
+/// Gets the latencies measured for a stage of the head tracking pipeline since
+/// the head tracker creation or the last call to
+/// CardboardHeadTracker_resetLatencyStats. Latencies are always measured, at a
+/// cost of a few tens of nanoseconds per sensor sample and pose query.
+///
+/// @pre @p head_tracker Must not be null.
+/// @pre @p out_stats Must not be null.
+/// When it is unmet, a call to this function results in a no-op and default
+/// values are returned (all zero).
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @param[in]      stage                   Pipeline stage.
+/// @param[out]     out_stats               Latency statistics of the stage.
+void CardboardHeadTracker_getLatencyStats(CardboardHeadTracker* head_tracker,
+                                          CardboardLatencyStage stage,
+                                          CardboardLatencyStats* out_stats);
+
+/// Clears the latencies measured for all stages of the head tracking pipeline.
+///
+/// @pre @p head_tracker Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+void CardboardHeadTracker_resetLatencyStats(CardboardHeadTracker* head_tracker);
+
+/// @}
+
+/////////////////////////////////////////////////////////////////////////////
+// Metrics
+/////////////////////////////////////////////////////////////////////////////
+/// @defgroup metrics Metrics
+/// @brief This module reports runtime metrics of the sensor and rendering
+///     pipelines, e.g. for fleet telemetry. Metrics are process wide and
+///     always maintained.
+/// @{
+
+/// Gets a snapshot of the metrics accumulated since the SDK initialization or
+/// the last call to CardboardMetrics_reset. Sampling rates are moving averages
+/// over the latest samples, and zero until samples are received.
+///
+/// @pre @p out_metrics Must not be null.
+/// When it is unmet, a call to this function results in a no-op and default
+/// values are returned (all zero).
+///
+/// @param[out]     out_metrics             Metrics snapshot.
+void CardboardMetrics_getSnapshot(CardboardMetrics* out_metrics);
+
+/// Clears all metrics.
+void CardboardMetrics_reset();
+
 /// @}
 
 /////////////////////////////////////////////////////////////////////////////
@@ -15,16 +15,25 @@
  */
 #include "lens_distortion.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 
 #include "include/cardboard.h"
 #include "screen_params.h"
+#include "util/trace.h"
 
 namespace cardboard {
 
 constexpr float kDefaultBorderSizeMeters = 0.003f;
 
+// Number of eye texture samples per axis searched for the peak inverse
+// distortion derivative.
+constexpr int kTextureDensitySamples = 32;
+
+// Tan-angle step of the distortion finite differences.
+constexpr float kDerivativeStep = 1e-3f;
+
 // All values in tanangle units.
 struct LensDistortion::ViewportParams {
   float width;
@@ -34,7 +43,8 @@ struct LensDistortion::ViewportParams {
 };
 
 LensDistortion::LensDistortion(const uint8_t* encoded_device_params, int size,
-                               int display_width, int display_height) {
+                               int display_width, int display_height)
+    : display_width_(display_width), display_height_(display_height) {
   device_params_.ParseFromArray(encoded_device_params, size);
 
   eye_from_head_matrix_[kLeft] = cardboard::Matrix4x4::Translation(
@@ -80,6 +90,7 @@ CardboardMesh LensDistortion::GetDistortionMesh(CardboardEye eye) const {
 }
 
 void LensDistortion::UpdateParams() {
+  CARDBOARD_TRACE_SCOPE("LensDistortion::UpdateParams");
   fov_[kLeft] = CalculateFov(device_params_, *distortion_, screen_width_meters_,
                              screen_height_meters_);
   // Mirror fov for right eye.
@@ -152,6 +163,89 @@ std::array<float, 2> LensDistortion::UndistortedUvForDistortedUv(
               screen_params.height};
 }
 
+CardboardMesh LensDistortion::GetHiddenAreaMesh(CardboardEye eye) const {
+  return eye == kLeft ? left_mesh_->GetHiddenAreaMesh()
+                      : right_mesh_->GetHiddenAreaMesh();
+}
+
+void LensDistortion::GetRecommendedEyeTextureSize(CardboardEye eye,
+                                                  float quality, int* width,
+                                                  int* height) const {
+  if (screen_width_meters_ == 0 || screen_height_meters_ == 0) {
+    *width = display_width_ / 2;
+    *height = display_height_;
+    return;
+  }
+
+  ViewportParams screen_params, texture_params;
+  CalculateViewportParameters(eye, device_params_, fov_[eye],
+                              screen_width_meters_, screen_height_meters_,
+                              &screen_params, &texture_params);
+
+  // The inverse distortion derivative is the inverse of the distortion
+  // Jacobian at the screen point, which is cheaper and more accurate to
+  // evaluate than differences of the iterative inverse. Its columns are the
+  // screen displacements of texture steps along x and y.
+  float peak_x = 0;
+  float peak_y = 0;
+  for (int row = 0; row < kTextureDensitySamples; ++row) {
+    for (int col = 0; col < kTextureDensitySamples; ++col) {
+      const std::array<float, 2> p_texture = {
+          (col + 0.5f) / kTextureDensitySamples * texture_params.width -
+              texture_params.x_eye_offset,
+          (row + 0.5f) / kTextureDensitySamples * texture_params.height -
+              texture_params.y_eye_offset};
+      const std::array<float, 2> p_screen =
+          distortion_->DistortInverse(p_texture);
+
+      // Texture areas shown outside the eye half of the screen do not need
+      // any density.
+      const float u_screen =
+          (p_screen[0] + screen_params.x_eye_offset) / screen_params.width;
+      const float v_screen =
+          (p_screen[1] + screen_params.y_eye_offset) / screen_params.height;
+      const float min_u = eye == kLeft ? 0.0f : 0.5f;
+      if (u_screen < min_u || u_screen > min_u + 0.5f || v_screen < 0.0f ||
+          v_screen > 1.0f) {
+        continue;
+      }
+
+      const std::array<float, 2> right = distortion_->Distort(
+          {p_screen[0] + kDerivativeStep, p_screen[1]});
+      const std::array<float, 2> left = distortion_->Distort(
+          {p_screen[0] - kDerivativeStep, p_screen[1]});
+      const std::array<float, 2> up = distortion_->Distort(
+          {p_screen[0], p_screen[1] + kDerivativeStep});
+      const std::array<float, 2> down = distortion_->Distort(
+          {p_screen[0], p_screen[1] - kDerivativeStep});
+      const float j00 = (right[0] - left[0]) / (2 * kDerivativeStep);
+      const float j10 = (right[1] - left[1]) / (2 * kDerivativeStep);
+      const float j01 = (up[0] - down[0]) / (2 * kDerivativeStep);
+      const float j11 = (up[1] - down[1]) / (2 * kDerivativeStep);
+      const float det = j00 * j11 - j01 * j10;
+      if (det <= 0) {
+        continue;
+      }
+      peak_x = std::max(peak_x, std::hypot(j11, j10) / det);
+      peak_y = std::max(peak_y, std::hypot(j01, j00) / det);
+    }
+  }
+  if (peak_x == 0 || peak_y == 0) {
+    *width = display_width_ / 2;
+    *height = display_height_;
+    return;
+  }
+
+  const float pixels_per_tan_x = display_width_ / screen_params.width;
+  const float pixels_per_tan_y = display_height_ / screen_params.height;
+  *width = std::max(1, static_cast<int>(std::ceil(
+                           quality * peak_x * texture_params.width *
+                           pixels_per_tan_x)));
+  *height = std::max(1, static_cast<int>(std::ceil(
+                            quality * peak_y * texture_params.height *
+                            pixels_per_tan_y)));
+}
+
 std::array<float, 4> LensDistortion::CalculateFov(
     const DeviceParams& device_params,
     const PolynomialRadialDistortion& distortion, float screen_width_meters,
@@ -215,11 +309,14 @@ DistortionMesh* LensDistortion::CreateDistortionMesh(
                               screen_height_meters, &screen_params,
                               &texture_params);
 
-  return new DistortionMesh(distortion, screen_params.width,
-                            screen_params.height, screen_params.x_eye_offset,
-                            screen_params.y_eye_offset, texture_params.width,
-                            texture_params.height, texture_params.x_eye_offset,
-                            texture_params.y_eye_offset);
+  // Each eye is displayed on its half of the screen.
+  const float visible_min_u_screen = eye == kLeft ? 0.0f : 0.5f;
+  return new DistortionMesh(
+      distortion, screen_params.width, screen_params.height,
+      screen_params.x_eye_offset, screen_params.y_eye_offset,
+      texture_params.width, texture_params.height,
+      texture_params.x_eye_offset, texture_params.y_eye_offset,
+      visible_min_u_screen, visible_min_u_screen + 0.5f);
 }
 
 void LensDistortion::CalculateViewportParameters(
@@ -50,6 +50,14 @@ class LensDistortion {
                               float* projection_matrix) const;
   void GetEyeFieldOfView(CardboardEye eye, float* field_of_view) const;
   CardboardMesh GetDistortionMesh(CardboardEye eye) const;
+  CardboardMesh GetHiddenAreaMesh(CardboardEye eye) const;
+  // Computes the eye texture size giving quality texels per screen pixel where
+  // the lens needs the highest texel density. It is the peak derivative of the
+  // inverse distortion over the visible part of the eye texture, in screen
+  // pixels per texture tan-angle unit. quality must be in (0, 2], which the C
+  // API validates.
+  void GetRecommendedEyeTextureSize(CardboardEye eye, float quality,
+                                    int* width, int* height) const;
  private:
   struct ViewportParams;
 
@@ -76,6 +84,8 @@ class LensDistortion {
 
   DeviceParams device_params_;
 
+  int display_width_;
+  int display_height_;
   float screen_width_meters_;
   float screen_height_meters_;
   std::array<std::array<float, 4>, 2> fov_;  // L, R, B, T
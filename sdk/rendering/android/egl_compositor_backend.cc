@@ -0,0 +1,198 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "rendering/android/egl_compositor_backend.h"
+
+#include <GLES2/gl2.h>
+
+#include <cstring>
+
+#include "include/cardboard.h"
+#include "util/logging.h"
+
+namespace cardboard {
+namespace rendering {
+
+EglCompositorBackend::EglCompositorBackend(
+    ANativeWindow* window, const HeadTracker* head_tracker,
+    const LensDistortion* lens_distortion)
+    : window_(window),
+      head_tracker_(head_tracker),
+      display_(eglGetCurrentDisplay()),
+      config_(nullptr),
+      share_context_(eglGetCurrentContext()),
+      client_version_(2),
+      context_(EGL_NO_CONTEXT),
+      surface_(EGL_NO_SURFACE),
+      create_sync_(nullptr),
+      client_wait_sync_(nullptr),
+      destroy_sync_(nullptr) {
+  ANativeWindow_acquire(window_);
+
+  for (CardboardEye eye : {kLeft, kRight}) {
+    const CardboardMesh mesh = lens_distortion->GetDistortionMesh(eye);
+    meshes_[eye].indices.assign(mesh.indices, mesh.indices + mesh.n_indices);
+    meshes_[eye].vertices.assign(mesh.vertices,
+                                 mesh.vertices + mesh.n_vertices * 2);
+    meshes_[eye].uvs.assign(mesh.uvs, mesh.uvs + mesh.n_vertices * 2);
+    lens_distortion->GetEyeFieldOfView(eye, fovs_[eye].data());
+  }
+
+  if (display_ == EGL_NO_DISPLAY || share_context_ == EGL_NO_CONTEXT) {
+    return;
+  }
+  // The compositor context uses the same config and client version as the
+  // app context, which sharing objects requires.
+  EGLint config_id = 0;
+  eglQueryContext(display_, share_context_, EGL_CONFIG_ID, &config_id);
+  eglQueryContext(display_, share_context_, EGL_CONTEXT_CLIENT_VERSION,
+                  &client_version_);
+  const EGLint config_attributes[] = {EGL_CONFIG_ID, config_id, EGL_NONE};
+  EGLint config_count = 0;
+  if (!eglChooseConfig(display_, config_attributes, &config_, 1,
+                       &config_count) ||
+      config_count == 0) {
+    config_ = nullptr;
+  }
+
+  const char* extensions = eglQueryString(display_, EGL_EXTENSIONS);
+  if (extensions != nullptr && strstr(extensions, "EGL_KHR_fence_sync")) {
+    create_sync_ = reinterpret_cast<PFNEGLCREATESYNCKHRPROC>(
+        eglGetProcAddress("eglCreateSyncKHR"));
+    client_wait_sync_ = reinterpret_cast<PFNEGLCLIENTWAITSYNCKHRPROC>(
+        eglGetProcAddress("eglClientWaitSyncKHR"));
+    destroy_sync_ = reinterpret_cast<PFNEGLDESTROYSYNCKHRPROC>(
+        eglGetProcAddress("eglDestroySyncKHR"));
+    if (create_sync_ == nullptr || client_wait_sync_ == nullptr ||
+        destroy_sync_ == nullptr) {
+      create_sync_ = nullptr;
+    }
+  }
+}
+
+EglCompositorBackend::~EglCompositorBackend() {
+  ANativeWindow_release(window_);
+}
+
+bool EglCompositorBackend::Initialize() {
+  if (config_ == nullptr) {
+    CARDBOARD_LOGE("Compositor requires a current EGL context at creation.");
+    return false;
+  }
+  const EGLint context_attributes[] = {EGL_CONTEXT_CLIENT_VERSION,
+                                       client_version_, EGL_NONE};
+  context_ =
+      eglCreateContext(display_, config_, share_context_, context_attributes);
+  if (context_ == EGL_NO_CONTEXT) {
+    CARDBOARD_LOGE("Failed to create compositor EGL context: 0x%x",
+                   eglGetError());
+    return false;
+  }
+  surface_ = eglCreateWindowSurface(display_, config_, window_, nullptr);
+  if (surface_ == EGL_NO_SURFACE ||
+      !eglMakeCurrent(display_, surface_, surface_, context_)) {
+    CARDBOARD_LOGE("Failed to create compositor EGL surface: 0x%x",
+                   eglGetError());
+    Shutdown();
+    return false;
+  }
+  // Swaps wait for the vsync, which paces the compositor thread, see
+  // SwapPacedDisplayClock.
+  eglSwapInterval(display_, 1);
+
+  renderer_.reset(reinterpret_cast<DistortionRenderer*>(
+      client_version_ >= 3 ? CardboardOpenGlEs3DistortionRenderer_create()
+                           : CardboardOpenGlEs2DistortionRenderer_create()));
+  if (!renderer_) {
+    Shutdown();
+    return false;
+  }
+  for (CardboardEye eye : {kLeft, kRight}) {
+    MeshData& data = meshes_[eye];
+    CardboardMesh mesh{data.indices.data(),
+                       static_cast<int>(data.indices.size()),
+                       data.vertices.data(), data.uvs.data(),
+                       static_cast<int>(data.vertices.size() / 2)};
+    renderer_->SetMesh(&mesh, eye);
+  }
+  renderer_->GetReprojection().Enable(head_tracker_, fovs_[kLeft],
+                                      fovs_[kRight]);
+  return true;
+}
+
+void* EglCompositorBackend::CreateFence() {
+  EGLSyncKHR fence = EGL_NO_SYNC_KHR;
+  if (create_sync_ != nullptr) {
+    fence = create_sync_(display_, EGL_SYNC_FENCE_KHR, nullptr);
+  }
+  if (fence == EGL_NO_SYNC_KHR) {
+    // Without a fence, the eye textures must be complete before the
+    // compositor context samples them.
+    glFinish();
+    return nullptr;
+  }
+  // The fence only signals once the app commands reach the GPU.
+  glFlush();
+  return fence;
+}
+
+void EglCompositorBackend::WaitFence(void* fence) {
+  if (fence == nullptr) {
+    return;
+  }
+  client_wait_sync_(display_, fence, EGL_SYNC_FLUSH_COMMANDS_BIT_KHR,
+                    EGL_FOREVER_KHR);
+  destroy_sync_(display_, fence);
+}
+
+void EglCompositorBackend::DestroyFence(void* fence) {
+  if (fence != nullptr) {
+    destroy_sync_(display_, fence);
+  }
+}
+
+void EglCompositorBackend::Present(const CompositorFrame& frame,
+                                   int64_t display_timestamp_ns) {
+  EGLint width = 0;
+  EGLint height = 0;
+  eglQuerySurface(display_, surface_, EGL_WIDTH, &width);
+  eglQuerySurface(display_, surface_, EGL_HEIGHT, &height);
+
+  RotationalReprojection& reprojection = renderer_->GetReprojection();
+  reprojection.SetRenderPose(frame.render_timestamp_ns,
+                             frame.render_orientation);
+  reprojection.SetDisplayTimestamp(display_timestamp_ns);
+  renderer_->RenderEyeToDisplay(/*target_display=*/0, /*x=*/0, /*y=*/0, width,
+                                height, &frame.left_eye, &frame.right_eye);
+  if (!eglSwapBuffers(display_, surface_)) {
+    CARDBOARD_LOGE("Compositor eglSwapBuffers failed: 0x%x", eglGetError());
+  }
+}
+
+void EglCompositorBackend::Shutdown() {
+  renderer_.reset();
+  eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  if (surface_ != EGL_NO_SURFACE) {
+    eglDestroySurface(display_, surface_);
+    surface_ = EGL_NO_SURFACE;
+  }
+  if (context_ != EGL_NO_CONTEXT) {
+    eglDestroyContext(display_, context_);
+    context_ = EGL_NO_CONTEXT;
+  }
+}
+
+}  // namespace rendering
+}  // namespace cardboard
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_RENDERING_ANDROID_EGL_COMPOSITOR_BACKEND_H_
+#define CARDBOARD_SDK_RENDERING_ANDROID_EGL_COMPOSITOR_BACKEND_H_
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <android/native_window.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "distortion_renderer.h"
+#include "head_tracker.h"
+#include "lens_distortion.h"
+#include "rendering/compositor.h"
+
+namespace cardboard {
+namespace rendering {
+
+// Compositor backend presenting to an Android window through EGL. Its context
+// shares objects with the app context, so eye textures are sampled directly.
+class EglCompositorBackend : public CompositorBackend {
+ public:
+  // Must be called on the app render thread, with the app EGL context
+  // current.
+  //
+  // @param window window to present to. It must not have another EGL surface,
+  //     so the app renders its eye textures off-screen.
+  // @param head_tracker head tracker used for reprojection. It must outlive
+  //     the backend.
+  // @param lens_distortion lens distortion the eye textures are rendered
+  //     with. It is only read by the constructor.
+  EglCompositorBackend(ANativeWindow* window, const HeadTracker* head_tracker,
+                       const LensDistortion* lens_distortion);
+  ~EglCompositorBackend() override;
+
+  bool Initialize() override;
+  void* CreateFence() override;
+  void WaitFence(void* fence) override;
+  void DestroyFence(void* fence) override;
+  void Present(const CompositorFrame& frame,
+               int64_t display_timestamp_ns) override;
+  void Shutdown() override;
+
+ private:
+  // Copy of a distortion mesh, which must outlive the lens distortion.
+  struct MeshData {
+    std::vector<int> indices;
+    std::vector<float> vertices;
+    std::vector<float> uvs;
+  };
+
+  ANativeWindow* window_;
+  const HeadTracker* head_tracker_;
+  std::array<MeshData, 2> meshes_;
+  std::array<std::array<float, 4>, 2> fovs_;
+
+  EGLDisplay display_;
+  EGLConfig config_;
+  EGLContext share_context_;
+  EGLint client_version_;
+  EGLContext context_;
+  EGLSurface surface_;
+  std::unique_ptr<DistortionRenderer> renderer_;
+
+  // EGL_KHR_fence_sync entry points, null when it is not supported.
+  PFNEGLCREATESYNCKHRPROC create_sync_;
+  PFNEGLCLIENTWAITSYNCKHRPROC client_wait_sync_;
+  PFNEGLDESTROYSYNCKHRPROC destroy_sync_;
+};
+
+}  // namespace rendering
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_RENDERING_ANDROID_EGL_COMPOSITOR_BACKEND_H_
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "rendering/compositor.h"
+
+#include <chrono>
+
+namespace cardboard {
+namespace rendering {
+
+namespace {
+
+int64_t GetMonotonicTimeNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+SwapPacedDisplayClock::SwapPacedDisplayClock(int64_t period_ns)
+    : period_ns_(period_ns) {}
+
+int64_t SwapPacedDisplayClock::WaitForNextFrame() {
+  // The previous Present() returned when the display released a buffer, right
+  // after a vsync. The frame composed now is scanned out on the next one.
+  return GetMonotonicTimeNs() + period_ns_;
+}
+
+Compositor::Compositor(std::unique_ptr<CompositorBackend> backend,
+                       std::unique_ptr<DisplayClock> display_clock)
+    : backend_(std::move(backend)),
+      display_clock_(std::move(display_clock)),
+      is_running_(true),
+      submitted_index_(-1),
+      displayed_index_(-1),
+      stats_{0, 0, 0} {
+  frame_states_.fill(FrameState::kFree);
+  thread_ = std::thread(&Compositor::Run, this);
+}
+
+Compositor::~Compositor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_running_ = false;
+  }
+  frame_released_.notify_all();
+  frame_submitted_.notify_all();
+  display_clock_->Interrupt();
+  thread_.join();
+  // A submitted frame that never got displayed still holds its fence.
+  if (submitted_index_ != -1) {
+    backend_->DestroyFence(frames_[submitted_index_].fence);
+  }
+}
+
+int Compositor::AcquireFrame() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    if (!is_running_) {
+      return -1;
+    }
+    for (int i = 0; i < kFrameCount; ++i) {
+      if (frame_states_[i] == FrameState::kFree) {
+        frame_states_[i] = FrameState::kAcquired;
+        return i;
+      }
+    }
+    frame_released_.wait(lock);
+  }
+}
+
+void Compositor::SubmitFrame(int index, const CompositorFrame& frame) {
+  if (index < 0 || index >= kFrameCount) {
+    return;
+  }
+  CompositorFrame submitted_frame = frame;
+  submitted_frame.fence = backend_->CreateFence();
+
+  void* dropped_fence = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (frame_states_[index] != FrameState::kAcquired) {
+      dropped_fence = submitted_frame.fence;
+    } else {
+      if (submitted_index_ != -1) {
+        // The previous frame was never displayed, it is superseded.
+        dropped_fence = frames_[submitted_index_].fence;
+        ReleaseFrame(submitted_index_);
+        ++stats_.dropped_frames;
+      }
+      frames_[index] = submitted_frame;
+      frame_states_[index] = FrameState::kSubmitted;
+      submitted_index_ = index;
+      frame_submitted_.notify_one();
+    }
+  }
+  if (dropped_fence != nullptr) {
+    backend_->DestroyFence(dropped_fence);
+  }
+}
+
+Compositor::Stats Compositor::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void Compositor::Run() {
+  if (!backend_->Initialize()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_running_ = false;
+    }
+    frame_released_.notify_all();
+    return;
+  }
+
+  {
+    // Nothing paces the thread until it presents, so it sleeps until the
+    // first frame is submitted.
+    std::unique_lock<std::mutex> lock(mutex_);
+    frame_submitted_.wait(
+        lock, [this]() { return !is_running_ || submitted_index_ != -1; });
+  }
+
+  for (;;) {
+    const int64_t display_timestamp_ns = display_clock_->WaitForNextFrame();
+
+    int index;
+    bool is_new_frame;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!is_running_) {
+        break;
+      }
+      is_new_frame = submitted_index_ != -1;
+      if (is_new_frame) {
+        if (displayed_index_ != -1) {
+          ReleaseFrame(displayed_index_);
+        }
+        displayed_index_ = submitted_index_;
+        frame_states_[displayed_index_] = FrameState::kDisplayed;
+        submitted_index_ = -1;
+      }
+      index = displayed_index_;
+    }
+
+    // The displayed frame is owned by this thread, so it is read without
+    // holding the mutex.
+    CompositorFrame& frame = frames_[index];
+    if (is_new_frame) {
+      backend_->WaitFence(frame.fence);
+      frame.fence = nullptr;
+    }
+    backend_->Present(frame, display_timestamp_ns);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.presented_frames;
+    if (!is_new_frame) {
+      ++stats_.repeated_frames;
+    }
+  }
+
+  backend_->Shutdown();
+}
+
+void Compositor::ReleaseFrame(int index) {
+  frame_states_[index] = FrameState::kFree;
+  frame_released_.notify_one();
+}
+
+}  // namespace rendering
+}  // namespace cardboard
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_RENDERING_COMPOSITOR_H_
+#define CARDBOARD_SDK_RENDERING_COMPOSITOR_H_
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "include/cardboard.h"
+
+namespace cardboard {
+namespace rendering {
+
+// Eye buffers submitted to the compositor, along with the head pose they were
+// rendered with.
+struct CompositorFrame {
+  CardboardEyeTextureDescription left_eye;
+  CardboardEyeTextureDescription right_eye;
+  int64_t render_timestamp_ns;
+  std::array<float, 4> render_orientation;
+  // Backend fence signaled when the app finished rendering the eye buffers.
+  void* fence;
+};
+
+// Paces the compositor thread and predicts when its frames are displayed.
+class DisplayClock {
+ public:
+  virtual ~DisplayClock() = default;
+
+  // Returns when the next frame has to be composed. It returns right away
+  // when the backend Present() already blocks on the display.
+  //
+  // @return predicted display timestamp of that frame, in nanoseconds.
+  virtual int64_t WaitForNextFrame() = 0;
+
+  // Makes a blocked WaitForNextFrame() call return. It is called when the
+  // compositor stops, from another thread.
+  virtual void Interrupt() {}
+};
+
+// Display clock of backends presenting with a swap interval of one.
+//
+// Presenting blocks until the display releases a buffer, which paces the
+// compositor thread at the refresh rate and in phase with the vsync, so this
+// clock never waits. It predicts that a frame is displayed one refresh period
+// after it is composed. It is not corrected with presentation feedback, so
+// frames the window queues ahead of the display are shown later than
+// predicted.
+class SwapPacedDisplayClock : public DisplayClock {
+ public:
+  // @param period_ns display refresh period in nanoseconds.
+  explicit SwapPacedDisplayClock(int64_t period_ns);
+
+  int64_t WaitForNextFrame() override;
+
+ private:
+  const int64_t period_ns_;
+};
+
+// Graphics API specific part of the compositor.
+class CompositorBackend {
+ public:
+  virtual ~CompositorBackend() = default;
+
+  // Called on the compositor thread before composing the first frame.
+  //
+  // @return false if the backend cannot present, which stops the thread.
+  virtual bool Initialize() = 0;
+
+  // Called on the app render thread when it submits a frame.
+  //
+  // @return fence signaled when the app commands issued so far complete, or
+  //     nullptr if the backend does not need one.
+  virtual void* CreateFence() = 0;
+
+  // Makes the compositor wait on a fence created by CreateFence() and
+  // destroys it.
+  virtual void WaitFence(void* fence) = 0;
+
+  // Destroys a fence created by CreateFence() without waiting on it.
+  virtual void DestroyFence(void* fence) = 0;
+
+  // Distorts a frame to the display.
+  //
+  // @param frame eye buffers to present.
+  // @param display_timestamp_ns predicted display timestamp, used to
+  //     reproject the eye buffers.
+  virtual void Present(const CompositorFrame& frame,
+                       int64_t display_timestamp_ns) = 0;
+
+  // Called on the compositor thread before it exits.
+  virtual void Shutdown() = 0;
+};
+
+// Asynchronous reprojection compositor.
+//
+// A dedicated thread presents a frame at every display clock tick, from the
+// first submitted frame on. When the app submitted a new frame since the
+// previous tick, the compositor switches to it. Otherwise, it presents the
+// previous frame again. In both cases the frame is reprojected for the tick
+// display timestamp, so a missed frame is not seen as a judder frame.
+//
+// The app owns kFrameCount sets of eye buffers. Ownership of each set is
+// handed over as follows:
+// - AcquireFrame() returns a set the app may render to.
+// - SubmitFrame() hands it to the compositor.
+// - The set returns to the app once the compositor no longer needs it: either
+//   a newer frame is displayed instead, or a newer frame is submitted before
+//   it got displayed.
+class Compositor {
+ public:
+  // Number of eye buffer sets: one displayed, one submitted, and one rendered.
+  static constexpr int kFrameCount = 3;
+
+  // Frame counters, for diagnostics.
+  struct Stats {
+    // Number of frames presented, including repeated ones.
+    int64_t presented_frames;
+    // Number of times a frame was presented again because no newer frame was
+    // submitted.
+    int64_t repeated_frames;
+    // Number of submitted frames that were never displayed.
+    int64_t dropped_frames;
+  };
+
+  // Starts the compositor thread.
+  //
+  // @param backend graphics API backend.
+  // @param display_clock clock pacing the compositor thread.
+  Compositor(std::unique_ptr<CompositorBackend> backend,
+             std::unique_ptr<DisplayClock> display_clock);
+
+  // Stops the compositor thread and waits for it to exit.
+  ~Compositor();
+
+  // Acquires an eye buffer set to render to. It blocks while the compositor
+  // owns all of them.
+  //
+  // @return index of the eye buffer set, or -1 if the compositor stopped.
+  int AcquireFrame();
+
+  // Submits an acquired eye buffer set. It must be called on the app render
+  // thread.
+  //
+  // @param index index returned by AcquireFrame().
+  // @param frame eye buffers and render pose. Its fence is ignored.
+  void SubmitFrame(int index, const CompositorFrame& frame);
+
+  // Returns the frame counters.
+  Stats GetStats() const;
+
+ private:
+  enum class FrameState { kFree, kAcquired, kSubmitted, kDisplayed };
+
+  void Run();
+  // Marks a frame free and wakes up AcquireFrame(). The mutex must be held.
+  void ReleaseFrame(int index);
+
+  const std::unique_ptr<CompositorBackend> backend_;
+  const std::unique_ptr<DisplayClock> display_clock_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable frame_released_;
+  std::condition_variable frame_submitted_;
+  bool is_running_;
+  std::array<FrameState, kFrameCount> frame_states_;
+  std::array<CompositorFrame, kFrameCount> frames_;
+  int submitted_index_;
+  int displayed_index_;
+  Stats stats_;
+
+  std::thread thread_;
+};
+
+}  // namespace rendering
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_RENDERING_COMPOSITOR_H_
@@ -0,0 +1,238 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "rendering/distortion_mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace cardboard {
+namespace rendering {
+
+namespace {
+
+// Vertex scoring parameters recommended by Forsyth. kCacheSize is the
+// simulated cache size, not the hardware one: the ordering works well for
+// any cache at least this large, and degrades gracefully below it.
+constexpr int kCacheSize = 32;
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kLastTriangleScore = 0.75f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+
+// Returns the score of a vertex, given its position in the simulated LRU
+// cache (-1 when it is not cached) and the number of triangles that still use
+// it. Vertices of the last triangle get a fixed score, so that the next
+// triangle is not biased toward reusing a particular edge of it.
+float VertexScore(int cache_position, int remaining_triangles) {
+  if (remaining_triangles == 0) {
+    return -1.0f;
+  }
+  float score = 0.0f;
+  if (cache_position >= 0) {
+    if (cache_position < 3) {
+      score = kLastTriangleScore;
+    } else {
+      score = std::pow(1.0f - static_cast<float>(cache_position - 3) /
+                                  (kCacheSize - 3),
+                       kCacheDecayPower);
+    }
+  }
+  // Vertices with few remaining triangles are favored, so that they get out
+  // of the way instead of being fetched again later.
+  return score + kValenceBoostScale *
+                     std::pow(static_cast<float>(remaining_triangles),
+                              -kValenceBoostPower);
+}
+
+// Reorders the triangles of a triangle list with Forsyth's greedy algorithm:
+// the next triangle is the highest scoring one among those using a cached
+// vertex, where a triangle scores the sum of its vertex scores.
+std::vector<int> ReorderForVertexCache(const std::vector<int>& indices,
+                                       int vertex_count) {
+  const int triangle_count = indices.size() / 3;
+
+  // Triangles using each vertex, with the remaining ones first.
+  std::vector<int> remaining(vertex_count, 0);
+  for (int index : indices) {
+    remaining[index]++;
+  }
+  std::vector<int> adjacency_offsets(vertex_count + 1, 0);
+  for (int vertex = 0; vertex < vertex_count; ++vertex) {
+    adjacency_offsets[vertex + 1] =
+        adjacency_offsets[vertex] + remaining[vertex];
+  }
+  std::vector<int> adjacency(indices.size());
+  std::vector<int> adjacency_ends(adjacency_offsets.begin(),
+                                  adjacency_offsets.end() - 1);
+  for (int triangle = 0; triangle < triangle_count; ++triangle) {
+    for (int corner = 0; corner < 3; ++corner) {
+      adjacency[adjacency_ends[indices[3 * triangle + corner]]++] = triangle;
+    }
+  }
+
+  std::vector<int> cache_positions(vertex_count, -1);
+  std::vector<float> vertex_scores(vertex_count);
+  for (int vertex = 0; vertex < vertex_count; ++vertex) {
+    vertex_scores[vertex] = VertexScore(-1, remaining[vertex]);
+  }
+  std::vector<float> triangle_scores(triangle_count);
+  std::vector<bool> emitted(triangle_count, false);
+  for (int triangle = 0; triangle < triangle_count; ++triangle) {
+    for (int corner = 0; corner < 3; ++corner) {
+      triangle_scores[triangle] +=
+          vertex_scores[indices[3 * triangle + corner]];
+    }
+  }
+
+  // Returns the best remaining triangle, or -1 when all were emitted.
+  const auto find_best_triangle = [&]() {
+    int best_triangle = -1;
+    float best_score = -std::numeric_limits<float>::infinity();
+    for (int triangle = 0; triangle < triangle_count; ++triangle) {
+      if (!emitted[triangle] && triangle_scores[triangle] > best_score) {
+        best_triangle = triangle;
+        best_score = triangle_scores[triangle];
+      }
+    }
+    return best_triangle;
+  };
+
+  // Most recently used vertex first. It temporarily holds up to three
+  // vertices more than kCacheSize, before the evicted ones are updated.
+  std::vector<int> cache;
+  cache.reserve(kCacheSize + 3);
+  std::vector<int> reordered;
+  reordered.reserve(indices.size());
+  int best_triangle = find_best_triangle();
+  while (best_triangle >= 0) {
+    emitted[best_triangle] = true;
+    for (int corner = 0; corner < 3; ++corner) {
+      const int vertex = indices[3 * best_triangle + corner];
+      reordered.push_back(vertex);
+
+      // Moves the triangle after the remaining ones of the vertex.
+      const int begin = adjacency_offsets[vertex];
+      const int end = begin + remaining[vertex];
+      std::swap(*std::find(adjacency.begin() + begin, adjacency.begin() + end,
+                           best_triangle),
+                adjacency[end - 1]);
+      remaining[vertex]--;
+
+      const auto cached = std::find(cache.begin(), cache.end(), vertex);
+      if (cached != cache.end()) {
+        cache.erase(cached);
+      }
+      cache.insert(cache.begin(), vertex);
+    }
+
+    // Updates the scores of the cached and evicted vertices, and of their
+    // remaining triangles.
+    for (int position = 0; position < static_cast<int>(cache.size());
+         ++position) {
+      const int vertex = cache[position];
+      cache_positions[vertex] = position < kCacheSize ? position : -1;
+      const float score =
+          VertexScore(cache_positions[vertex], remaining[vertex]);
+      const float score_change = score - vertex_scores[vertex];
+      vertex_scores[vertex] = score;
+      const int begin = adjacency_offsets[vertex];
+      for (int i = begin; i < begin + remaining[vertex]; ++i) {
+        triangle_scores[adjacency[i]] += score_change;
+      }
+    }
+    if (cache.size() > kCacheSize) {
+      cache.resize(kCacheSize);
+    }
+
+    best_triangle = -1;
+    float best_score = -std::numeric_limits<float>::infinity();
+    for (int vertex : cache) {
+      const int begin = adjacency_offsets[vertex];
+      for (int i = begin; i < begin + remaining[vertex]; ++i) {
+        if (triangle_scores[adjacency[i]] > best_score) {
+          best_triangle = adjacency[i];
+          best_score = triangle_scores[adjacency[i]];
+        }
+      }
+    }
+    // No cached vertex is used by a remaining triangle, so the search starts
+    // again from scratch.
+    if (best_triangle < 0) {
+      best_triangle = find_best_triangle();
+    }
+  }
+  return reordered;
+}
+
+}  // namespace
+
+TriangleListMesh OptimizeDistortionMesh(const CardboardMesh& mesh,
+                                        CardboardEye eye) {
+  // Eye half of the display in NDC, where the renderers scissor the mesh.
+  const float min_x = eye == kLeft ? -1.0f : 0.0f;
+  const float max_x = eye == kLeft ? 0.0f : 1.0f;
+  const auto x = [&mesh](int index) { return mesh.vertices[2 * index]; };
+  const auto y = [&mesh](int index) { return mesh.vertices[2 * index + 1]; };
+
+  std::vector<int> triangles;
+  for (int i = 2; i < mesh.n_indices; ++i) {
+    int a = mesh.indices[i - 2];
+    int b = mesh.indices[i - 1];
+    int c = mesh.indices[i];
+    if (a == b || b == c || a == c || std::min({a, b, c}) < 0 ||
+        std::max({a, b, c}) >= mesh.n_vertices) {
+      continue;
+    }
+    if ((x(a) < min_x && x(b) < min_x && x(c) < min_x) ||
+        (x(a) > max_x && x(b) > max_x && x(c) > max_x) ||
+        (y(a) < -1.0f && y(b) < -1.0f && y(c) < -1.0f) ||
+        (y(a) > 1.0f && y(b) > 1.0f && y(c) > 1.0f)) {
+      continue;
+    }
+    // Strips alternate their winding, so clockwise triangles are turned
+    // around.
+    const float area =
+        (x(b) - x(a)) * (y(c) - y(a)) - (y(b) - y(a)) * (x(c) - x(a));
+    if (area == 0.0f) {
+      continue;
+    }
+    if (area < 0.0f) {
+      std::swap(b, c);
+    }
+    triangles.insert(triangles.end(), {a, b, c});
+  }
+
+  TriangleListMesh optimized_mesh;
+  optimized_mesh.indices = ReorderForVertexCache(triangles, mesh.n_vertices);
+
+  std::vector<int> new_indices(mesh.n_vertices, -1);
+  for (int& index : optimized_mesh.indices) {
+    if (new_indices[index] < 0) {
+      new_indices[index] = optimized_mesh.vertices.size() / 2;
+      optimized_mesh.vertices.insert(optimized_mesh.vertices.end(),
+                                     {x(index), y(index)});
+      optimized_mesh.uvs.insert(
+          optimized_mesh.uvs.end(),
+          {mesh.uvs[2 * index], mesh.uvs[2 * index + 1]});
+    }
+    index = new_indices[index];
+  }
+  return optimized_mesh;
+}
+
+}  // namespace rendering
+}  // namespace cardboard
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_RENDERING_DISTORTION_MESH_OPTIMIZER_H_
+#define CARDBOARD_SDK_RENDERING_DISTORTION_MESH_OPTIMIZER_H_
+
+#include <vector>
+
+#include "include/cardboard.h"
+
+namespace cardboard {
+namespace rendering {
+
+// Indexed triangle list, drawn with GL_TRIANGLES or
+// VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST.
+struct TriangleListMesh {
+  // Two components per vertex, in display NDC.
+  std::vector<float> vertices;
+  // Two components per vertex, in eye texture [0, 1] coordinates.
+  std::vector<float> uvs;
+  // Three indices per triangle, counterclockwise on the display.
+  std::vector<int> indices;
+};
+
+// Converts a distortion mesh triangle strip, as returned by
+// CardboardLensDistortion_getDistortionMesh(), into a triangle list for the
+// distortion renderers:
+//   - Degenerate triangles joining the strip rows are removed.
+//   - Triangles entirely outside the eye half of the display are removed.
+//     They shade no fragments, but still cost vertex shader invocations.
+//   - Triangles are reordered for the post-transform vertex cache, following
+//     Forsyth's "Linear-Speed Vertex Cache Optimisation".
+//   - Vertices are renumbered in order of first use, for the pre-transform
+//     vertex fetch, and unused vertices are removed.
+//
+// @param mesh distortion mesh triangle strip.
+// @param eye eye the mesh is displayed for.
+// @return triangle list of the visible part of the mesh.
+TriangleListMesh OptimizeDistortionMesh(const CardboardMesh& mesh,
+                                        CardboardEye eye);
+
+}  // namespace rendering
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_RENDERING_DISTORTION_MESH_OPTIMIZER_H_
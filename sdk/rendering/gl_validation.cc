@@ -0,0 +1,121 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "rendering/gl_validation.h"
+
+#include <atomic>
+#include <cstring>
+
+#ifdef __ANDROID__
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#endif
+#ifdef __APPLE__
+#include <OpenGLES/ES2/gl.h>
+#endif
+#include "util/logging.h"
+
+namespace cardboard {
+namespace rendering {
+
+namespace {
+
+std::atomic<CardboardGlValidationLevel> validation_level(
+    CARDBOARD_DEFAULT_GL_VALIDATION_LEVEL);
+
+#ifdef __ANDROID__
+bool HasKhrDebugExtension() {
+  const char* extensions =
+      reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+  return extensions != nullptr && strstr(extensions, "GL_KHR_debug") != nullptr;
+}
+
+void GL_APIENTRY OnGlDebugMessage(GLenum /*source*/, GLenum type, GLuint id,
+                                  GLenum severity, GLsizei /*length*/,
+                                  const GLchar* message,
+                                  const void* /*user_param*/) {
+  // The debug output stays enabled when the level changes afterwards.
+  if (validation_level.load(std::memory_order_relaxed) !=
+      kGlValidationDebugOutput) {
+    return;
+  }
+  if (type == GL_DEBUG_TYPE_ERROR_KHR ||
+      severity == GL_DEBUG_SEVERITY_HIGH_KHR) {
+    CARDBOARD_LOGE("GL debug message %u: %s", id, message);
+  }
+}
+#endif
+
+}  // namespace
+
+void SetGlValidationLevel(CardboardGlValidationLevel level) {
+  validation_level.store(level, std::memory_order_relaxed);
+}
+
+CardboardGlValidationLevel GetGlValidationLevel() {
+  return validation_level.load(std::memory_order_relaxed);
+}
+
+bool CheckGlError(const char* label) {
+  if (GetGlValidationLevel() != kGlValidationSynchronous) {
+    return false;
+  }
+  const GLenum gl_error = glGetError();
+  if (gl_error == GL_NO_ERROR) {
+    return false;
+  }
+  CARDBOARD_LOGE("GL error %s: %d", label, gl_error);
+  return true;
+}
+
+void ConfigureGlDebugOutput() {
+  // The debug output state belongs to the app context, so it is left as is
+  // unless debug output validation is requested.
+  if (GetGlValidationLevel() != kGlValidationDebugOutput) {
+    return;
+  }
+#ifdef __ANDROID__
+  if (!HasKhrDebugExtension()) {
+    CARDBOARD_LOGE("GL_KHR_debug is not available. GL errors are not logged.");
+    return;
+  }
+  // Extension functions are not exported by libGLESv2.
+  auto get_pointerv = reinterpret_cast<PFNGLGETPOINTERVKHRPROC>(
+      eglGetProcAddress("glGetPointervKHR"));
+  auto debug_message_callback =
+      reinterpret_cast<PFNGLDEBUGMESSAGECALLBACKKHRPROC>(
+          eglGetProcAddress("glDebugMessageCallbackKHR"));
+  if (get_pointerv == nullptr || debug_message_callback == nullptr) {
+    return;
+  }
+  // A callback installed by the app is kept. It receives the SDK messages too.
+  void* callback = nullptr;
+  get_pointerv(GL_DEBUG_CALLBACK_FUNCTION_KHR, &callback);
+  if (callback == nullptr) {
+    debug_message_callback(OnGlDebugMessage, nullptr);
+  } else if (callback != reinterpret_cast<void*>(OnGlDebugMessage)) {
+    CARDBOARD_LOGI(
+        "GL debug message callback already set. SDK GL errors are reported "
+        "to it.");
+  }
+  glEnable(GL_DEBUG_OUTPUT_KHR);
+#else
+  CARDBOARD_LOGE("GL_KHR_debug is not available. GL errors are not logged.");
+#endif
+}
+
+}  // namespace rendering
+}  // namespace cardboard
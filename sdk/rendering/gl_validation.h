@@ -0,0 +1,73 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_RENDERING_GL_VALIDATION_H_
+#define CARDBOARD_SDK_RENDERING_GL_VALIDATION_H_
+
+#include "include/cardboard.h"
+
+// OpenGL error checking of the SDK renderers.
+//
+// glGetError() forces a pipeline sync on many mobile drivers, so synchronous
+// checks are only enabled by default in debug builds. The level can be changed
+// at runtime with SetGlValidationLevel(), and all checks can be compiled out by
+// defining CARDBOARD_DISABLE_GL_VALIDATION.
+
+// Validation level used until SetGlValidationLevel() is called.
+#ifndef CARDBOARD_DEFAULT_GL_VALIDATION_LEVEL
+#ifdef NDEBUG
+#define CARDBOARD_DEFAULT_GL_VALIDATION_LEVEL kGlValidationNone
+#else
+#define CARDBOARD_DEFAULT_GL_VALIDATION_LEVEL kGlValidationSynchronous
+#endif
+#endif
+
+#ifdef CARDBOARD_DISABLE_GL_VALIDATION
+#define CARDBOARD_CHECK_GL_ERROR(label)
+#else
+// @def Logs pending GL errors, tagged with @p label, when the validation level
+//      is kGlValidationSynchronous.
+#define CARDBOARD_CHECK_GL_ERROR(label) \
+  ::cardboard::rendering::CheckGlError(label)
+#endif
+
+namespace cardboard {
+namespace rendering {
+
+// Sets the process-wide validation level. Thread-safe.
+//
+// @param level validation level.
+void SetGlValidationLevel(CardboardGlValidationLevel level);
+
+// Returns the process-wide validation level. Thread-safe.
+CardboardGlValidationLevel GetGlValidationLevel();
+
+// Logs pending GL errors when the validation level is
+// kGlValidationSynchronous. Must be called from the render thread.
+//
+// @param label tag of the logged errors.
+// @return true if a GL error was pending.
+bool CheckGlError(const char* label);
+
+// Enables KHR_debug output on the current GL context when the validation level
+// is kGlValidationDebugOutput, and does nothing otherwise. Messages are logged
+// asynchronously, without syncing the pipeline. A debug message callback
+// already installed by the app is kept. Must be called from the render thread.
+void ConfigureGlDebugOutput();
+
+}  // namespace rendering
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_RENDERING_GL_VALIDATION_H_
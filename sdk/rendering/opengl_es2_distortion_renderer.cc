@@ -24,21 +24,32 @@
 #endif
 #include "distortion_renderer.h"
 #include "include/cardboard.h"
+#include "rendering/distortion_mesh_optimizer.h"
+#include "rendering/gl_validation.h"
 #include "screen_params.h"
 #include "util/is_initialized.h"
 #include "util/logging.h"
+#include "util/metrics.h"
+#include "util/trace.h"
 
 namespace {
 
+// Texture coordinates are rotated by u_Reprojection in the eye tan-angle
+// space, see rendering/rotational_reprojection.h.
 constexpr const char* kDistortionVertexShader =
     R"glsl(
     attribute vec2 a_Position;
     attribute vec2 a_TexCoords;
+    uniform mat3 u_Reprojection;
+    uniform vec4 u_TanAngleRect;
     varying vec2 v_TexCoords;
 
     void main() {
       gl_Position = vec4(a_Position, 0, 1);
-      v_TexCoords = a_TexCoords;
+      vec3 direction = u_Reprojection *
+          vec3(a_TexCoords * u_TanAngleRect.zw - u_TanAngleRect.xy, -1);
+      v_TexCoords = (direction.xy / -direction.z + u_TanAngleRect.xy) /
+          u_TanAngleRect.zw;
     })glsl";
 
 constexpr const char* kDistortionFragmentShader =
@@ -55,18 +66,57 @@ constexpr const char* kDistortionFragmentShader =
       gl_FragColor = texture2D(u_Texture, coords);
     })glsl";
 
-void CheckGlError(const char* label) {
-  int gl_error = glGetError();
-  if (gl_error != GL_NO_ERROR) {
-    CARDBOARD_LOGE("GL error %s: %d", label, gl_error);
-  }
-}
+// Renders both eyes from the merged mesh. Each eye UV rectangle is packed as
+// (left_u, bottom_v, right_u, top_v) and picked by the per-vertex eye index.
+// v_Side is positive on the other eye half of the display, where fragments
+// are discarded. It is linear in screen space, so triangles crossing the
+// display center are clipped exactly there.
+constexpr const char* kStereoDistortionVertexShader =
+    R"glsl(
+    attribute vec2 a_Position;
+    attribute vec2 a_TexCoords;
+    attribute float a_Eye;
+    uniform vec4 u_EyeRects[2];
+    uniform mat3 u_Reprojection;
+    uniform vec4 u_TanAngleRects[2];
+    varying vec2 v_TexCoords;
+    varying float v_Side;
+
+    void main() {
+      gl_Position = vec4(a_Position, 0, 1);
+      v_Side = mix(a_Position.x, -a_Position.x, a_Eye);
+      vec4 tan_angle_rect = mix(u_TanAngleRects[0], u_TanAngleRects[1], a_Eye);
+      vec3 direction = u_Reprojection *
+          vec3(a_TexCoords * tan_angle_rect.zw - tan_angle_rect.xy, -1);
+      vec2 coords = (direction.xy / -direction.z + tan_angle_rect.xy) /
+          tan_angle_rect.zw;
+      vec4 rect = mix(u_EyeRects[0], u_EyeRects[1], a_Eye);
+      v_TexCoords = rect.xy + coords * (rect.zw - rect.xy);
+    })glsl";
+
+constexpr const char* kStereoDistortionFragmentShader =
+    R"glsl(
+    precision mediump float;
+
+    uniform sampler2D u_Texture;
+    varying vec2 v_TexCoords;
+    varying float v_Side;
+
+    void main() {
+      if (v_Side > 0.0) {
+        discard;
+      }
+      gl_FragColor = texture2D(u_Texture, v_TexCoords);
+    })glsl";
+
+// Number of floats per vertex of the merged stereo mesh: x, y, u, v, eye.
+constexpr int kStereoVertexComponents = 5;
 
 GLuint LoadShader(GLenum shader_type, const char* source) {
   GLuint shader = glCreateShader(shader_type);
   glShaderSource(shader, 1, &source, nullptr);
   glCompileShader(shader);
-  CheckGlError("glCompileShader");
+  CARDBOARD_CHECK_GL_ERROR("glCompileShader");
   GLint result = GL_FALSE;
   glGetShaderiv(shader, GL_COMPILE_STATUS, &result);
   if (result == GL_FALSE) {
@@ -103,7 +153,7 @@ GLuint CreateProgram(const char* vertex, const char* fragment) {
   glAttachShader(program, vertex_shader);
   glAttachShader(program, fragment_shader);
   glLinkProgram(program);
-  CheckGlError("glLinkProgram");
+  CARDBOARD_CHECK_GL_ERROR("glLinkProgram");
 
   GLint result = GL_FALSE;
   glGetProgramiv(program, GL_LINK_STATUS, &result);
@@ -125,7 +175,7 @@ GLuint CreateProgram(const char* vertex, const char* fragment) {
   glDetachShader(program, fragment_shader);
   glDeleteShader(vertex_shader);
   glDeleteShader(fragment_shader);
-  CheckGlError("GlCreateProgram");
+  CARDBOARD_CHECK_GL_ERROR("GlCreateProgram");
 
   return program;
 }
@@ -142,26 +192,44 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
       : vertices_vbo_{0, 0},
         uvs_vbo_{0, 0},
         elements_vbo_{0, 0},
-        elements_count_{0, 0} {
+        elements_count_{0, 0},
+        stereo_vertices_vbo_(0),
+        stereo_elements_vbo_(0),
+        stereo_elements_count_(0),
+        stereo_program_(0),
+        eye_texture_layout_(kEyeTextureLayoutSeparate) {
+    ConfigureGlDebugOutput();
+
     program_ =
         CreateProgram(kDistortionVertexShader, kDistortionFragmentShader);
     attrib_pos_ = glGetAttribLocation(program_, "a_Position");
     attrib_tex_ = glGetAttribLocation(program_, "a_TexCoords");
     uniform_start_ = glGetUniformLocation(program_, "u_Start");
     uniform_end_ = glGetUniformLocation(program_, "u_End");
+    uniform_reprojection_ = glGetUniformLocation(program_, "u_Reprojection");
+    uniform_tan_angle_rect_ =
+        glGetUniformLocation(program_, "u_TanAngleRect");
 
     // Gen buffers, one per eye.
     glGenBuffers(2, &vertices_vbo_[0]);
     glGenBuffers(2, &uvs_vbo_[0]);
     glGenBuffers(2, &elements_vbo_[0]);
-    CheckGlError("OpenGlEs2DistortionRendererSetUp");
+    // Gen buffers for the merged mesh of both eyes.
+    glGenBuffers(1, &stereo_vertices_vbo_);
+    glGenBuffers(1, &stereo_elements_vbo_);
+    CARDBOARD_CHECK_GL_ERROR("OpenGlEs2DistortionRendererSetUp");
   }
 
   ~OpenGlEs2DistortionRenderer() {
     glDeleteBuffers(2, &vertices_vbo_[0]);
     glDeleteBuffers(2, &uvs_vbo_[0]);
     glDeleteBuffers(2, &elements_vbo_[0]);
-    CheckGlError("~OpenGlEs2DistortionRenderer");
+    glDeleteBuffers(1, &stereo_vertices_vbo_);
+    glDeleteBuffers(1, &stereo_elements_vbo_);
+    if (stereo_program_ != 0) {
+      glDeleteProgram(stereo_program_);
+    }
+    CARDBOARD_CHECK_GL_ERROR("~OpenGlEs2DistortionRenderer");
   }
 
   /*
@@ -170,22 +238,57 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
    *   - glGet(GL_ELEMENT_ARRAY_BUFFER_BINDING)
    */
   void SetMesh(const CardboardMesh* mesh, CardboardEye eye) override {
+    const TriangleListMesh triangle_list = OptimizeDistortionMesh(*mesh, eye);
     glBindBuffer(GL_ARRAY_BUFFER, vertices_vbo_[eye]);
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        mesh->n_vertices * sizeof(float) * 2,  // Two components per vertex
-        mesh->vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, uvs_vbo_[eye]);
     glBufferData(GL_ARRAY_BUFFER,
-                 mesh->n_vertices * sizeof(float) * 2,  // Two components per uv
-                 mesh->uvs, GL_STATIC_DRAW);
+                 triangle_list.vertices.size() * sizeof(float),
+                 triangle_list.vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, uvs_vbo_[eye]);
+    glBufferData(GL_ARRAY_BUFFER, triangle_list.uvs.size() * sizeof(float),
+                 triangle_list.uvs.data(), GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elements_vbo_[eye]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh->n_indices * sizeof(int),
-                 mesh->indices, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 triangle_list.indices.size() * sizeof(int),
+                 triangle_list.indices.data(), GL_STATIC_DRAW);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    CheckGlError("OpenGlEs2DistortionRenderer::SetMesh");
-    elements_count_[eye] = mesh->n_indices;
+    CARDBOARD_CHECK_GL_ERROR("OpenGlEs2DistortionRenderer::SetMesh");
+    elements_count_[eye] = triangle_list.indices.size();
+
+    SetStereoMesh(triangle_list, eye);
+  }
+
+  /*
+   * Modifies the OpenGL global state. In particular:
+   *   - glGet(GL_CURRENT_PROGRAM)
+   *   - glGet(GL_ARRAY_BUFFER_BINDING)
+   *   - glGet(GL_ELEMENT_ARRAY_BUFFER_BINDING)
+   */
+  void SetEyeTextureLayout(CardboardEyeTextureLayout layout) override {
+    if (layout == kEyeTextureLayoutArray) {
+      CARDBOARD_LOGE(
+          "Texture arrays are not supported by OpenGlEs2DistortionRenderer.");
+      return;
+    }
+    if (layout == kEyeTextureLayoutSideBySide && stereo_program_ == 0) {
+      stereo_program_ = CreateProgram(kStereoDistortionVertexShader,
+                                      kStereoDistortionFragmentShader);
+      stereo_attrib_pos_ = glGetAttribLocation(stereo_program_, "a_Position");
+      stereo_attrib_tex_ = glGetAttribLocation(stereo_program_, "a_TexCoords");
+      stereo_attrib_eye_ = glGetAttribLocation(stereo_program_, "a_Eye");
+      uniform_eye_rects_ =
+          glGetUniformLocation(stereo_program_, "u_EyeRects");
+      stereo_uniform_reprojection_ =
+          glGetUniformLocation(stereo_program_, "u_Reprojection");
+      stereo_uniform_tan_angle_rects_ =
+          glGetUniformLocation(stereo_program_, "u_TanAngleRects");
+      CARDBOARD_CHECK_GL_ERROR(
+          "OpenGlEs2DistortionRenderer::SetEyeTextureLayout");
+    }
+    eye_texture_layout_ = layout;
+    if (layout != kEyeTextureLayoutSeparate && stereo_elements_count_ == 0) {
+      UploadStereoMesh();
+    }
   }
 
   /*
@@ -205,6 +308,8 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
       int target_display, int x, int y, int width, int height,
       const CardboardEyeTextureDescription* left_eye,
       const CardboardEyeTextureDescription* right_eye) const override {
+    CARDBOARD_TRACE_SCOPE("DistortionRenderer::RenderEyeToDisplay");
+    Metrics::ScopedTimer submit_timer(Metrics::Timing::kDistortionSubmit);
     if (elements_count_[0] == 0 || elements_count_[1] == 0) {
       CARDBOARD_LOGE(
           "Distortion mesh is empty. OpenGlEs2DistortionRenderer::SetMesh was "
@@ -219,14 +324,25 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
     glClearColor(.0f, .0f, .0f, 1.0f);
     glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
 
-    glUseProgram(program_);
-
-    glEnable(GL_SCISSOR_TEST);
-    glScissor(x, y, width / 2, height);
-    RenderDistortionMesh(left_eye, kLeft);
-
-    glScissor(x + width / 2, y, width / 2, height);
-    RenderDistortionMesh(right_eye, kRight);
+    // Queries the head tracker as late as possible.
+    const std::array<float, 9> reprojection = reprojection_.LatchRotation();
+    if (eye_texture_layout_ == kEyeTextureLayoutSeparate) {
+      glUseProgram(program_);
+      glUniformMatrix3fv(uniform_reprojection_, 1, GL_FALSE,
+                         reprojection.data());
+
+      glEnable(GL_SCISSOR_TEST);
+      glScissor(x, y, width / 2, height);
+      RenderDistortionMesh(left_eye, kLeft);
+
+      glScissor(x + width / 2, y, width / 2, height);
+      RenderDistortionMesh(right_eye, kRight);
+    } else {
+      glUseProgram(stereo_program_);
+      glUniformMatrix3fv(stereo_uniform_reprojection_, 1, GL_FALSE,
+                         reprojection.data());
+      RenderStereoDistortionMesh(left_eye, right_eye);
+    }
 
     // Active GL_TEXTURE0 effectively enables the first texture that is
     // deactiviated by the DistortionRenderer. Binding array buffer and element
@@ -239,7 +355,7 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
 
     // Disable scissor test.
     glDisable(GL_SCISSOR_TEST);
-    CheckGlError("OpenGlEs2DistortionRenderer::RenderEyeToDisplay");
+    CARDBOARD_CHECK_GL_ERROR("OpenGlEs2DistortionRenderer::RenderEyeToDisplay");
   }
 
  private:
@@ -279,11 +395,137 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
     glUniform2f(uniform_start_, eye_description->left_u,
                 eye_description->bottom_v);
     glUniform2f(uniform_end_, eye_description->right_u, eye_description->top_v);
+    glUniform4fv(uniform_tan_angle_rect_, 1,
+                 reprojection_.GetTanAngleRect(eye).data());
 
     // Draw with indices
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elements_vbo_[eye]);
-    glDrawElements(GL_TRIANGLE_STRIP, elements_count_[eye], GL_UNSIGNED_INT, 0);
-    CheckGlError("OpenGlEs2DistortionRenderer::RenderDistortionMesh");
+    glDrawElements(GL_TRIANGLES, elements_count_[eye], GL_UNSIGNED_INT, 0);
+    CARDBOARD_CHECK_GL_ERROR(
+        "OpenGlEs2DistortionRenderer::RenderDistortionMesh");
+  }
+
+  /*
+   * Modifies the OpenGL global state. In particular:
+   *   - glGet(GL_ARRAY_BUFFER_BINDING)
+   *   - glGet(GL_ELEMENT_ARRAY_BUFFER_BINDING)
+   *   - glGetVertexAttrib(i, GL_VERTEX_ATTRIB_*)
+   *   - glGetVertextAttrib(i, GL_VERTEX_ATTRIB_ARRAY_ENABLED)
+   *   - glGet(GL_ACTIVE_TEXTURE+i)
+   *   - glGet(GL_TEXTURE_BINDING_2D)
+   *   - glGetUniform(program, location)
+   */
+  void RenderStereoDistortionMesh(
+      const CardboardEyeTextureDescription* left_eye,
+      const CardboardEyeTextureDescription* right_eye) const {
+    constexpr GLsizei kStride = kStereoVertexComponents * sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, stereo_vertices_vbo_);
+    glVertexAttribPointer(stereo_attrib_pos_, 2, GL_FLOAT, false, kStride,
+                          reinterpret_cast<const void*>(0));
+    glEnableVertexAttribArray(stereo_attrib_pos_);
+    glVertexAttribPointer(stereo_attrib_tex_, 2, GL_FLOAT, false, kStride,
+                          reinterpret_cast<const void*>(2 * sizeof(float)));
+    glEnableVertexAttribArray(stereo_attrib_tex_);
+    glVertexAttribPointer(stereo_attrib_eye_, 1, GL_FLOAT, false, kStride,
+                          reinterpret_cast<const void*>(4 * sizeof(float)));
+    glEnableVertexAttribArray(stereo_attrib_eye_);
+
+    // Both eyes sample the left eye texture.
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, left_eye->texture);
+
+    const GLfloat eye_rects[8] = {
+        left_eye->left_u,   left_eye->bottom_v,  left_eye->right_u,
+        left_eye->top_v,    right_eye->left_u,   right_eye->bottom_v,
+        right_eye->right_u, right_eye->top_v};
+    glUniform4fv(uniform_eye_rects_, 2, eye_rects);
+    const std::array<float, 4> left_tan_angle_rect =
+        reprojection_.GetTanAngleRect(kLeft);
+    const std::array<float, 4> right_tan_angle_rect =
+        reprojection_.GetTanAngleRect(kRight);
+    const GLfloat tan_angle_rects[8] = {
+        left_tan_angle_rect[0],  left_tan_angle_rect[1],
+        left_tan_angle_rect[2],  left_tan_angle_rect[3],
+        right_tan_angle_rect[0], right_tan_angle_rect[1],
+        right_tan_angle_rect[2], right_tan_angle_rect[3]};
+    glUniform4fv(stereo_uniform_tan_angle_rects_, 2, tan_angle_rects);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, stereo_elements_vbo_);
+    glDrawElements(GL_TRIANGLES, stereo_elements_count_, GL_UNSIGNED_INT, 0);
+    CARDBOARD_CHECK_GL_ERROR(
+        "OpenGlEs2DistortionRenderer::RenderStereoDistortionMesh");
+  }
+
+  /*
+   * Modifies the OpenGL global state. In particular:
+   *   - glGet(GL_ARRAY_BUFFER_BINDING)
+   *   - glGet(GL_ELEMENT_ARRAY_BUFFER_BINDING)
+   */
+  void SetStereoMesh(const TriangleListMesh& mesh, CardboardEye eye) {
+    // Keeps an interleaved copy of the eye mesh. The fragment shader discards
+    // the fragments on the other eye half of the display, which replaces the
+    // per eye scissor.
+    std::vector<float>& vertices = stereo_mesh_vertices_[eye];
+    const int vertex_count = mesh.vertices.size() / 2;
+    vertices.resize(vertex_count * kStereoVertexComponents);
+    for (int i = 0; i < vertex_count; ++i) {
+      float* vertex = &vertices[i * kStereoVertexComponents];
+      vertex[0] = mesh.vertices[2 * i];
+      vertex[1] = mesh.vertices[2 * i + 1];
+      vertex[2] = mesh.uvs[2 * i];
+      vertex[3] = mesh.uvs[2 * i + 1];
+      vertex[4] = static_cast<float>(eye);
+    }
+    stereo_mesh_indices_[eye] = mesh.indices;
+    stereo_elements_count_ = 0;
+
+    // The merged mesh is only uploaded for the single draw layouts.
+    if (eye_texture_layout_ != kEyeTextureLayoutSeparate) {
+      UploadStereoMesh();
+    }
+  }
+
+  /*
+   * Modifies the OpenGL global state. In particular:
+   *   - glGet(GL_ARRAY_BUFFER_BINDING)
+   *   - glGet(GL_ELEMENT_ARRAY_BUFFER_BINDING)
+   */
+  void UploadStereoMesh() {
+    const std::vector<int>& left_indices = stereo_mesh_indices_[kLeft];
+    const std::vector<int>& right_indices = stereo_mesh_indices_[kRight];
+    if (left_indices.empty() || right_indices.empty()) {
+      return;
+    }
+
+    // Appends the right triangle list to the left one.
+    const int right_offset =
+        stereo_mesh_vertices_[kLeft].size() / kStereoVertexComponents;
+    std::vector<int> indices(left_indices);
+    indices.reserve(left_indices.size() + right_indices.size());
+    for (int index : right_indices) {
+      indices.push_back(index + right_offset);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, stereo_vertices_vbo_);
+    glBufferData(GL_ARRAY_BUFFER,
+                 (stereo_mesh_vertices_[kLeft].size() +
+                  stereo_mesh_vertices_[kRight].size()) *
+                     sizeof(float),
+                 nullptr, GL_STATIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0,
+                    stereo_mesh_vertices_[kLeft].size() * sizeof(float),
+                    stereo_mesh_vertices_[kLeft].data());
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    stereo_mesh_vertices_[kLeft].size() * sizeof(float),
+                    stereo_mesh_vertices_[kRight].size() * sizeof(float),
+                    stereo_mesh_vertices_[kRight].data());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, stereo_elements_vbo_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(int),
+                 indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    CARDBOARD_CHECK_GL_ERROR("OpenGlEs2DistortionRenderer::UploadStereoMesh");
+    stereo_elements_count_ = indices.size();
   }
 
   std::array<GLuint, 2> vertices_vbo_;  // One per eye.
@@ -291,11 +533,30 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
   std::array<GLuint, 2> elements_vbo_;
   std::array<int, 2> elements_count_;
 
+  // Merged mesh of both eyes, used by the single draw layouts.
+  std::array<std::vector<float>, 2> stereo_mesh_vertices_;
+  std::array<std::vector<int>, 2> stereo_mesh_indices_;
+  GLuint stereo_vertices_vbo_;
+  GLuint stereo_elements_vbo_;
+  int stereo_elements_count_;
+
   GLuint program_;
   GLuint attrib_pos_;
   GLuint attrib_tex_;
   GLuint uniform_start_;
   GLuint uniform_end_;
+  GLuint uniform_reprojection_;
+  GLuint uniform_tan_angle_rect_;
+
+  GLuint stereo_program_;
+  GLuint stereo_attrib_pos_;
+  GLuint stereo_attrib_tex_;
+  GLuint stereo_attrib_eye_;
+  GLuint uniform_eye_rects_;
+  GLuint stereo_uniform_reprojection_;
+  GLuint stereo_uniform_tan_angle_rects_;
+
+  CardboardEyeTextureLayout eye_texture_layout_;
 };
 
 }  // namespace rendering
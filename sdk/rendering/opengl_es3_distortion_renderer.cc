@@ -17,6 +17,7 @@
  * the contents of this file if OpenGL ES 3.0 support is not needed.
  */
 #include <array>
+#include <limits>
 #include <vector>
 
 #ifdef __ANDROID__
@@ -27,50 +28,151 @@
 #endif
 #include "distortion_renderer.h"
 #include "include/cardboard.h"
+#include "rendering/distortion_mesh_optimizer.h"
+#include "rendering/gl_validation.h"
 #include "screen_params.h"
 #include "util/is_initialized.h"
 #include "util/logging.h"
+#include "util/metrics.h"
+#include "util/trace.h"
 
 namespace {
 
+// Each eye UV rectangle is packed as (left_u, bottom_v, right_u, top_v) and
+// picked by the eye index, which is also the texture array layer. Per eye
+// meshes take the eye index from a per eye vertex array, merged meshes take it
+// from each vertex. Texture coordinates are rotated by u_Reprojection in the
+// eye tan-angle space, see rendering/rotational_reprojection.h. v_Side is
+// positive on the other eye half of the display, where the merged mesh
+// fragment shaders discard fragments. It is linear in screen space, so merged
+// mesh triangles crossing the display center are clipped exactly there.
 constexpr const char* kDistortionVertexShader =
     R"glsl(#version 300 es
     layout (location = 0) in vec2 a_Position;
     layout (location = 1) in vec2 a_TexCoords;
-    out vec2 v_TexCoords;
+    layout (location = 2) in float a_Eye;
+    uniform vec4 u_EyeRects[2];
+    uniform mat3 u_Reprojection;
+    uniform vec4 u_TanAngleRects[2];
+    out vec3 v_TexCoords;
+    out float v_Side;
 
     void main() {
       gl_Position = vec4(a_Position, 0, 1);
-      v_TexCoords = a_TexCoords;
+      v_Side = mix(a_Position.x, -a_Position.x, a_Eye);
+      vec4 tan_angle_rect = mix(u_TanAngleRects[0], u_TanAngleRects[1], a_Eye);
+      vec3 direction = u_Reprojection *
+          vec3(a_TexCoords * tan_angle_rect.zw - tan_angle_rect.xy, -1);
+      vec2 coords = (direction.xy / -direction.z + tan_angle_rect.xy) /
+          tan_angle_rect.zw;
+      vec4 rect = mix(u_EyeRects[0], u_EyeRects[1], a_Eye);
+      v_TexCoords = vec3(rect.xy + coords * (rect.zw - rect.xy), a_Eye);
     })glsl";
 
+// Per eye meshes are clipped by the scissor test, so the separate layout uses
+// a fragment shader without discard, which would disable early fragment tests
+// on tile-based GPUs.
 constexpr const char* kDistortionFragmentShader =
     R"glsl(#version 300 es
     precision mediump float;
 
     uniform sampler2D u_Texture;
-    uniform vec2 u_Start;
-    uniform vec2 u_End;
-    in vec2 v_TexCoords;
+    in vec3 v_TexCoords;
     out vec4 o_FragColor;
 
     void main() {
-      vec2 coords = u_Start + v_TexCoords * (u_End - u_Start);
-      o_FragColor = texture(u_Texture, coords);
+      o_FragColor = texture(u_Texture, v_TexCoords.xy);
     })glsl";
 
-void CheckGlError(const char* label) {
-  int gl_error = glGetError();
-  if (gl_error != GL_NO_ERROR) {
-    CARDBOARD_LOGE("GL error %s: %d", label, gl_error);
+constexpr const char* kStereoDistortionFragmentShader =
+    R"glsl(#version 300 es
+    precision mediump float;
+
+    uniform sampler2D u_Texture;
+    in vec3 v_TexCoords;
+    in float v_Side;
+    out vec4 o_FragColor;
+
+    void main() {
+      if (v_Side > 0.0) {
+        discard;
+      }
+      o_FragColor = texture(u_Texture, v_TexCoords.xy);
+    })glsl";
+
+constexpr const char* kArrayDistortionFragmentShader =
+    R"glsl(#version 300 es
+    precision mediump float;
+    precision mediump sampler2DArray;
+
+    uniform sampler2DArray u_Texture;
+    in vec3 v_TexCoords;
+    in float v_Side;
+    out vec4 o_FragColor;
+
+    void main() {
+      if (v_Side > 0.0) {
+        discard;
+      }
+      o_FragColor = texture(u_Texture, v_TexCoords);
+    })glsl";
+
+// Attribute locations of kDistortionVertexShader.
+constexpr GLuint kAttribPos = 0;
+constexpr GLuint kAttribTex = 1;
+constexpr GLuint kAttribEye = 2;
+
+// Number of floats per vertex of the merged stereo mesh: x, y, u, v, eye.
+constexpr int kStereoVertexComponents = 5;
+
+// Number of floats of both eye UV rectangles, or of both eye tan-angle
+// rectangles.
+constexpr int kEyeRectsComponents = 8;
+
+// Number of floats of a 3x3 matrix.
+constexpr int kMatrix3x3Components = 9;
+
+// Uniform locations of a program built from kDistortionVertexShader, and the
+// values last uploaded to them. Uniforms are program state, so they only need
+// to be uploaded when they change.
+struct DistortionUniforms {
+  GLint eye_rects;
+  GLint tan_angle_rects;
+  GLint reprojection;
+  std::array<GLfloat, kEyeRectsComponents> eye_rects_values;
+  std::array<GLfloat, kEyeRectsComponents> tan_angle_rects_values;
+  std::array<GLfloat, kMatrix3x3Components> reprojection_values;
+};
+
+DistortionUniforms GetDistortionUniforms(GLuint program) {
+  DistortionUniforms uniforms;
+  uniforms.eye_rects = glGetUniformLocation(program, "u_EyeRects");
+  uniforms.tan_angle_rects = glGetUniformLocation(program, "u_TanAngleRects");
+  uniforms.reprojection = glGetUniformLocation(program, "u_Reprojection");
+  // NaN never compares equal, so the first values are always uploaded.
+  uniforms.eye_rects_values.fill(std::numeric_limits<GLfloat>::quiet_NaN());
+  uniforms.tan_angle_rects_values.fill(
+      std::numeric_limits<GLfloat>::quiet_NaN());
+  uniforms.reprojection_values.fill(std::numeric_limits<GLfloat>::quiet_NaN());
+  return uniforms;
+}
+
+// Stores values in cached_values and returns true if they differ.
+template <size_t N>
+bool UpdateCachedValues(const std::array<GLfloat, N>& values,
+                        std::array<GLfloat, N>* cached_values) {
+  if (values == *cached_values) {
+    return false;
   }
+  *cached_values = values;
+  return true;
 }
 
 GLuint LoadShader(GLenum shader_type, const char* source) {
   GLuint shader = glCreateShader(shader_type);
   glShaderSource(shader, 1, &source, nullptr);
   glCompileShader(shader);
-  CheckGlError("glCompileShader");
+  CARDBOARD_CHECK_GL_ERROR("glCompileShader");
   GLint result = GL_FALSE;
   glGetShaderiv(shader, GL_COMPILE_STATUS, &result);
   if (result == GL_FALSE) {
@@ -107,7 +209,7 @@ GLuint CreateProgram(const char* vertex, const char* fragment) {
   glAttachShader(program, vertex_shader);
   glAttachShader(program, fragment_shader);
   glLinkProgram(program);
-  CheckGlError("glLinkProgram");
+  CARDBOARD_CHECK_GL_ERROR("glLinkProgram");
 
   GLint result = GL_FALSE;
   glGetProgramiv(program, GL_LINK_STATUS, &result);
@@ -129,7 +231,7 @@ GLuint CreateProgram(const char* vertex, const char* fragment) {
   glDetachShader(program, fragment_shader);
   glDeleteShader(vertex_shader);
   glDeleteShader(fragment_shader);
-  CheckGlError("GlCreateProgram");
+  CARDBOARD_CHECK_GL_ERROR("GlCreateProgram");
 
   return program;
 }
@@ -146,50 +248,133 @@ class OpenGlEs3DistortionRenderer : public DistortionRenderer {
       : vertices_vbo_{0, 0},
         uvs_vbo_{0, 0},
         elements_vbo_{0, 0},
-        elements_count_{0, 0} {
+        elements_count_{0, 0},
+        vaos_{0, 0},
+        eye_vbo_(0),
+        stereo_vertices_vbo_(0),
+        stereo_elements_vbo_(0),
+        stereo_elements_count_(0),
+        stereo_vao_(0),
+        stereo_program_(0),
+        array_program_(0),
+        eye_texture_layout_(kEyeTextureLayoutSeparate) {
+    ConfigureGlDebugOutput();
+
     program_ =
         CreateProgram(kDistortionVertexShader, kDistortionFragmentShader);
-    attrib_pos_ = glGetAttribLocation(program_, "a_Position");
-    attrib_tex_ = glGetAttribLocation(program_, "a_TexCoords");
-    uniform_start_ = glGetUniformLocation(program_, "u_Start");
-    uniform_end_ = glGetUniformLocation(program_, "u_End");
+    uniforms_ = GetDistortionUniforms(program_);
 
-    // Gen buffers, one per eye.
+    // Gen buffers and vertex arrays, one per eye.
     glGenBuffers(2, &vertices_vbo_[0]);
     glGenBuffers(2, &uvs_vbo_[0]);
     glGenBuffers(2, &elements_vbo_[0]);
-    CheckGlError("OpenGlEs3DistortionRendererSetUp");
+    glGenVertexArrays(2, &vaos_[0]);
+    // Gen buffers and vertex array for the merged mesh of both eyes.
+    glGenBuffers(1, &stereo_vertices_vbo_);
+    glGenBuffers(1, &stereo_elements_vbo_);
+    glGenVertexArrays(1, &stereo_vao_);
+
+    // Per eye vertex arrays read their eye index from this buffer with an
+    // instance divisor, so it is the same for every vertex.
+    constexpr GLfloat kEyeIndices[2] = {kLeft, kRight};
+    glGenBuffers(1, &eye_vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, eye_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(kEyeIndices), kEyeIndices,
+                 GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    CARDBOARD_CHECK_GL_ERROR("OpenGlEs3DistortionRendererSetUp");
   }
 
   ~OpenGlEs3DistortionRenderer() {
+    glDeleteVertexArrays(2, &vaos_[0]);
+    glDeleteVertexArrays(1, &stereo_vao_);
     glDeleteBuffers(2, &vertices_vbo_[0]);
     glDeleteBuffers(2, &uvs_vbo_[0]);
     glDeleteBuffers(2, &elements_vbo_[0]);
-    CheckGlError("~OpenGlEs3DistortionRenderer");
+    glDeleteBuffers(1, &eye_vbo_);
+    glDeleteBuffers(1, &stereo_vertices_vbo_);
+    glDeleteBuffers(1, &stereo_elements_vbo_);
+    if (stereo_program_ != 0) {
+      glDeleteProgram(stereo_program_);
+    }
+    if (array_program_ != 0) {
+      glDeleteProgram(array_program_);
+    }
+    CARDBOARD_CHECK_GL_ERROR("~OpenGlEs3DistortionRenderer");
   }
 
   /*
    * Modifies the OpenGL global state. In particular:
+   *   - glGet(GL_VERTEX_ARRAY_BINDING)
    *   - glGet(GL_ARRAY_BUFFER_BINDING)
-   *   - glGet(GL_ELEMENT_ARRAY_BUFFER_BINDING)
    */
   void SetMesh(const CardboardMesh* mesh, CardboardEye eye) override {
+    const TriangleListMesh triangle_list = OptimizeDistortionMesh(*mesh, eye);
+    // The element array buffer binding and the attribute pointers are stored
+    // in the eye vertex array, so rendering only needs to bind it.
+    glBindVertexArray(vaos_[eye]);
     glBindBuffer(GL_ARRAY_BUFFER, vertices_vbo_[eye]);
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        mesh->n_vertices * sizeof(float) * 2,  // Two components per vertex
-        mesh->vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, uvs_vbo_[eye]);
     glBufferData(GL_ARRAY_BUFFER,
-                 mesh->n_vertices * sizeof(float) * 2,  // Two components per uv
-                 mesh->uvs, GL_STATIC_DRAW);
+                 triangle_list.vertices.size() * sizeof(float),
+                 triangle_list.vertices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(
+        kAttribPos,
+        2,  // 2 components per vertex
+        GL_FLOAT, false,
+        0,  // Stride and offset 0, as we are using different vbos.
+        0);
+    glEnableVertexAttribArray(kAttribPos);
+
+    glBindBuffer(GL_ARRAY_BUFFER, uvs_vbo_[eye]);
+    glBufferData(GL_ARRAY_BUFFER, triangle_list.uvs.size() * sizeof(float),
+                 triangle_list.uvs.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(kAttribTex,
+                          2,  // 2 components per uv
+                          GL_FLOAT, false, 0, 0);
+    glEnableVertexAttribArray(kAttribTex);
+
+    glBindBuffer(GL_ARRAY_BUFFER, eye_vbo_);
+    glVertexAttribPointer(kAttribEye, 1, GL_FLOAT, false, 0,
+                          reinterpret_cast<const void*>(eye * sizeof(float)));
+    glVertexAttribDivisor(kAttribEye, 1);
+    glEnableVertexAttribArray(kAttribEye);
+
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elements_vbo_[eye]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh->n_indices * sizeof(int),
-                 mesh->indices, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 triangle_list.indices.size() * sizeof(int),
+                 triangle_list.indices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    CheckGlError("OpenGlEs3DistortionRenderer::SetMesh");
-    elements_count_[eye] = mesh->n_indices;
+    CARDBOARD_CHECK_GL_ERROR("OpenGlEs3DistortionRenderer::SetMesh");
+    elements_count_[eye] = triangle_list.indices.size();
+
+    SetStereoMesh(triangle_list, eye);
+  }
+
+  /*
+   * Modifies the OpenGL global state. In particular:
+   *   - glGet(GL_VERTEX_ARRAY_BINDING)
+   *   - glGet(GL_ARRAY_BUFFER_BINDING)
+   */
+  void SetEyeTextureLayout(CardboardEyeTextureLayout layout) override {
+    if (layout == kEyeTextureLayoutSideBySide && stereo_program_ == 0) {
+      stereo_program_ = CreateProgram(kDistortionVertexShader,
+                                      kStereoDistortionFragmentShader);
+      stereo_uniforms_ = GetDistortionUniforms(stereo_program_);
+      CARDBOARD_CHECK_GL_ERROR(
+          "OpenGlEs3DistortionRenderer::SetEyeTextureLayout");
+    }
+    if (layout == kEyeTextureLayoutArray && array_program_ == 0) {
+      array_program_ = CreateProgram(kDistortionVertexShader,
+                                     kArrayDistortionFragmentShader);
+      array_uniforms_ = GetDistortionUniforms(array_program_);
+      CARDBOARD_CHECK_GL_ERROR(
+          "OpenGlEs3DistortionRenderer::SetEyeTextureLayout");
+    }
+    eye_texture_layout_ = layout;
+    if (layout != kEyeTextureLayoutSeparate && stereo_elements_count_ == 0) {
+      UploadStereoMesh();
+    }
   }
 
   /*
@@ -202,13 +387,14 @@ class OpenGlEs3DistortionRenderer : public DistortionRenderer {
    *   - glGet(GL_CURRENT_PROGRAM)
    *   - glGet(GL_SCISSOR_BOX)
    *   - glGet(GL_ACTIVE_TEXTURE+i)
-   *   - glGet(GL_ARRAY_BUFFER_BINDING)
-   *   - glGet(GL_ELEMENT_ARRAY_BUFFER_BINDING)
+   *   - glGet(GL_VERTEX_ARRAY_BINDING)
    */
   void RenderEyeToDisplay(
       int target_display, int x, int y, int width, int height,
       const CardboardEyeTextureDescription* left_eye,
       const CardboardEyeTextureDescription* right_eye) const override {
+    CARDBOARD_TRACE_SCOPE("DistortionRenderer::RenderEyeToDisplay");
+    Metrics::ScopedTimer submit_timer(Metrics::Timing::kDistortionSubmit);
     if (elements_count_[0] == 0 || elements_count_[1] == 0) {
       CARDBOARD_LOGE(
           "Distortion mesh is empty. OpenGlEs3DistortionRenderer::SetMesh was "
@@ -223,83 +409,237 @@ class OpenGlEs3DistortionRenderer : public DistortionRenderer {
     glClearColor(.0f, .0f, .0f, 1.0f);
     glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
 
-    glUseProgram(program_);
-
-    glEnable(GL_SCISSOR_TEST);
-    glScissor(x, y, width / 2, height);
-    RenderDistortionMesh(left_eye, kLeft);
-
-    glScissor(x + width / 2, y, width / 2, height);
-    RenderDistortionMesh(right_eye, kRight);
+    // Queries the head tracker as late as possible.
+    const std::array<GLfloat, kMatrix3x3Components> reprojection =
+        reprojection_.LatchRotation();
+    switch (eye_texture_layout_) {
+      case kEyeTextureLayoutSeparate:
+      default:
+        glUseProgram(program_);
+        UpdateUniforms(left_eye, right_eye, reprojection, &uniforms_);
+
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(x, y, width / 2, height);
+        RenderDistortionMesh(left_eye, kLeft);
+
+        glScissor(x + width / 2, y, width / 2, height);
+        RenderDistortionMesh(right_eye, kRight);
+        break;
+      case kEyeTextureLayoutSideBySide:
+        glUseProgram(stereo_program_);
+        UpdateUniforms(left_eye, right_eye, reprojection, &stereo_uniforms_);
+        RenderStereoDistortionMesh(left_eye, GL_TEXTURE_2D);
+        break;
+      case kEyeTextureLayoutArray:
+        glUseProgram(array_program_);
+        UpdateUniforms(left_eye, right_eye, reprojection, &array_uniforms_);
+        RenderStereoDistortionMesh(left_eye, GL_TEXTURE_2D_ARRAY);
+        break;
+    }
 
     // Active GL_TEXTURE0 effectively enables the first texture that is
-    // deactiviated by the DistortionRenderer. Binding array buffer and element
-    // array buffer to the reserved value zero effectively unbinds the buffer
-    // objects that are previously bound by the DistortionRenderer.
+    // deactiviated by the DistortionRenderer. Binding the vertex array to the
+    // reserved value zero effectively unbinds the vertex array object that is
+    // previously bound by the DistortionRenderer.
     glActiveTexture(GL_TEXTURE0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
 
     // Disable scissor test.
     glDisable(GL_SCISSOR_TEST);
-    CheckGlError("OpenGlEs3DistortionRenderer::RenderEyeToDisplay");
+    CARDBOARD_CHECK_GL_ERROR("OpenGlEs3DistortionRenderer::RenderEyeToDisplay");
   }
 
  private:
   /*
    * Modifies the OpenGL global state. In particular:
-   *   - glGet(GL_ARRAY_BUFFER_BINDING)
-   *   - glGet(GL_ELEMENT_ARRAY_BUFFER_BINDING)
-   *   - glGetVertexAttrib(i, GL_VERTEX_ATTRIB_*)
-   *   - glGetVertextAttrib(i, GL_VERTEX_ATTRIB_ARRAY_ENABLED)
+   *   - glGetUniform(program, location)
+   */
+  void UpdateUniforms(
+      const CardboardEyeTextureDescription* left_eye,
+      const CardboardEyeTextureDescription* right_eye,
+      const std::array<GLfloat, kMatrix3x3Components>& reprojection,
+      DistortionUniforms* uniforms) const {
+    // Eye and tan-angle rectangles rarely change between frames. The
+    // reprojection only changes while it is enabled.
+    const std::array<GLfloat, kEyeRectsComponents> eye_rects = {
+        left_eye->left_u,   left_eye->bottom_v,  left_eye->right_u,
+        left_eye->top_v,    right_eye->left_u,   right_eye->bottom_v,
+        right_eye->right_u, right_eye->top_v};
+    if (UpdateCachedValues(eye_rects, &uniforms->eye_rects_values)) {
+      glUniform4fv(uniforms->eye_rects, 2, eye_rects.data());
+    }
+
+    const std::array<float, 4> left = reprojection_.GetTanAngleRect(kLeft);
+    const std::array<float, 4> right = reprojection_.GetTanAngleRect(kRight);
+    const std::array<GLfloat, kEyeRectsComponents> tan_angle_rects = {
+        left[0],  left[1],  left[2],  left[3],
+        right[0], right[1], right[2], right[3]};
+    if (UpdateCachedValues(tan_angle_rects,
+                           &uniforms->tan_angle_rects_values)) {
+      glUniform4fv(uniforms->tan_angle_rects, 2, tan_angle_rects.data());
+    }
+
+    if (UpdateCachedValues(reprojection, &uniforms->reprojection_values)) {
+      glUniformMatrix3fv(uniforms->reprojection, 1, GL_FALSE,
+                         reprojection.data());
+    }
+  }
+
+  /*
+   * Modifies the OpenGL global state. In particular:
+   *   - glGet(GL_VERTEX_ARRAY_BINDING)
    *   - glGet(GL_ACTIVE_TEXTURE+i)
    *   - glGet(GL_TEXTURE_BINDING_2D)
-   *   - glGetUniform(program, location)
-   *   - glGet(GL_ARRAY_BUFFER_BINDING)
-   *   - glGet(GL_ELEMENT_ARRAY_BUFFER_BINDING)
    */
   void RenderDistortionMesh(
       const CardboardEyeTextureDescription* eye_description,
       CardboardEye eye) const {
-    glBindBuffer(GL_ARRAY_BUFFER, vertices_vbo_[eye]);
-    glVertexAttribPointer(
-        attrib_pos_,
-        2,  // 2 components per vertex
-        GL_FLOAT, false,
-        0,  // Stride and offset 0, as we are using different vbos.
-        0);
-    glEnableVertexAttribArray(attrib_pos_);
-
-    glBindBuffer(GL_ARRAY_BUFFER, uvs_vbo_[eye]);
-    glVertexAttribPointer(attrib_tex_,
-                          2,  // 2 components per uv
-                          GL_FLOAT, false, 0, 0);
-    glEnableVertexAttribArray(attrib_tex_);
+    glBindVertexArray(vaos_[eye]);
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, eye_description->texture);
 
-    glUniform2f(uniform_start_, eye_description->left_u,
-                eye_description->bottom_v);
-    glUniform2f(uniform_end_, eye_description->right_u, eye_description->top_v);
-
     // Draw with indices
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elements_vbo_[eye]);
-    glDrawElements(GL_TRIANGLE_STRIP, elements_count_[eye], GL_UNSIGNED_INT, 0);
-    CheckGlError("OpenGlEs3DistortionRenderer::RenderDistortionMesh");
+    glDrawElements(GL_TRIANGLES, elements_count_[eye], GL_UNSIGNED_INT, 0);
+    CARDBOARD_CHECK_GL_ERROR(
+        "OpenGlEs3DistortionRenderer::RenderDistortionMesh");
+  }
+
+  /*
+   * Modifies the OpenGL global state. In particular:
+   *   - glGet(GL_VERTEX_ARRAY_BINDING)
+   *   - glGet(GL_ACTIVE_TEXTURE+i)
+   *   - glGet(GL_TEXTURE_BINDING_2D)
+   *   - glGet(GL_TEXTURE_BINDING_2D_ARRAY)
+   */
+  void RenderStereoDistortionMesh(
+      const CardboardEyeTextureDescription* left_eye,
+      GLenum texture_target) const {
+    glBindVertexArray(stereo_vao_);
+
+    // Both eyes sample the left eye texture.
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(texture_target, left_eye->texture);
+
+    glDrawElements(GL_TRIANGLES, stereo_elements_count_, GL_UNSIGNED_INT, 0);
+    CARDBOARD_CHECK_GL_ERROR(
+        "OpenGlEs3DistortionRenderer::RenderStereoDistortionMesh");
+  }
+
+  /*
+   * Modifies the OpenGL global state. In particular:
+   *   - glGet(GL_VERTEX_ARRAY_BINDING)
+   *   - glGet(GL_ARRAY_BUFFER_BINDING)
+   */
+  void SetStereoMesh(const TriangleListMesh& mesh, CardboardEye eye) {
+    // Keeps an interleaved copy of the eye mesh. The fragment shader discards
+    // the fragments on the other eye half of the display, which replaces the
+    // per eye scissor.
+    std::vector<float>& vertices = stereo_mesh_vertices_[eye];
+    const int vertex_count = mesh.vertices.size() / 2;
+    vertices.resize(vertex_count * kStereoVertexComponents);
+    for (int i = 0; i < vertex_count; ++i) {
+      float* vertex = &vertices[i * kStereoVertexComponents];
+      vertex[0] = mesh.vertices[2 * i];
+      vertex[1] = mesh.vertices[2 * i + 1];
+      vertex[2] = mesh.uvs[2 * i];
+      vertex[3] = mesh.uvs[2 * i + 1];
+      vertex[4] = static_cast<float>(eye);
+    }
+    stereo_mesh_indices_[eye] = mesh.indices;
+    stereo_elements_count_ = 0;
+
+    // The merged mesh is only uploaded for the single draw layouts.
+    if (eye_texture_layout_ != kEyeTextureLayoutSeparate) {
+      UploadStereoMesh();
+    }
+  }
+
+  /*
+   * Modifies the OpenGL global state. In particular:
+   *   - glGet(GL_VERTEX_ARRAY_BINDING)
+   *   - glGet(GL_ARRAY_BUFFER_BINDING)
+   */
+  void UploadStereoMesh() {
+    const std::vector<int>& left_indices = stereo_mesh_indices_[kLeft];
+    const std::vector<int>& right_indices = stereo_mesh_indices_[kRight];
+    if (left_indices.empty() || right_indices.empty()) {
+      return;
+    }
+
+    // Appends the right triangle list to the left one.
+    const int right_offset =
+        stereo_mesh_vertices_[kLeft].size() / kStereoVertexComponents;
+    std::vector<int> indices(left_indices);
+    indices.reserve(left_indices.size() + right_indices.size());
+    for (int index : right_indices) {
+      indices.push_back(index + right_offset);
+    }
+
+    glBindVertexArray(stereo_vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, stereo_vertices_vbo_);
+    glBufferData(GL_ARRAY_BUFFER,
+                 (stereo_mesh_vertices_[kLeft].size() +
+                  stereo_mesh_vertices_[kRight].size()) *
+                     sizeof(float),
+                 nullptr, GL_STATIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0,
+                    stereo_mesh_vertices_[kLeft].size() * sizeof(float),
+                    stereo_mesh_vertices_[kLeft].data());
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    stereo_mesh_vertices_[kLeft].size() * sizeof(float),
+                    stereo_mesh_vertices_[kRight].size() * sizeof(float),
+                    stereo_mesh_vertices_[kRight].data());
+    constexpr GLsizei kStride = kStereoVertexComponents * sizeof(float);
+    glVertexAttribPointer(kAttribPos, 2, GL_FLOAT, false, kStride,
+                          reinterpret_cast<const void*>(0));
+    glEnableVertexAttribArray(kAttribPos);
+    glVertexAttribPointer(kAttribTex, 2, GL_FLOAT, false, kStride,
+                          reinterpret_cast<const void*>(2 * sizeof(float)));
+    glEnableVertexAttribArray(kAttribTex);
+    glVertexAttribPointer(kAttribEye, 1, GL_FLOAT, false, kStride,
+                          reinterpret_cast<const void*>(4 * sizeof(float)));
+    glEnableVertexAttribArray(kAttribEye);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, stereo_elements_vbo_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(int),
+                 indices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    CARDBOARD_CHECK_GL_ERROR("OpenGlEs3DistortionRenderer::UploadStereoMesh");
+    stereo_elements_count_ = indices.size();
   }
 
   std::array<GLuint, 2> vertices_vbo_;  // One per eye.
   std::array<GLuint, 2> uvs_vbo_;
   std::array<GLuint, 2> elements_vbo_;
   std::array<int, 2> elements_count_;
-
+  std::array<GLuint, 2> vaos_;
+  // Eye index of each per eye vertex array.
+  GLuint eye_vbo_;
+
+  // Merged mesh of both eyes, used by the single draw layouts.
+  std::array<std::vector<float>, 2> stereo_mesh_vertices_;
+  std::array<std::vector<int>, 2> stereo_mesh_indices_;
+  GLuint stereo_vertices_vbo_;
+  GLuint stereo_elements_vbo_;
+  int stereo_elements_count_;
+  GLuint stereo_vao_;
+
+  // Renders the separate layout.
   GLuint program_;
-  GLuint attrib_pos_;
-  GLuint attrib_tex_;
-  GLuint uniform_start_;
-  GLuint uniform_end_;
+  mutable DistortionUniforms uniforms_;
+
+  // Renders the side-by-side layout.
+  GLuint stereo_program_;
+  mutable DistortionUniforms stereo_uniforms_;
+
+  // Renders the texture array layout.
+  GLuint array_program_;
+  mutable DistortionUniforms array_uniforms_;
+
+  CardboardEyeTextureLayout eye_texture_layout_;
 };
 
 }  // namespace rendering
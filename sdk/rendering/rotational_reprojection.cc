@@ -0,0 +1,133 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "rendering/rotational_reprojection.h"
+
+#include <cmath>
+
+#include "util/matrix_3x3.h"
+#include "util/matrixutils.h"
+#include "util/rotation.h"
+
+namespace cardboard {
+namespace rendering {
+
+namespace {
+
+constexpr std::array<float, 4> kIdentityTanAngleRect = {0.0f, 0.0f, 1.0f,
+                                                         1.0f};
+constexpr std::array<float, 9> kIdentityRotation = {1.0f, 0.0f, 0.0f,
+                                                     0.0f, 1.0f, 0.0f,
+                                                     0.0f, 0.0f, 1.0f};
+
+std::array<float, 4> ComputeTanAngleRect(const std::array<float, 4>& fov) {
+  const float tan_left = std::tan(fov[0]);
+  const float tan_bottom = std::tan(fov[2]);
+  return {tan_left, tan_bottom, tan_left + std::tan(fov[1]),
+          tan_bottom + std::tan(fov[3])};
+}
+
+// Returns the rotation matrix of a head orientation, which maps world
+// directions to head directions.
+Matrix3x3 GetHeadFromWorldMatrix(const std::array<float, 4>& orientation) {
+  return RotationMatrixNH(Rotation::FromQuaternion(Rotation::QuaternionType(
+      orientation[0], orientation[1], orientation[2], orientation[3])));
+}
+
+}  // namespace
+
+RotationalReprojection::RotationalReprojection()
+    : head_tracker_(nullptr),
+      tan_angle_rects_{kIdentityTanAngleRect, kIdentityTanAngleRect},
+      has_render_pose_(false),
+      display_timestamp_ns_(0),
+      render_orientation_{0.0f, 0.0f, 0.0f, 1.0f} {}
+
+void RotationalReprojection::Enable(const HeadTracker* head_tracker,
+                                    const std::array<float, 4>& left_fov,
+                                    const std::array<float, 4>& right_fov) {
+  head_tracker_ = head_tracker;
+  tan_angle_rects_[kLeft] = ComputeTanAngleRect(left_fov);
+  tan_angle_rects_[kRight] = ComputeTanAngleRect(right_fov);
+}
+
+void RotationalReprojection::Disable() {
+  head_tracker_ = nullptr;
+  tan_angle_rects_ = {kIdentityTanAngleRect, kIdentityTanAngleRect};
+}
+
+void RotationalReprojection::SetRenderPose(
+    int64_t timestamp_ns, const std::array<float, 4>& orientation) {
+  has_render_pose_ = true;
+  display_timestamp_ns_ = timestamp_ns;
+  render_orientation_ = orientation;
+}
+
+void RotationalReprojection::SetDisplayTimestamp(int64_t timestamp_ns) {
+  display_timestamp_ns_ = timestamp_ns;
+}
+
+std::array<float, 4> RotationalReprojection::GetTanAngleRect(
+    CardboardEye eye) const {
+  return tan_angle_rects_[eye];
+}
+
+std::array<float, 9> RotationalReprojection::LatchRotation() const {
+  if (head_tracker_ == nullptr || !has_render_pose_) {
+    return kIdentityRotation;
+  }
+  std::array<float, 3> latest_position;
+  std::array<float, 4> latest_orientation;
+  head_tracker_->GetPose(display_timestamp_ns_, latest_position,
+                         latest_orientation);
+  return GetRenderFromLatestRotation(render_orientation_, latest_orientation);
+}
+
+std::array<float, 9> RotationalReprojection::GetRenderFromLatestRotation(
+    const std::array<float, 4>& render_orientation,
+    const std::array<float, 4>& latest_orientation) {
+  // render_from_latest = render_from_world * world_from_latest.
+  const Matrix3x3 render_from_latest =
+      GetHeadFromWorldMatrix(render_orientation) *
+      Transpose(GetHeadFromWorldMatrix(latest_orientation));
+  std::array<float, 9> rotation;
+  for (int col = 0; col < 3; ++col) {
+    for (int row = 0; row < 3; ++row) {
+      rotation[col * 3 + row] =
+          static_cast<float>(render_from_latest(row, col));
+    }
+  }
+  return rotation;
+}
+
+std::array<float, 2> RotationalReprojection::ReprojectUv(
+    const std::array<float, 9>& rotation,
+    const std::array<float, 4>& tan_angle_rect,
+    const std::array<float, 2>& uv) {
+  const float tan_angle_x = uv[0] * tan_angle_rect[2] - tan_angle_rect[0];
+  const float tan_angle_y = uv[1] * tan_angle_rect[3] - tan_angle_rect[1];
+  // Column-major product with (tan_angle_x, tan_angle_y, -1).
+  const float x =
+      rotation[0] * tan_angle_x + rotation[3] * tan_angle_y - rotation[6];
+  const float y =
+      rotation[1] * tan_angle_x + rotation[4] * tan_angle_y - rotation[7];
+  const float z =
+      rotation[2] * tan_angle_x + rotation[5] * tan_angle_y - rotation[8];
+  return {(x / -z + tan_angle_rect[0]) / tan_angle_rect[2],
+          (y / -z + tan_angle_rect[1]) / tan_angle_rect[3]};
+}
+
+}  // namespace rendering
+}  // namespace cardboard
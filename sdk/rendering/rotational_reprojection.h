@@ -0,0 +1,123 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_RENDERING_ROTATIONAL_REPROJECTION_H_
+#define CARDBOARD_SDK_RENDERING_ROTATIONAL_REPROJECTION_H_
+
+#include <array>
+#include <cstdint>
+
+#include "head_tracker.h"
+#include "include/cardboard.h"
+
+namespace cardboard {
+namespace rendering {
+
+// Late-latched rotational reprojection of the eye textures.
+//
+// Eye textures are rendered with a head pose predicted for some display time.
+// Right before the distortion pass, the head tracker is queried again for the
+// same time. Its newer sensor data gives a better prediction. The distortion
+// vertex shaders then sample each eye texture along the directions seen from
+// the newer pose:
+//
+//   tan_angle = uv * rect.zw - rect.xy
+//   direction = rotation * vec3(tan_angle, -1)
+//   uv' = (direction.xy / -direction.z + rect.xy) / rect.zw
+//
+// where rect is the eye tan-angle rectangle and rotation maps the latest head
+// frame to the head frame the eye textures were rendered with. The mapping is
+// evaluated per vertex of the distortion mesh, and the GPU interpolates it
+// linearly in between.
+class RotationalReprojection {
+ public:
+  RotationalReprojection();
+
+  // Enables the reprojection.
+  //
+  // @param head_tracker head tracker to query. It must outlive the
+  //     reprojection or be replaced before it is destroyed.
+  // @param left_fov left eye field of view angles in radians: left, right,
+  //     bottom and top.
+  // @param right_fov right eye field of view angles in radians.
+  void Enable(const HeadTracker* head_tracker,
+              const std::array<float, 4>& left_fov,
+              const std::array<float, 4>& right_fov);
+
+  // Disables the reprojection.
+  void Disable();
+
+  // Sets the head pose the eye textures were rendered with. It applies to all
+  // subsequent renders until it is set again. It also resets the display
+  // timestamp to timestamp_ns.
+  //
+  // @param timestamp_ns timestamp the head pose was predicted for.
+  // @param orientation head orientation quaternion: x, y, z and w.
+  void SetRenderPose(int64_t timestamp_ns,
+                     const std::array<float, 4>& orientation);
+
+  // Sets the timestamp the head tracker is queried for, when the eye textures
+  // are displayed later than their render pose was predicted for. This is the
+  // case when a compositor presents them again on a missed frame.
+  //
+  // @param timestamp_ns predicted display timestamp.
+  void SetDisplayTimestamp(int64_t timestamp_ns);
+
+  // Returns the tan-angle rectangle of an eye texture, packed as
+  // (tan(left), tan(bottom), tan(left) + tan(right), tan(bottom) + tan(top)).
+  // It is (0, 0, 1, 1) when the reprojection is disabled, which makes the
+  // shader mapping an exact identity.
+  //
+  // @param eye desired eye.
+  std::array<float, 4> GetTanAngleRect(CardboardEye eye) const;
+
+  // Queries the head tracker and returns the column-major rotation from the
+  // latest head frame to the render head frame. It is the identity when the
+  // reprojection is disabled or no render pose was set.
+  std::array<float, 9> LatchRotation() const;
+
+  // Returns the column-major rotation from the latest head frame to the
+  // render head frame, as LatchRotation() does.
+  //
+  // @param render_orientation head orientation quaternion the eye textures
+  //     were rendered with: x, y, z and w.
+  // @param latest_orientation latest head orientation quaternion.
+  static std::array<float, 9> GetRenderFromLatestRotation(
+      const std::array<float, 4>& render_orientation,
+      const std::array<float, 4>& latest_orientation);
+
+  // Reprojects an eye mesh UV coordinate, as the distortion vertex shaders do.
+  //
+  // @param rotation column-major rotation returned by LatchRotation().
+  // @param tan_angle_rect rectangle returned by GetTanAngleRect().
+  // @param uv eye mesh UV coordinate.
+  // @return UV coordinate to sample in the eye texture.
+  static std::array<float, 2> ReprojectUv(
+      const std::array<float, 9>& rotation,
+      const std::array<float, 4>& tan_angle_rect,
+      const std::array<float, 2>& uv);
+
+ private:
+  const HeadTracker* head_tracker_;
+  std::array<std::array<float, 4>, 2> tan_angle_rects_;
+  bool has_render_pose_;
+  int64_t display_timestamp_ns_;
+  std::array<float, 4> render_orientation_;
+};
+
+}  // namespace rendering
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_RENDERING_ROTATIONAL_REPROJECTION_H_
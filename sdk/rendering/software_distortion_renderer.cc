@@ -0,0 +1,633 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "rendering/software_distortion_renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "util/is_arg_null.h"
+#include "util/is_initialized.h"
+#include "util/logging.h"
+#include "util/metrics.h"
+#include "util/simd_math.h"
+#include "util/trace.h"
+
+namespace {
+
+// Four adjacent pixels of a row are processed at once: their edge values,
+// texel coordinates and texel addresses are computed in vector lanes. Texels
+// are then fetched per pixel and filtered with the RGBA channels in lanes.
+// Every operation matches the scalar fallback, so both produce the same
+// pixels. ARMv7 NEON flushes denormals to zero, unlike the scalar VFP code,
+// but edge values and texel coordinates are sums of products of normal
+// values in the pixel range, which are either zero or normal.
+#if defined(CARDBOARD_SIMD_NEON)
+
+typedef float32x4_t Lanes;
+typedef uint32x4_t LaneMask;
+
+inline Lanes Splat(float value) { return vdupq_n_f32(value); }
+inline Lanes LaneOffsets() { return Lanes{0.0f, 1.0f, 2.0f, 3.0f}; }
+inline Lanes Add(Lanes a, Lanes b) { return vaddq_f32(a, b); }
+inline Lanes Sub(Lanes a, Lanes b) { return vsubq_f32(a, b); }
+inline Lanes Mul(Lanes a, Lanes b) { return vmulq_f32(a, b); }
+// a > b ? a : b, which is b when a is NaN.
+inline Lanes Max(Lanes a, Lanes b) { return vbslq_f32(vcgtq_f32(a, b), a, b); }
+// a < b ? a : b, which is b when a is NaN.
+inline Lanes Min(Lanes a, Lanes b) { return vbslq_f32(vcltq_f32(a, b), a, b); }
+inline Lanes Floor(Lanes a) {
+  const Lanes truncated = vcvtq_f32_s32(vcvtq_s32_f32(a));
+  return vsubq_f32(truncated,
+                   vbslq_f32(vcgtq_f32(truncated, a), vdupq_n_f32(1.0f),
+                             vdupq_n_f32(0.0f)));
+}
+inline void StoreInt(Lanes a, int32_t* out) {
+  vst1q_s32(out, vcvtq_s32_f32(a));
+}
+inline void Store(Lanes a, float* out) { vst1q_f32(out, a); }
+inline LaneMask Covers(Lanes edge, bool is_top_left) {
+  return is_top_left ? vcgeq_f32(edge, vdupq_n_f32(0.0f))
+                     : vcgtq_f32(edge, vdupq_n_f32(0.0f));
+}
+inline LaneMask And(LaneMask a, LaneMask b) { return vandq_u32(a, b); }
+// Returns the lane mask as bits, lane i being bit i.
+inline int MaskBits(LaneMask mask) {
+  const uint32x4_t bits = vandq_u32(mask, uint32x4_t{1, 2, 4, 8});
+  const uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+  return static_cast<int>(vget_lane_u32(vpadd_u32(sum, sum), 0));
+}
+
+// Bilinear filter of four RGBA8 texels, rounding half up.
+inline uint32_t Filter(uint32_t p00, uint32_t p10, uint32_t p01, uint32_t p11,
+                       float fx, float fy) {
+  const auto to_lanes = [](uint32_t pixel) {
+    const uint16x8_t wide = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(pixel)));
+    return vcvtq_f32_u32(vmovl_u16(vget_low_u16(wide)));
+  };
+  const Lanes c00 = to_lanes(p00);
+  const Lanes c01 = to_lanes(p01);
+  const Lanes bottom = vaddq_f32(
+      c00, vmulq_f32(vdupq_n_f32(fx), vsubq_f32(to_lanes(p10), c00)));
+  const Lanes top = vaddq_f32(
+      c01, vmulq_f32(vdupq_n_f32(fx), vsubq_f32(to_lanes(p11), c01)));
+  const Lanes result = vaddq_f32(
+      vaddq_f32(bottom, vmulq_f32(vdupq_n_f32(fy), vsubq_f32(top, bottom))),
+      vdupq_n_f32(0.5f));
+  const uint16x4_t narrow = vmovn_u32(vcvtq_u32_f32(result));
+  const uint8x8_t bytes = vmovn_u16(vcombine_u16(narrow, narrow));
+  return vget_lane_u32(vreinterpret_u32_u8(bytes), 0);
+}
+
+#elif defined(CARDBOARD_SIMD_SSE2)
+
+typedef __m128 Lanes;
+typedef __m128 LaneMask;
+
+inline Lanes Splat(float value) { return _mm_set1_ps(value); }
+inline Lanes LaneOffsets() { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+inline Lanes Add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+inline Lanes Sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+inline Lanes Mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+// a > b ? a : b, which is b when a is NaN.
+inline Lanes Max(Lanes a, Lanes b) { return _mm_max_ps(a, b); }
+// a < b ? a : b, which is b when a is NaN.
+inline Lanes Min(Lanes a, Lanes b) { return _mm_min_ps(a, b); }
+inline Lanes Floor(Lanes a) {
+  const Lanes truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+  return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a),
+                                          _mm_set1_ps(1.0f)));
+}
+inline void StoreInt(Lanes a, int32_t* out) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_cvttps_epi32(a));
+}
+inline void Store(Lanes a, float* out) { _mm_storeu_ps(out, a); }
+inline LaneMask Covers(Lanes edge, bool is_top_left) {
+  return is_top_left ? _mm_cmpge_ps(edge, _mm_setzero_ps())
+                     : _mm_cmpgt_ps(edge, _mm_setzero_ps());
+}
+inline LaneMask And(LaneMask a, LaneMask b) { return _mm_and_ps(a, b); }
+// Returns the lane mask as bits, lane i being bit i.
+inline int MaskBits(LaneMask mask) { return _mm_movemask_ps(mask); }
+
+// Bilinear filter of four RGBA8 texels, rounding half up.
+inline uint32_t Filter(uint32_t p00, uint32_t p10, uint32_t p01, uint32_t p11,
+                       float fx, float fy) {
+  const __m128i zero = _mm_setzero_si128();
+  const auto to_lanes = [zero](uint32_t pixel) {
+    const __m128i bytes = _mm_cvtsi32_si128(static_cast<int>(pixel));
+    return _mm_cvtepi32_ps(
+        _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+  };
+  const Lanes c00 = to_lanes(p00);
+  const Lanes c01 = to_lanes(p01);
+  const Lanes bottom = _mm_add_ps(
+      c00, _mm_mul_ps(_mm_set1_ps(fx), _mm_sub_ps(to_lanes(p10), c00)));
+  const Lanes top = _mm_add_ps(
+      c01, _mm_mul_ps(_mm_set1_ps(fx), _mm_sub_ps(to_lanes(p11), c01)));
+  const Lanes result = _mm_add_ps(
+      _mm_add_ps(bottom, _mm_mul_ps(_mm_set1_ps(fy), _mm_sub_ps(top, bottom))),
+      _mm_set1_ps(0.5f));
+  const __m128i words = _mm_packs_epi32(_mm_cvttps_epi32(result), zero);
+  return static_cast<uint32_t>(
+      _mm_cvtsi128_si32(_mm_packus_epi16(words, zero)));
+}
+
+#else
+
+struct Lanes {
+  float v[4];
+};
+typedef int LaneMask;
+
+inline Lanes Splat(float value) { return Lanes{{value, value, value, value}}; }
+inline Lanes LaneOffsets() { return Lanes{{0.0f, 1.0f, 2.0f, 3.0f}}; }
+template <typename Op>
+inline Lanes Apply(Lanes a, Lanes b, Op op) {
+  for (int i = 0; i < 4; ++i) {
+    a.v[i] = op(a.v[i], b.v[i]);
+  }
+  return a;
+}
+inline Lanes Add(Lanes a, Lanes b) {
+  return Apply(a, b, [](float l, float r) { return l + r; });
+}
+inline Lanes Sub(Lanes a, Lanes b) {
+  return Apply(a, b, [](float l, float r) { return l - r; });
+}
+inline Lanes Mul(Lanes a, Lanes b) {
+  return Apply(a, b, [](float l, float r) { return l * r; });
+}
+// a > b ? a : b, which is b when a is NaN.
+inline Lanes Max(Lanes a, Lanes b) {
+  return Apply(a, b, [](float l, float r) { return l > r ? l : r; });
+}
+// a < b ? a : b, which is b when a is NaN.
+inline Lanes Min(Lanes a, Lanes b) {
+  return Apply(a, b, [](float l, float r) { return l < r ? l : r; });
+}
+inline Lanes Floor(Lanes a) {
+  for (float& value : a.v) {
+    const float truncated = static_cast<float>(static_cast<int32_t>(value));
+    value = truncated > value ? truncated - 1.0f : truncated;
+  }
+  return a;
+}
+inline void StoreInt(Lanes a, int32_t* out) {
+  for (int i = 0; i < 4; ++i) {
+    out[i] = static_cast<int32_t>(a.v[i]);
+  }
+}
+inline void Store(Lanes a, float* out) { std::memcpy(out, a.v, sizeof(a.v)); }
+inline LaneMask Covers(Lanes edge, bool is_top_left) {
+  LaneMask mask = 0;
+  for (int i = 0; i < 4; ++i) {
+    if (is_top_left ? edge.v[i] >= 0.0f : edge.v[i] > 0.0f) {
+      mask |= 1 << i;
+    }
+  }
+  return mask;
+}
+inline LaneMask And(LaneMask a, LaneMask b) { return a & b; }
+// Returns the lane mask as bits, lane i being bit i.
+inline int MaskBits(LaneMask mask) { return mask; }
+
+// Bilinear filter of four RGBA8 texels, rounding half up.
+inline uint32_t Filter(uint32_t p00, uint32_t p10, uint32_t p01, uint32_t p11,
+                       float fx, float fy) {
+  uint8_t c00[4], c10[4], c01[4], c11[4], result[4];
+  std::memcpy(c00, &p00, 4);
+  std::memcpy(c10, &p10, 4);
+  std::memcpy(c01, &p01, 4);
+  std::memcpy(c11, &p11, 4);
+  for (int i = 0; i < 4; ++i) {
+    const float bottom = c00[i] + fx * (static_cast<float>(c10[i]) - c00[i]);
+    const float top = c01[i] + fx * (static_cast<float>(c11[i]) - c01[i]);
+    result[i] = static_cast<uint8_t>(bottom + fy * (top - bottom) + 0.5f);
+  }
+  uint32_t pixel;
+  std::memcpy(&pixel, result, 4);
+  return pixel;
+}
+
+#endif
+
+// Size of the square tiles rendered in parallel.
+constexpr int kTileSize = 64;
+
+// Opaque black pixels filling a tile row.
+const std::array<uint8_t, 4 * kTileSize> kClearRow = [] {
+  std::array<uint8_t, 4 * kTileSize> row{};
+  for (size_t i = 3; i < row.size(); i += 4) {
+    row[i] = 255;
+  }
+  return row;
+}();
+
+// Clamps a texel index to [0, size - 1].
+inline int Clamp(int index, int size) {
+  return std::min(std::max(index, 0), size - 1);
+}
+
+inline uint32_t LoadPixel(const uint8_t* row, int x) {
+  uint32_t pixel;
+  std::memcpy(&pixel, row + 4 * x, 4);
+  return pixel;
+}
+
+}  // namespace
+
+namespace cardboard {
+namespace rendering {
+
+SoftwareDistortionRenderer::SoftwareDistortionRenderer(int thread_count)
+    : eye_texture_layout_(kEyeTextureLayoutSeparate),
+      target_image_{nullptr, 0, 0, 0},
+      thread_pool_(thread_count),
+      tile_columns_(0) {}
+
+void SoftwareDistortionRenderer::SetMesh(const CardboardMesh* mesh,
+                                         CardboardEye eye) {
+  meshes_[eye] = OptimizeDistortionMesh(*mesh, eye);
+}
+
+void SoftwareDistortionRenderer::SetEyeTextureLayout(
+    CardboardEyeTextureLayout layout) {
+  if (layout == kEyeTextureLayoutArray) {
+    CARDBOARD_LOGE(
+        "Texture arrays are not supported by SoftwareDistortionRenderer.");
+    return;
+  }
+  eye_texture_layout_ = layout;
+}
+
+void SoftwareDistortionRenderer::SetTargetImage(
+    const CardboardSoftwareImage& image) {
+  target_image_ = image;
+}
+
+void SoftwareDistortionRenderer::RenderEyeToDisplay(
+    int /*target_display*/, int /*x*/, int /*y*/, int /*width*/,
+    int /*height*/, const CardboardEyeTextureDescription* /*left_eye*/,
+    const CardboardEyeTextureDescription* /*right_eye*/) const {
+  CARDBOARD_LOGE(
+      "SoftwareDistortionRenderer renders CPU images. Use "
+      "CardboardSoftwareDistortionRenderer_renderEyeToDisplay instead.");
+}
+
+void SoftwareDistortionRenderer::RenderEyeImages(
+    int x, int y, int width, int height,
+    const CardboardSoftwareEyeTextureDescription& left_eye,
+    const CardboardSoftwareEyeTextureDescription& right_eye) const {
+  CARDBOARD_TRACE_SCOPE("DistortionRenderer::RenderEyeToDisplay");
+  Metrics::ScopedTimer submit_timer(Metrics::Timing::kDistortionSubmit);
+  if (meshes_[kLeft].indices.empty() || meshes_[kRight].indices.empty()) {
+    CARDBOARD_LOGE(
+        "Distortion mesh is empty. SoftwareDistortionRenderer::SetMesh was "
+        "not called yet.");
+    return;
+  }
+  if (target_image_.pixels == nullptr) {
+    CARDBOARD_LOGE(
+        "Target image is not set. "
+        "SoftwareDistortionRenderer::SetTargetImage was not called yet.");
+    return;
+  }
+  // In the side by side layout, both eyes sample the left eye image.
+  const CardboardSoftwareImage* left_image = left_eye.image;
+  const CardboardSoftwareImage* right_image =
+      eye_texture_layout_ == kEyeTextureLayoutSeparate ? right_eye.image
+                                                       : left_image;
+  if (left_image == nullptr || right_image == nullptr) {
+    CARDBOARD_LOGE("Eye image is not set.");
+    return;
+  }
+
+  // Eyes are scissored to their half of the viewport, like the OpenGL ES
+  // renderers do.
+  const int half_width = width / 2;
+  const auto scissor = [this, y, height](int min_x, int end_x) {
+    return std::array<int, 4>{
+        std::max(min_x, 0), std::max(y, 0),
+        std::min(end_x, target_image_.width),
+        std::min(y + height, target_image_.height)};
+  };
+  triangles_.clear();
+  // Queries the head tracker as late as possible.
+  const std::array<float, 9> rotation = reprojection_.LatchRotation();
+  SetUpEye(kLeft, left_eye, left_image, rotation, x, y, width, height,
+           scissor(x, x + half_width));
+  SetUpEye(kRight, right_eye, right_image, rotation, x, y, width, height,
+           scissor(x + half_width, x + 2 * half_width));
+
+  tile_columns_ = (target_image_.width + kTileSize - 1) / kTileSize;
+  const int tile_rows = (target_image_.height + kTileSize - 1) / kTileSize;
+  tile_triangles_.resize(tile_columns_ * tile_rows);
+  for (std::vector<int>& tile : tile_triangles_) {
+    tile.clear();
+  }
+  for (int i = 0; i < static_cast<int>(triangles_.size()); ++i) {
+    const Triangle& triangle = triangles_[i];
+    for (int row = triangle.min_y / kTileSize;
+         row <= triangle.max_y / kTileSize; ++row) {
+      for (int column = triangle.min_x / kTileSize;
+           column <= triangle.max_x / kTileSize; ++column) {
+        tile_triangles_[row * tile_columns_ + column].push_back(i);
+      }
+    }
+  }
+
+  thread_pool_.ParallelFor(static_cast<int>(tile_triangles_.size()),
+                           [this](int tile) { RenderTile(tile); });
+}
+
+void SoftwareDistortionRenderer::SetUpEye(
+    CardboardEye eye, const CardboardSoftwareEyeTextureDescription& desc,
+    const CardboardSoftwareImage* image, const std::array<float, 9>& rotation,
+    int x, int y, int width, int height,
+    const std::array<int, 4>& scissor) const {
+  const TriangleListMesh& mesh = meshes_[eye];
+  const std::array<float, 4> tan_angle_rect =
+      reprojection_.GetTanAngleRect(eye);
+  const int vertex_count = static_cast<int>(mesh.vertices.size() / 2);
+  screen_vertices_.resize(vertex_count);
+  for (int i = 0; i < vertex_count; ++i) {
+    // Viewport transform of the vertex shader position, and the fragment
+    // shader mapping from u_Start to u_End, moved to texel units.
+    ScreenVertex& vertex = screen_vertices_[i];
+    vertex.x = x + (mesh.vertices[2 * i] + 1.0f) * (0.5f * width);
+    vertex.y = y + (mesh.vertices[2 * i + 1] + 1.0f) * (0.5f * height);
+    const std::array<float, 2> uv = RotationalReprojection::ReprojectUv(
+        rotation, tan_angle_rect, {mesh.uvs[2 * i], mesh.uvs[2 * i + 1]});
+    vertex.s = (desc.left_u + uv[0] * (desc.right_u - desc.left_u)) *
+                   image->width -
+               0.5f;
+    vertex.t = (desc.bottom_v + uv[1] * (desc.top_v - desc.bottom_v)) *
+                   image->height -
+               0.5f;
+  }
+
+  for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+    Triangle triangle;
+    if (SetUpTriangle(screen_vertices_[mesh.indices[i]],
+                      screen_vertices_[mesh.indices[i + 1]],
+                      screen_vertices_[mesh.indices[i + 2]], scissor,
+                      &triangle)) {
+      triangle.image = image;
+      triangles_.push_back(triangle);
+    }
+  }
+}
+
+bool SoftwareDistortionRenderer::SetUpTriangle(
+    const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c,
+    const std::array<int, 4>& scissor, Triangle* triangle) {
+  // Twice the signed area, positive when abc is counterclockwise. Clockwise
+  // triangles, from a flipped viewport, are turned around.
+  const double area =
+      (static_cast<double>(b.x) - a.x) * (static_cast<double>(c.y) - a.y) -
+      (static_cast<double>(b.y) - a.y) * (static_cast<double>(c.x) - a.x);
+  if (area == 0.0) {
+    return false;
+  }
+  const ScreenVertex* vertices[3] = {&a, area > 0.0 ? &b : &c,
+                                     area > 0.0 ? &c : &b};
+
+  const float min_x = std::min({a.x, b.x, c.x});
+  const float min_y = std::min({a.y, b.y, c.y});
+  const float max_x = std::max({a.x, b.x, c.x});
+  const float max_y = std::max({a.y, b.y, c.y});
+  triangle->min_x = std::max(scissor[0], static_cast<int>(std::floor(min_x)));
+  triangle->min_y = std::max(scissor[1], static_cast<int>(std::floor(min_y)));
+  triangle->max_x =
+      std::min(scissor[2] - 1, static_cast<int>(std::ceil(max_x)));
+  triangle->max_y =
+      std::min(scissor[3] - 1, static_cast<int>(std::ceil(max_y)));
+  if (triangle->min_x > triangle->max_x || triangle->min_y > triangle->max_y) {
+    return false;
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    const ScreenVertex& from = *vertices[i];
+    const ScreenVertex& to = *vertices[(i + 1) % 3];
+    // The interior is on the left of the edge direction. Edges going down, or
+    // going left when horizontal, are the top-left ones.
+    const float direction_x = to.x - from.x;
+    const float direction_y = to.y - from.y;
+    const bool is_forward =
+        from.y < to.y || (from.y == to.y && from.x < to.x);
+    const ScreenVertex& start = is_forward ? from : to;
+    const ScreenVertex& end = is_forward ? to : from;
+    const float sign = is_forward ? 1.0f : -1.0f;
+    Edge& edge = triangle->edges[i];
+    edge.x0 = start.x;
+    edge.y0 = start.y;
+    edge.dx = sign * (end.x - start.x);
+    edge.dy = sign * (end.y - start.y);
+    edge.is_top_left =
+        direction_y < 0.0f || (direction_y == 0.0f && direction_x < 0.0f);
+  }
+
+  // Solves the texel coordinate gradients from the two edges leaving the
+  // first vertex.
+  const ScreenVertex& v0 = *vertices[0];
+  const ScreenVertex& v1 = *vertices[1];
+  const ScreenVertex& v2 = *vertices[2];
+  const double e1_x = static_cast<double>(v1.x) - v0.x;
+  const double e1_y = static_cast<double>(v1.y) - v0.y;
+  const double e2_x = static_cast<double>(v2.x) - v0.x;
+  const double e2_y = static_cast<double>(v2.y) - v0.y;
+  const double det = std::abs(area);
+  const auto gradient = [&](double value0, double value1, double value2,
+                            float* d_dx, float* d_dy) {
+    const double delta1 = value1 - value0;
+    const double delta2 = value2 - value0;
+    *d_dx = static_cast<float>((delta1 * e2_y - delta2 * e1_y) / det);
+    *d_dy = static_cast<float>((delta2 * e1_x - delta1 * e2_x) / det);
+  };
+  triangle->x0 = v0.x;
+  triangle->y0 = v0.y;
+  triangle->s0 = v0.s;
+  triangle->t0 = v0.t;
+  gradient(v0.s, v1.s, v2.s, &triangle->s_dx, &triangle->s_dy);
+  gradient(v0.t, v1.t, v2.t, &triangle->t_dx, &triangle->t_dy);
+  return true;
+}
+
+void SoftwareDistortionRenderer::RenderTile(int tile) const {
+  const int tile_x = (tile % tile_columns_) * kTileSize;
+  const int tile_y = (tile / tile_columns_) * kTileSize;
+  const int end_x = std::min(tile_x + kTileSize, target_image_.width);
+  const int end_y = std::min(tile_y + kTileSize, target_image_.height);
+
+  for (int y = tile_y; y < end_y; ++y) {
+    std::memcpy(target_image_.pixels + y * target_image_.stride + 4 * tile_x,
+                kClearRow.data(), 4 * (end_x - tile_x));
+  }
+
+  for (int index : tile_triangles_[tile]) {
+    const Triangle& triangle = triangles_[index];
+    RasterizeTriangle(triangle, std::max(triangle.min_x, tile_x),
+                      std::max(triangle.min_y, tile_y),
+                      std::min(triangle.max_x, end_x - 1),
+                      std::min(triangle.max_y, end_y - 1));
+  }
+}
+
+void SoftwareDistortionRenderer::RasterizeTriangle(const Triangle& triangle,
+                                                   int min_x, int min_y,
+                                                   int max_x,
+                                                   int max_y) const {
+  const CardboardSoftwareImage& image = *triangle.image;
+  // Texel coordinates are clamped before their conversion to integers, which
+  // keeps it defined and does not change clamp to edge sampling.
+  const Lanes min_texel = Splat(-1.0f);
+  const Lanes max_s = Splat(static_cast<float>(image.width));
+  const Lanes max_t = Splat(static_cast<float>(image.height));
+
+  for (int y = min_y; y <= max_y; ++y) {
+    const float center_y = y + 0.5f;
+    std::array<float, 3> edge_rows;
+    for (int i = 0; i < 3; ++i) {
+      edge_rows[i] =
+          triangle.edges[i].dx * (center_y - triangle.edges[i].y0);
+    }
+    const float s_row =
+        triangle.s0 + triangle.s_dy * (center_y - triangle.y0);
+    const float t_row =
+        triangle.t0 + triangle.t_dy * (center_y - triangle.y0);
+    // Narrows the row to the pixels between the edge crossings, widened by a
+    // pixel so that the edge tests still decide the boundary pixels.
+    float span_min = static_cast<float>(min_x);
+    float span_max = static_cast<float>(max_x);
+    for (int i = 0; i < 3; ++i) {
+      const Edge& edge = triangle.edges[i];
+      if (edge.dy == 0.0f) {
+        continue;
+      }
+      const float crossing = edge.x0 + edge_rows[i] / edge.dy - 0.5f;
+      if (edge.dy > 0.0f) {
+        span_max = std::min(span_max, crossing + 1.0f);
+      } else {
+        span_min = std::max(span_min, crossing - 1.0f);
+      }
+    }
+    if (!(span_min <= span_max)) {
+      continue;
+    }
+    const int row_min_x = static_cast<int>(std::floor(span_min));
+    const int row_max_x = static_cast<int>(std::ceil(span_max));
+    uint8_t* row = target_image_.pixels + y * target_image_.stride;
+
+    for (int x = row_min_x; x <= row_max_x; x += 4) {
+      const Lanes center_x = Add(Splat(x + 0.5f), LaneOffsets());
+      const auto covers = [&](int i) {
+        const Edge& edge = triangle.edges[i];
+        const Lanes value =
+            Sub(Splat(edge_rows[i]),
+                Mul(Splat(edge.dy), Sub(center_x, Splat(edge.x0))));
+        return Covers(value, edge.is_top_left);
+      };
+      int covered_bits = MaskBits(And(And(covers(0), covers(1)), covers(2)));
+      if (row_max_x - x < 3) {
+        covered_bits &= (1 << (row_max_x - x + 1)) - 1;
+      }
+      if (covered_bits == 0) {
+        continue;
+      }
+
+      const Lanes offset_x = Sub(center_x, Splat(triangle.x0));
+      const Lanes s = Min(Max(Add(Splat(s_row), Mul(Splat(triangle.s_dx),
+                                                    offset_x)),
+                              min_texel),
+                          max_s);
+      const Lanes t = Min(Max(Add(Splat(t_row), Mul(Splat(triangle.t_dx),
+                                                    offset_x)),
+                              min_texel),
+                          max_t);
+      const Lanes s_floor = Floor(s);
+      const Lanes t_floor = Floor(t);
+      alignas(16) int32_t texel_x[4];
+      alignas(16) int32_t texel_y[4];
+      alignas(16) float fraction_x[4];
+      alignas(16) float fraction_y[4];
+      StoreInt(s_floor, texel_x);
+      StoreInt(t_floor, texel_y);
+      Store(Sub(s, s_floor), fraction_x);
+      Store(Sub(t, t_floor), fraction_y);
+
+      for (int lane = 0; lane < 4; ++lane) {
+        if ((covered_bits & (1 << lane)) == 0) {
+          continue;
+        }
+        const int x0 = Clamp(texel_x[lane], image.width);
+        const int x1 = Clamp(texel_x[lane] + 1, image.width);
+        const uint8_t* row0 =
+            image.pixels + Clamp(texel_y[lane], image.height) * image.stride;
+        const uint8_t* row1 =
+            image.pixels +
+            Clamp(texel_y[lane] + 1, image.height) * image.stride;
+        const uint32_t pixel =
+            Filter(LoadPixel(row0, x0), LoadPixel(row0, x1),
+                   LoadPixel(row1, x0), LoadPixel(row1, x1),
+                   fraction_x[lane], fraction_y[lane]);
+        std::memcpy(row + 4 * (x + lane), &pixel, 4);
+      }
+    }
+  }
+}
+
+}  // namespace rendering
+}  // namespace cardboard
+
+extern "C" {
+
+CardboardDistortionRenderer* CardboardSoftwareDistortionRenderer_create(
+    int thread_count) {
+  if (CARDBOARD_IS_NOT_INITIALIZED()) {
+    return nullptr;
+  }
+  return reinterpret_cast<CardboardDistortionRenderer*>(
+      new cardboard::rendering::SoftwareDistortionRenderer(thread_count));
+}
+
+void CardboardSoftwareDistortionRenderer_setTargetImage(
+    CardboardDistortionRenderer* renderer,
+    const CardboardSoftwareImage* image) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(renderer) ||
+      CARDBOARD_IS_ARG_NULL(image)) {
+    return;
+  }
+  reinterpret_cast<cardboard::rendering::SoftwareDistortionRenderer*>(
+      renderer)
+      ->SetTargetImage(*image);
+}
+
+void CardboardSoftwareDistortionRenderer_renderEyeToDisplay(
+    CardboardDistortionRenderer* renderer, int x, int y, int width, int height,
+    const CardboardSoftwareEyeTextureDescription* left_eye,
+    const CardboardSoftwareEyeTextureDescription* right_eye) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(renderer) ||
+      CARDBOARD_IS_ARG_NULL(left_eye) || CARDBOARD_IS_ARG_NULL(right_eye)) {
+    return;
+  }
+  reinterpret_cast<cardboard::rendering::SoftwareDistortionRenderer*>(
+      renderer)
+      ->RenderEyeImages(x, y, width, height, *left_eye, *right_eye);
+}
+
+}  // extern "C"
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_RENDERING_SOFTWARE_DISTORTION_RENDERER_H_
+#define CARDBOARD_SDK_RENDERING_SOFTWARE_DISTORTION_RENDERER_H_
+
+#include <array>
+#include <vector>
+
+#include "distortion_renderer.h"
+#include "include/cardboard.h"
+#include "rendering/distortion_mesh_optimizer.h"
+#include "util/thread_pool.h"
+
+namespace cardboard {
+namespace rendering {
+
+// Distortion renderer running on the CPU, for headless rendering and as a
+// reference for the GPU renderers.
+//
+// It follows the OpenGL ES renderers: the whole target image is cleared to
+// opaque black, and each eye mesh is drawn as a triangle list, as returned by
+// OptimizeDistortionMesh(), in its half of the viewport. Triangles cover the
+// pixels whose center they contain, with a top-left rule on shared edges.
+// Texture coordinates are reprojected per vertex, mapped to the eye UV
+// rectangle and interpolated linearly. Eye images are sampled bilinearly with
+// clamp to edge addressing.
+//
+// The target image is split in tiles rendered in parallel by a thread pool.
+class SoftwareDistortionRenderer : public DistortionRenderer {
+ public:
+  // @param thread_count number of threads rendering tiles. Values lower than 1
+  //     select the hardware concurrency.
+  explicit SoftwareDistortionRenderer(int thread_count);
+
+  void SetMesh(const CardboardMesh* mesh, CardboardEye eye) override;
+  void SetEyeTextureLayout(CardboardEyeTextureLayout layout) override;
+
+  // Logs an error: eye textures of the other renderers are not images in CPU
+  // memory. Use RenderEyeImages() instead.
+  void RenderEyeToDisplay(
+      int target_display, int x, int y, int width, int height,
+      const CardboardEyeTextureDescription* left_eye,
+      const CardboardEyeTextureDescription* right_eye) const override;
+
+  // Renders eye images into a rectangle of the target image.
+  void RenderEyeImages(
+      int x, int y, int width, int height,
+      const CardboardSoftwareEyeTextureDescription& left_eye,
+      const CardboardSoftwareEyeTextureDescription& right_eye) const;
+
+  // Sets the image rendered into by RenderEyeImages().
+  //
+  // @param image target image. Its pixels must stay valid while rendering.
+  void SetTargetImage(const CardboardSoftwareImage& image);
+
+ private:
+  // Edge of a triangle, evaluated at pixel (x, y) as
+  //   dx * (y - y0) - dy * (x - x0),
+  // which is positive inside the triangle. Both triangles sharing an edge
+  // evaluate it from the same start vertex, with (dx, dy) negated for one of
+  // them. They get exactly opposite values, and the top-left rule gives each
+  // pixel to one of them.
+  struct Edge {
+    float x0;
+    float y0;
+    float dx;
+    float dy;
+    bool is_top_left;
+  };
+
+  // Triangle in target image pixel coordinates.
+  struct Triangle {
+    std::array<Edge, 3> edges;
+    // Texel coordinates at pixel (x, y) are s0 + s_dx * (x - x0) +
+    // s_dy * (y - y0), and likewise for t, where (x0, y0) is the first
+    // vertex.
+    float x0;
+    float y0;
+    float s0;
+    float s_dx;
+    float s_dy;
+    float t0;
+    float t_dx;
+    float t_dy;
+    // Covered pixel range, clipped to the eye half of the viewport.
+    int min_x;
+    int min_y;
+    int max_x;
+    int max_y;
+    const CardboardSoftwareImage* image;
+  };
+
+  // Mesh vertex in target image pixel and eye image texel coordinates.
+  struct ScreenVertex {
+    float x;
+    float y;
+    float s;
+    float t;
+  };
+
+  // Appends the triangles of an eye mesh to triangles_.
+  //
+  // @param scissor eye half of the viewport clipped to the target image, as
+  //     min x, min y, end x and end y.
+  void SetUpEye(CardboardEye eye,
+                const CardboardSoftwareEyeTextureDescription& desc,
+                const CardboardSoftwareImage* image,
+                const std::array<float, 9>& rotation, int x, int y, int width,
+                int height, const std::array<int, 4>& scissor) const;
+  // Sets up the triangle abc.
+  //
+  // @return false if it is degenerate or outside the scissor rectangle.
+  static bool SetUpTriangle(const ScreenVertex& a, const ScreenVertex& b,
+                            const ScreenVertex& c,
+                            const std::array<int, 4>& scissor,
+                            Triangle* triangle);
+  // Clears a tile and draws the triangles binned to it.
+  void RenderTile(int tile) const;
+  void RasterizeTriangle(const Triangle& triangle, int min_x, int min_y,
+                         int max_x, int max_y) const;
+
+  std::array<TriangleListMesh, 2> meshes_;
+  CardboardEyeTextureLayout eye_texture_layout_;
+  CardboardSoftwareImage target_image_;
+  mutable ThreadPool thread_pool_;
+
+  // Per frame state, kept to reuse its storage.
+  mutable std::vector<ScreenVertex> screen_vertices_;
+  mutable std::vector<Triangle> triangles_;
+  mutable int tile_columns_;
+  mutable std::vector<std::vector<int>> tile_triangles_;
+};
+
+}  // namespace rendering
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_RENDERING_SOFTWARE_DISTORTION_RENDERER_H_
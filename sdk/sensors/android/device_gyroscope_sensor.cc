@@ -19,6 +19,7 @@
 #include <android/sensor.h>
 #include <stddef.h>
 
+#include <algorithm>
 #include <memory>
 #include <mutex>  // NOLINT
 
@@ -111,12 +112,19 @@ class SensorEventQueueReader {
 
   bool Start() {
     ASensorEventQueue_enableSensor(queue_, sensor_);
-    const int min_delay = ASensor_getMinDelay(sensor_);
     // Set sensor capture rate to the highest possible sampling rate.
-    ASensorEventQueue_setEventRate(queue_, sensor_, min_delay);
+    SetSamplingPeriod(0);
     return true;
   }
 
+  int SetSamplingPeriod(int sampling_period_us) {
+    // The sensor cannot run faster than its minimum delay.
+    const int period_us =
+        std::max(sampling_period_us, ASensor_getMinDelay(sensor_));
+    ASensorEventQueue_setEventRate(queue_, sensor_, period_us);
+    return period_us;
+  }
+
   void Stop() { ASensorEventQueue_disableSensor(queue_, sensor_); }
 
   bool WaitForEvent(int timeout_ms, ASensorEvent* event) {
@@ -256,4 +264,11 @@ void DeviceGyroscopeSensor::Stop() {
   sensor_info_->reader->Stop();
 }
 
+int DeviceGyroscopeSensor::SetSamplingPeriod(int sampling_period_us) {
+  if (!sensor_info_->reader) {
+    return 0;
+  }
+  return sensor_info_->reader->SetSamplingPeriod(sampling_period_us);
+}
+
 }  // namespace cardboard
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensors/gyroscope_bias_storage.h"
+
+#include <jni.h>
+
+#include <cstdio>
+#include <mutex>  // NOLINT
+#include <string>
+
+#include "jni_utils/android/jni_utils.h"
+#include "util/logging.h"
+
+namespace cardboard {
+namespace gyroscope_bias_storage {
+
+namespace {
+// Name of the file, in the app files directory, where the bias is saved.
+constexpr const char* kGyroscopeBiasFileName = "cardboard_gyroscope_bias";
+// Maximum length of the device identifier.
+constexpr int kMaxDeviceIdLength = 64;
+
+std::mutex mutex_;
+// Full path of the file where the bias is saved.
+std::string file_path_;
+// Identifier of this device. A saved bias is only used when it was written
+// with the same identifier, so a bias restored from a backup of another device
+// is discarded.
+std::string device_id_;
+
+std::string GetFilesDirPath(JNIEnv* env, jobject context) {
+  jclass context_class = env->GetObjectClass(context);
+  jmethodID get_files_dir =
+      env->GetMethodID(context_class, "getFilesDir", "()Ljava/io/File;");
+  jobject files_dir = env->CallObjectMethod(context, get_files_dir);
+  cardboard::jni::CheckExceptionInJava(env);
+  if (files_dir == nullptr) {
+    return "";
+  }
+  jmethodID get_absolute_path = env->GetMethodID(
+      env->GetObjectClass(files_dir), "getAbsolutePath", "()Ljava/lang/String;");
+  jstring path = static_cast<jstring>(
+      env->CallObjectMethod(files_dir, get_absolute_path));
+  cardboard::jni::CheckExceptionInJava(env);
+  if (path == nullptr) {
+    return "";
+  }
+  const char* path_chars = env->GetStringUTFChars(path, nullptr);
+  std::string result(path_chars);
+  env->ReleaseStringUTFChars(path, path_chars);
+  return result;
+}
+
+std::string GetDeviceId(JNIEnv* env, jobject context) {
+  jclass context_class = env->GetObjectClass(context);
+  jmethodID get_content_resolver =
+      env->GetMethodID(context_class, "getContentResolver",
+                       "()Landroid/content/ContentResolver;");
+  jobject content_resolver =
+      env->CallObjectMethod(context, get_content_resolver);
+  cardboard::jni::CheckExceptionInJava(env);
+
+  jclass settings_secure_class =
+      env->FindClass("android/provider/Settings$Secure");
+  cardboard::jni::CheckExceptionInJava(env);
+  jmethodID get_string = env->GetStaticMethodID(
+      settings_secure_class, "getString",
+      "(Landroid/content/ContentResolver;Ljava/lang/String;)Ljava/lang/"
+      "String;");
+  jstring android_id = static_cast<jstring>(env->CallStaticObjectMethod(
+      settings_secure_class, get_string, content_resolver,
+      env->NewStringUTF("android_id")));
+  cardboard::jni::CheckExceptionInJava(env);
+  if (android_id == nullptr) {
+    return "";
+  }
+  const char* android_id_chars = env->GetStringUTFChars(android_id, nullptr);
+  std::string result(android_id_chars);
+  env->ReleaseStringUTFChars(android_id, android_id_chars);
+  return result.substr(0, kMaxDeviceIdLength);
+}
+
+}  // anonymous namespace
+
+void initializeAndroid(JavaVM* vm, jobject context) {
+  JNIEnv* env;
+  cardboard::jni::LoadJNIEnv(vm, &env);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const std::string files_dir = GetFilesDirPath(env, context);
+  file_path_ =
+      files_dir.empty() ? "" : files_dir + "/" + kGyroscopeBiasFileName;
+  device_id_ = GetDeviceId(env, context);
+}
+
+bool readGyroscopeBias(Vector3* bias) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_path_.empty()) {
+    return false;
+  }
+  FILE* file = std::fopen(file_path_.c_str(), "r");
+  if (file == nullptr) {
+    return false;
+  }
+  char device_id[kMaxDeviceIdLength + 1] = {};
+  double x, y, z;
+  const int num_read =
+      std::fscanf(file, "%64s %lf %lf %lf", device_id, &x, &y, &z);
+  std::fclose(file);
+  if (num_read != 4 || device_id_ != device_id) {
+    return false;
+  }
+  bias->Set(x, y, z);
+  return true;
+}
+
+void writeGyroscopeBias(const Vector3& bias) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_path_.empty() || device_id_.empty()) {
+    return;
+  }
+  FILE* file = std::fopen(file_path_.c_str(), "w");
+  if (file == nullptr) {
+    CARDBOARD_LOGE("Could not save gyroscope bias to %s", file_path_.c_str());
+    return;
+  }
+  std::fprintf(file, "%s %.9g %.9g %.9g\n", device_id_.c_str(), bias[0],
+               bias[1], bias[2]);
+  std::fclose(file);
+}
+
+}  // namespace gyroscope_bias_storage
+}  // namespace cardboard
@@ -30,13 +30,21 @@ namespace cardboard {
 
 template <typename DataType>
 struct SensorEventProducer<DataType>::EventProducer {
-  EventProducer() : run_thread(false) {}
+  EventProducer()
+      : run_thread(false),
+        requested_sampling_period_us(0),
+        sampling_period_us(0) {}
   // Capture thread. This will be created when polling is started, and
   // destroyed when polling is stopped.
   std::unique_ptr<std::thread> thread;
   std::mutex mutex;
   // Flag indicating if the capture thread should run.
   std::atomic<bool> run_thread;
+  // Sampling period requested by the client. It is applied by the capture
+  // thread.
+  std::atomic<int> requested_sampling_period_us;
+  // Sampling period currently applied to the sensor.
+  std::atomic<int> sampling_period_us;
 };
 
 template <typename DataType>
@@ -63,6 +71,16 @@ void SensorEventProducer<DataType>::StopSensorPolling() {
   on_event_callback_ = nullptr;
 }
 
+template <typename DataType>
+void SensorEventProducer<DataType>::SetSamplingPeriod(int sampling_period_us) {
+  event_producer_->requested_sampling_period_us = sampling_period_us;
+}
+
+template <typename DataType>
+int SensorEventProducer<DataType>::GetSamplingPeriod() const {
+  return event_producer_->sampling_period_us;
+}
+
 template <typename DataType>
 void SensorEventProducer<DataType>::StartSensorPollingLocked() {
   // If the thread is started already there is nothing left to do.
@@ -96,11 +114,20 @@ void SensorEventProducer<AccelerometerData>::WorkFn() {
   }
 
   std::vector<AccelerometerData> sensor_events_vec;
+  // Sampling period request applied to the sensor, -1 if none.
+  int applied_sampling_period_request_us = -1;
 
   // On other devices and platforms we estimate the clock bias.
   // TODO(b/135468657): Investigate clock conversion. Old cardboard doesn't have
   // this.
   while (event_producer_->run_thread) {
+    const int sampling_period_request_us =
+        event_producer_->requested_sampling_period_us;
+    if (sampling_period_request_us != applied_sampling_period_request_us) {
+      event_producer_->sampling_period_us =
+          sensor.SetSamplingPeriod(sampling_period_request_us);
+      applied_sampling_period_request_us = sampling_period_request_us;
+    }
     sensor.PollForSensorData(kMaxWaitMilliseconds, &sensor_events_vec);
     for (AccelerometerData& event : sensor_events_vec) {
       event.system_timestamp = event.sensor_timestamp_ns;
@@ -110,6 +137,7 @@ void SensorEventProducer<AccelerometerData>::WorkFn() {
     }
   }
   sensor.Stop();
+  event_producer_->sampling_period_us = 0;
 }
 
 template <>
@@ -121,11 +149,20 @@ void SensorEventProducer<GyroscopeData>::WorkFn() {
   }
 
   std::vector<GyroscopeData> sensor_events_vec;
+  // Sampling period request applied to the sensor, -1 if none.
+  int applied_sampling_period_request_us = -1;
 
   // On other devices and platforms we estimate the clock bias.
   // TODO(b/135468657): Investigate clock conversion. Old cardboard doesn't have
   // this.
   while (event_producer_->run_thread) {
+    const int sampling_period_request_us =
+        event_producer_->requested_sampling_period_us;
+    if (sampling_period_request_us != applied_sampling_period_request_us) {
+      event_producer_->sampling_period_us =
+          sensor.SetSamplingPeriod(sampling_period_request_us);
+      applied_sampling_period_request_us = sampling_period_request_us;
+    }
     sensor.PollForSensorData(kMaxWaitMilliseconds, &sensor_events_vec);
     for (GyroscopeData& event : sensor_events_vec) {
       event.system_timestamp = event.sensor_timestamp_ns;
@@ -135,6 +172,7 @@ void SensorEventProducer<GyroscopeData>::WorkFn() {
     }
   }
   sensor.Stop();
+  event_producer_->sampling_period_us = 0;
 }
 
 // Forcing instantiation of SensorEventProducer for each sensor type.
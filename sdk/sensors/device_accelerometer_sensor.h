@@ -51,6 +51,15 @@ class DeviceAccelerometerSensor {
   // Stops the sensor capture process.
   void Stop();
 
+  // Sets the period between sensor events. The sensor may not support the
+  // exact period, in which case the closest supported one is used.
+  // This must only be called after a successful call to Start() was made.
+  //
+  // @param sampling_period_us period in microseconds. Zero requests the fastest
+  //     rate supported by the sensor.
+  // @return the sampling period applied in microseconds.
+  int SetSamplingPeriod(int sampling_period_us);
+
   // The implementation of device sensors differs between iOS and Android.
   struct SensorInfo;
 
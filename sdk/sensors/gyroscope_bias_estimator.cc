@@ -117,7 +117,9 @@ GyroscopeBiasEstimator::GyroscopeBiasEstimator()
       current_accumulated_weights_gyroscope_bias_(0.f),
       mean_filter_(kFilterWindowSize),
       median_filter_(kFilterWindowSize),
-      last_mean_filtered_accelerometer_value_({0, 0, 0}) {
+      last_mean_filtered_accelerometer_value_({0, 0, 0}),
+      has_initial_gyroscope_bias_(false),
+      initial_gyroscope_bias_({0, 0, 0}) {
   Reset();
 }
 
@@ -126,11 +128,21 @@ GyroscopeBiasEstimator::~GyroscopeBiasEstimator() {}
 void GyroscopeBiasEstimator::Reset() {
   accelerometer_lowpass_filter_.Reset();
   gyroscope_lowpass_filter_.Reset();
-  gyroscope_bias_lowpass_filter_.Reset();
+  if (has_initial_gyroscope_bias_) {
+    gyroscope_bias_lowpass_filter_.Reset(initial_gyroscope_bias_);
+  } else {
+    gyroscope_bias_lowpass_filter_.Reset();
+  }
   accelerometer_static_counter_->Reset();
   gyroscope_static_counter_->Reset();
 }
 
+void GyroscopeBiasEstimator::SetInitialGyroscopeBias(const Vector3& bias) {
+  has_initial_gyroscope_bias_ = true;
+  initial_gyroscope_bias_ = bias;
+  gyroscope_bias_lowpass_filter_.Reset(initial_gyroscope_bias_);
+}
+
 void GyroscopeBiasEstimator::ProcessGyroscope(const Vector3& gyroscope_sample,
                                               uint64_t timestamp_ns) {
   // Update gyroscope and gyroscope delta low-pass filters.
@@ -302,13 +314,16 @@ bool GyroscopeBiasEstimator::IsCurrentEstimateValid() const {
        (Length(off_gravity_gyro_bias) + kEpsilon));
   const bool hasEnoughSamples = current_accumulated_weights_gyroscope_bias_ >
                                 kMinSumOfWeightsGyroBiasThreshold;
-  const bool areCountersStatic =
-      gyroscope_static_counter_->IsRecentlyStatic() &&
-      accelerometer_static_counter_->IsRecentlyStatic();
+  const bool areCountersStatic = IsStatic();
 
   const bool isStatic = hasEnoughSamples && areCountersStatic &&
                         !isGyroscopeBiasCorrelatedWithSimulatedGyro;
   return isStatic;
 }
 
+bool GyroscopeBiasEstimator::IsStatic() const {
+  return gyroscope_static_counter_->IsRecentlyStatic() &&
+         accelerometer_static_counter_->IsRecentlyStatic();
+}
+
 }  // namespace cardboard
@@ -89,11 +89,23 @@ class GyroscopeBiasEstimator {
   // Resets the estimator state.
   void Reset();
 
+  // Seeds the estimator with a prior bias estimate, e.g. provided by the
+  // system or saved by a previous session. The estimator starts filtering from
+  // this value instead of the first static gyroscope sample. The seed is kept
+  // across resets.
+  //
+  // @param bias initial gyroscope bias in radians/sec.
+  void SetInitialGyroscopeBias(const Vector3& bias);
+
   // Returns true if the current estimate returned by GetGyroscopeBias is
   // correct. The device (measured using the sensors) has to be static for this
   // function to return true.
   virtual bool IsCurrentEstimateValid() const;
 
+  // Returns true if both the gyroscope and accelerometer signals have been
+  // static for the last few frames.
+  bool IsStatic() const;
+
  private:
   // A helper class to keep track of whether some signal can be considered
   // static over specified number of frames.
@@ -130,6 +142,10 @@ class GyroscopeBiasEstimator {
 
   // Last computed filter accelerometer value used for finite differences.
   Vector3 last_mean_filtered_accelerometer_value_;
+
+  // Prior bias estimate used to initialize gyroscope_bias_lowpass_filter_.
+  bool has_initial_gyroscope_bias_;
+  Vector3 initial_gyroscope_bias_;
 };
 
 }  // namespace cardboard
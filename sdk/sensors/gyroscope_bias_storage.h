@@ -0,0 +1,39 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_SENSORS_GYROSCOPE_BIAS_STORAGE_H_
+#define CARDBOARD_SDK_SENSORS_GYROSCOPE_BIAS_STORAGE_H_
+
+#ifdef __ANDROID__
+#include <jni.h>
+#endif
+
+#include "util/vector.h"
+
+namespace cardboard {
+namespace gyroscope_bias_storage {
+#ifdef __ANDROID__
+void initializeAndroid(JavaVM* vm, jobject context);
+#endif
+// Reads the gyroscope bias saved by a previous session on this device.
+// Returns false if there is none.
+bool readGyroscopeBias(Vector3* bias);
+// Saves the gyroscope bias so it can be used to seed the next session on this
+// device.
+void writeGyroscopeBias(const Vector3& bias);
+}  // namespace gyroscope_bias_storage
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_SENSORS_GYROSCOPE_BIAS_STORAGE_H_
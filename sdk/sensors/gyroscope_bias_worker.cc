@@ -0,0 +1,186 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensors/gyroscope_bias_worker.h"
+
+#include <chrono>  // NOLINT
+
+#ifdef __ANDROID__
+#include <sys/resource.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+namespace cardboard {
+
+namespace {
+
+// Period at which the worker thread drains the sample queue. Bias estimates
+// are published with at most this delay, which is negligible compared to the
+// time constants of the estimator filters.
+constexpr std::chrono::milliseconds kProcessingPeriod(20);
+
+// Maximum number of queued samples. This covers several processing periods of
+// both sensors at their fastest rate. When the worker falls behind, the oldest
+// samples are dropped.
+constexpr size_t kMaxQueuedSamples = 256;
+
+#ifdef __ANDROID__
+// Nice value of the worker thread. Higher values mean lower priority.
+constexpr int kWorkerThreadNiceValue = 10;
+#endif
+
+// Lowers the priority of the calling thread so it does not compete with the
+// sensor and render threads.
+void LowerCurrentThreadPriority() {
+#ifdef __ANDROID__
+  setpriority(PRIO_PROCESS, gettid(), kWorkerThreadNiceValue);
+#elif defined(__APPLE__)
+  pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#endif
+}
+
+}  // namespace
+
+GyroscopeBiasWorker::GyroscopeBiasWorker()
+    : run_thread_(true),
+      is_worker_idle_(false),
+      queue_(kMaxQueuedSamples),
+      generation_(0),
+      has_pending_initial_gyroscope_bias_(false),
+      pending_initial_gyroscope_bias_({0, 0, 0}),
+      accepted_generation_(0),
+      published_estimate_({{Vector3::Zero(), false, false}, 0}) {
+  batch_.reserve(kMaxQueuedSamples);
+  thread_ = std::thread([this]() { WorkFn(); });
+}
+
+GyroscopeBiasWorker::~GyroscopeBiasWorker() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    run_thread_ = false;
+  }
+  condition_.notify_one();
+  thread_.join();
+}
+
+void GyroscopeBiasWorker::ProcessGyroscope(const Vector3& gyroscope_sample,
+                                           uint64_t timestamp_ns) {
+  QueueSample({Sample::Type::kGyroscope, gyroscope_sample, timestamp_ns});
+}
+
+void GyroscopeBiasWorker::ProcessAccelerometer(
+    const Vector3& accelerometer_sample, uint64_t timestamp_ns) {
+  QueueSample(
+      {Sample::Type::kAccelerometer, accelerometer_sample, timestamp_ns});
+}
+
+void GyroscopeBiasWorker::Reset() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  queue_.Clear();
+  accepted_generation_ = ++generation_;
+}
+
+void GyroscopeBiasWorker::SetInitialGyroscopeBias(const Vector3& bias) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  has_pending_initial_gyroscope_bias_ = true;
+  pending_initial_gyroscope_bias_ = bias;
+}
+
+GyroscopeBiasWorker::Estimate GyroscopeBiasWorker::GetLatestEstimate() {
+  const PublishedEstimate& published = published_estimate_.Read();
+  if (published.generation != accepted_generation_) {
+    return {Vector3::Zero(), false, false};
+  }
+  return published.estimate;
+}
+
+void GyroscopeBiasWorker::QueueSample(const Sample& sample) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  queue_.PushBack(sample);
+  // Only the first sample after an idle period needs to wake the worker up,
+  // the others are picked up by its periodic processing.
+  const bool wake_worker = is_worker_idle_;
+  is_worker_idle_ = false;
+  lock.unlock();
+  if (wake_worker) {
+    condition_.notify_one();
+  }
+}
+
+void GyroscopeBiasWorker::WorkFn() {
+  LowerCurrentThreadPriority();
+
+  uint32_t generation = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (run_thread_) {
+    // Sleeps without a timeout while there is nothing to process, so an idle
+    // worker does not wake up periodically.
+    if (queue_.Size() == 0) {
+      is_worker_idle_ = true;
+      condition_.wait(lock,
+                      [this]() { return !run_thread_ || !is_worker_idle_; });
+      if (!run_thread_) {
+        break;
+      }
+    }
+    // Lets a batch of samples accumulate.
+    condition_.wait_for(lock, kProcessingPeriod,
+                        [this]() { return !run_thread_; });
+    if (!run_thread_) {
+      break;
+    }
+
+    // Takes the queued samples and pending requests, then releases the lock so
+    // the sensor threads are never blocked by the estimator.
+    batch_.clear();
+    for (size_t i = 0; i < queue_.Size(); ++i) {
+      batch_.push_back(queue_[i]);
+    }
+    queue_.Clear();
+    const bool reset = generation != generation_;
+    generation = generation_;
+    const bool has_initial_gyroscope_bias = has_pending_initial_gyroscope_bias_;
+    const Vector3 initial_gyroscope_bias = pending_initial_gyroscope_bias_;
+    has_pending_initial_gyroscope_bias_ = false;
+    lock.unlock();
+
+    if (has_initial_gyroscope_bias) {
+      estimator_.SetInitialGyroscopeBias(initial_gyroscope_bias);
+    }
+    if (reset) {
+      estimator_.Reset();
+    }
+
+    if (!batch_.empty()) {
+      for (const Sample& sample : batch_) {
+        if (sample.type == Sample::Type::kGyroscope) {
+          estimator_.ProcessGyroscope(sample.data, sample.timestamp_ns);
+        } else {
+          estimator_.ProcessAccelerometer(sample.data, sample.timestamp_ns);
+        }
+      }
+      published_estimate_.Write({{estimator_.GetGyroscopeBias(),
+                                  estimator_.IsCurrentEstimateValid(),
+                                  estimator_.IsStatic()},
+                                 generation});
+    }
+
+    lock.lock();
+  }
+}
+
+}  // namespace cardboard
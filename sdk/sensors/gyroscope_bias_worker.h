@@ -0,0 +1,150 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_SENSORS_GYROSCOPE_BIAS_WORKER_H_
+#define CARDBOARD_SDK_SENSORS_GYROSCOPE_BIAS_WORKER_H_
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "sensors/gyroscope_bias_estimator.h"
+#include "util/ring_buffer.h"
+#include "util/triple_buffer.h"
+#include "util/vector.h"
+
+namespace cardboard {
+
+// Runs a GyroscopeBiasEstimator on a low priority thread so that bias
+// estimation stays off the gyroscope integration path.
+//
+// Sensor samples are copied into a bounded queue which the worker thread drains
+// periodically. After each batch the worker publishes the estimator output
+// through a lock-free TripleBuffer. Queuing a sample never blocks on the
+// estimator, and reading the latest estimate never blocks at all. While no
+// samples are queued, e.g. during low power tracking, the worker thread sleeps
+// until the next sample arrives.
+//
+// ProcessGyroscope and ProcessAccelerometer may be called from different
+// threads. Calls to GetLatestEstimate and Reset must be serialized by the
+// caller.
+class GyroscopeBiasWorker {
+ public:
+  // Output of the bias estimator.
+  struct Estimate {
+    // Estimated gyroscope bias in radians/sec.
+    Vector3 gyroscope_bias;
+    // True if gyroscope_bias is a valid estimate.
+    bool is_valid;
+    // True if the estimator considers the device static.
+    bool is_static;
+  };
+
+  // Starts the worker thread.
+  GyroscopeBiasWorker();
+
+  // Stops the worker thread. Queued samples are discarded.
+  ~GyroscopeBiasWorker();
+
+  // Queues a gyroscope sample for the estimator.
+  //
+  // @param gyroscope_sample the angular speed around the x, y, z axis in
+  //     radians/sec.
+  // @param timestamp_ns the nanosecond at which the event occurred.
+  void ProcessGyroscope(const Vector3& gyroscope_sample, uint64_t timestamp_ns);
+
+  // Queues an accelerometer sample for the estimator.
+  //
+  // @param accelerometer_sample the acceleration (including gravity) on the x,
+  //     y, z axis in meters/s^2.
+  // @param timestamp_ns the nanosecond at which the event occurred.
+  void ProcessAccelerometer(const Vector3& accelerometer_sample,
+                            uint64_t timestamp_ns);
+
+  // Discards queued samples and resets the estimator. Estimates computed
+  // before the reset are no longer reported.
+  void Reset();
+
+  // Seeds the estimator with a prior bias estimate. See
+  // GyroscopeBiasEstimator::SetInitialGyroscopeBias.
+  //
+  // @param bias initial gyroscope bias in radians/sec.
+  void SetInitialGyroscopeBias(const Vector3& bias);
+
+  // Returns the latest estimate published by the worker thread.
+  Estimate GetLatestEstimate();
+
+ private:
+  // Sensor sample copied into the queue.
+  struct Sample {
+    enum class Type { kGyroscope, kAccelerometer };
+    Type type;
+    Vector3 data;
+    uint64_t timestamp_ns;
+  };
+
+  // Estimate tagged with the reset generation it was computed in.
+  struct PublishedEstimate {
+    Estimate estimate;
+    uint32_t generation;
+  };
+
+  // Appends a sample to the queue.
+  void QueueSample(const Sample& sample);
+
+  // Worker thread main loop.
+  void WorkFn();
+
+  std::mutex mutex_;
+  // Signaled to stop the worker thread, or to wake it up when a sample is
+  // queued while it is idle.
+  std::condition_variable condition_;
+  // Flag indicating if the worker thread should run. Guarded by mutex_.
+  bool run_thread_;
+  // Flag indicating if the worker thread waits for a sample to be queued.
+  // Guarded by mutex_.
+  bool is_worker_idle_;
+  // Samples received since the worker last drained the queue. Guarded by
+  // mutex_.
+  RingBuffer<Sample> queue_;
+  // Incremented by every reset. Guarded by mutex_.
+  uint32_t generation_;
+  // Seed requested by SetInitialGyroscopeBias, applied by the worker thread.
+  // Guarded by mutex_.
+  bool has_pending_initial_gyroscope_bias_;
+  Vector3 pending_initial_gyroscope_bias_;
+
+  // Reset generation of the estimates GetLatestEstimate reports.
+  uint32_t accepted_generation_;
+
+  // Estimates published by the worker thread.
+  TripleBuffer<PublishedEstimate> published_estimate_;
+
+  // Only accessed by the worker thread.
+  GyroscopeBiasEstimator estimator_;
+  std::vector<Sample> batch_;
+
+  std::thread thread_;
+
+  GyroscopeBiasWorker(const GyroscopeBiasWorker&) = delete;
+  GyroscopeBiasWorker& operator=(const GyroscopeBiasWorker&) = delete;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_SENSORS_GYROSCOPE_BIAS_WORKER_H_
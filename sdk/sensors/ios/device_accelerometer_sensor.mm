@@ -63,4 +63,11 @@ void DeviceAccelerometerSensor::Stop() {
   // This should never be called on iOS.
 }
 
+int DeviceAccelerometerSensor::SetSamplingPeriod(int sampling_period_us) {
+  const NSTimeInterval update_interval = [[CardboardSensorHelper sharedSensorHelper]
+      setUpdateInterval:sampling_period_us * 1e-6
+                forType:SensorHelperTypeAccelerometer];
+  return static_cast<int>(update_interval * 1e6);
+}
+
 }  // namespace cardboard
@@ -68,6 +68,13 @@ void DeviceGyroscopeSensor::Stop() {
   // This should never be called on iOS.
 }
 
+int DeviceGyroscopeSensor::SetSamplingPeriod(int sampling_period_us) {
+  const NSTimeInterval update_interval = [[CardboardSensorHelper sharedSensorHelper]
+      setUpdateInterval:sampling_period_us * 1e-6
+                forType:SensorHelperTypeGyro];
+  return static_cast<int>(update_interval * 1e6);
+}
+
 // This function returns gyroscope initial system bias
 Vector3 DeviceGyroscopeSensor::GetInitialSystemBias() {
   return SensorInfo::initial_system_gyro_bias;
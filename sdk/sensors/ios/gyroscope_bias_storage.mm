@@ -0,0 +1,62 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#import "sensors/gyroscope_bias_storage.h"
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+namespace cardboard {
+namespace gyroscope_bias_storage {
+
+namespace {
+static NSString *const kGyroscopeBiasKey = @"com.google.cardboard.sdk.GyroscopeBias";
+static NSString *const kDeviceIdKey = @"device";
+static NSString *const kBiasKey = @"bias";
+
+// Identifier of this device. A saved bias is only used when it was written with the same
+// identifier, so a bias restored from a backup of another device is discarded.
+NSString *GetDeviceId() { return [UIDevice currentDevice].identifierForVendor.UUIDString; }
+}  // anonymous namespace
+
+bool readGyroscopeBias(Vector3 *bias) {
+  NSDictionary *saved_bias =
+      [[NSUserDefaults standardUserDefaults] dictionaryForKey:kGyroscopeBiasKey];
+  NSString *device_id = GetDeviceId();
+  if (!saved_bias || !device_id || ![saved_bias[kDeviceIdKey] isEqualToString:device_id]) {
+    return false;
+  }
+  NSArray *values = saved_bias[kBiasKey];
+  if (![values isKindOfClass:[NSArray class]] || values.count != 3) {
+    return false;
+  }
+  bias->Set([values[0] doubleValue], [values[1] doubleValue], [values[2] doubleValue]);
+  return true;
+}
+
+void writeGyroscopeBias(const Vector3 &bias) {
+  NSString *device_id = GetDeviceId();
+  if (!device_id) {
+    return;
+  }
+  NSDictionary *saved_bias = @{
+    kDeviceIdKey : device_id,
+    kBiasKey : @[ @(bias[0]), @(bias[1]), @(bias[2]) ],
+  };
+  [[NSUserDefaults standardUserDefaults] setObject:saved_bias forKey:kGyroscopeBiasKey];
+}
+
+}  // namespace gyroscope_bias_storage
+}  // namespace cardboard
@@ -45,7 +45,11 @@ struct cardboard::DeviceSensor<GyroscopeData> {
 
 template <typename DataType>
 struct cardboard::SensorEventProducer<DataType>::EventProducer {
-  EventProducer() : run_thread(false) {}
+  EventProducer()
+      : run_thread(false),
+        requested_sampling_period_us(0),
+        applied_sampling_period_request_us(-1),
+        sampling_period_us(0) {}
 
   // Sensor to poll for data.
   DeviceSensor<DataType> sensor;
@@ -53,6 +57,12 @@ struct cardboard::SensorEventProducer<DataType>::EventProducer {
   std::vector<DataType> sensor_events_vec;
   // Flag indicating if the capture thread should run.
   std::atomic<bool> run_thread;
+  // Sampling period requested by the client. It is applied by WorkFn.
+  std::atomic<int> requested_sampling_period_us;
+  // Sampling period request applied to the sensor, -1 if none.
+  int applied_sampling_period_request_us;
+  // Sampling period currently applied to the sensor.
+  std::atomic<int> sampling_period_us;
   // Block that invokes the WorkFn.
   void (^workfn_block)(void);
 };
@@ -81,6 +91,7 @@ void SensorEventProducer<AccelerometerData>::StartSensorPolling(
     event_producer_->run_thread = false;
     return;
   }
+  event_producer_->applied_sampling_period_request_us = -1;
 
   event_producer_->workfn_block = ^{
     WorkFn();
@@ -104,6 +115,7 @@ void SensorEventProducer<GyroscopeData>::StartSensorPolling(
     event_producer_->run_thread = false;
     return;
   }
+  event_producer_->applied_sampling_period_request_us = -1;
 
   event_producer_->workfn_block = ^{
     WorkFn();
@@ -135,8 +147,25 @@ void SensorEventProducer<GyroscopeData>::StopSensorPolling() {
                                           callback:event_producer_->workfn_block];
 }
 
+template <typename DataType>
+void SensorEventProducer<DataType>::SetSamplingPeriod(int sampling_period_us) {
+  event_producer_->requested_sampling_period_us = sampling_period_us;
+}
+
+template <typename DataType>
+int SensorEventProducer<DataType>::GetSamplingPeriod() const {
+  return event_producer_->run_thread ? event_producer_->sampling_period_us.load() : 0;
+}
+
 template <typename DataType>
 void SensorEventProducer<DataType>::WorkFn() {
+  const int sampling_period_request_us = event_producer_->requested_sampling_period_us;
+  if (sampling_period_request_us != event_producer_->applied_sampling_period_request_us) {
+    event_producer_->sampling_period_us =
+        event_producer_->sensor.value->SetSamplingPeriod(sampling_period_request_us);
+    event_producer_->applied_sampling_period_request_us = sampling_period_request_us;
+  }
+
   event_producer_->sensor.value->PollForSensorData(kMaxWaitMilliseconds,
                                                    &event_producer_->sensor_events_vec);
 
@@ -38,4 +38,8 @@ typedef NS_ENUM(NSUInteger, SensorHelperType) {
 // Stops the sensor callback.
 - (void)stop:(SensorHelperType)type callback:(void (^)(void))callback;
 
+// Sets the sensor update interval in seconds. It may be called while the sensor
+// is running. Returns the update interval that is applied.
+- (NSTimeInterval)setUpdateInterval:(NSTimeInterval)interval forType:(SensorHelperType)type;
+
 @end
@@ -24,6 +24,8 @@
 // Sample accelerometer and gyro every 10ms.
 static const NSTimeInterval kAccelerometerUpdateInterval = 0.01;
 static const NSTimeInterval kGyroUpdateInterval = 0.01;
+// Shortest update interval supported.
+static const NSTimeInterval kMinUpdateInterval = 0.01;
 
 @interface CardboardSensorHelper ()
 @property(atomic) CMAccelerometerData *accelerometerData;
@@ -37,6 +39,8 @@ static const NSTimeInterval kGyroUpdateInterval = 0.01;
   NSMutableSet *_deviceMotionCallbacks;
   NSLock *_accelerometerLock;
   NSLock *_deviceMotionLock;
+  NSTimeInterval _accelerometerUpdateInterval;
+  NSTimeInterval _gyroUpdateInterval;
 }
 
 + (CardboardSensorHelper *)sharedSensorHelper {
@@ -66,6 +70,9 @@ static const NSTimeInterval kGyroUpdateInterval = 0.01;
 
     _accelerometerLock = [[NSLock alloc] init];
     _deviceMotionLock = [[NSLock alloc] init];
+
+    _accelerometerUpdateInterval = kAccelerometerUpdateInterval;
+    _gyroUpdateInterval = kGyroUpdateInterval;
   }
   return self;
 }
@@ -81,7 +88,7 @@ static const NSTimeInterval kGyroUpdateInterval = 0.01;
 
       if (_motionManager.isAccelerometerActive) break;
 
-      _motionManager.accelerometerUpdateInterval = kAccelerometerUpdateInterval;
+      _motionManager.accelerometerUpdateInterval = _accelerometerUpdateInterval;
       [_motionManager
           startAccelerometerUpdatesToQueue:_queue
                                withHandler:^(CMAccelerometerData *accelerometerData,
@@ -109,7 +116,7 @@ static const NSTimeInterval kGyroUpdateInterval = 0.01;
 
       if (_motionManager.isDeviceMotionActive) break;
 
-      _motionManager.deviceMotionUpdateInterval = kGyroUpdateInterval;
+      _motionManager.deviceMotionUpdateInterval = _gyroUpdateInterval;
       [_motionManager
           startDeviceMotionUpdatesToQueue:_queue
                               withHandler:^(CMDeviceMotion *motionData, NSError *error) {
@@ -154,6 +161,22 @@ static const NSTimeInterval kGyroUpdateInterval = 0.01;
   }
 }
 
+- (NSTimeInterval)setUpdateInterval:(NSTimeInterval)interval forType:(SensorHelperType)type {
+  const NSTimeInterval updateInterval = MAX(interval, kMinUpdateInterval);
+  switch (type) {
+    case SensorHelperTypeAccelerometer: {
+      _accelerometerUpdateInterval = updateInterval;
+      _motionManager.accelerometerUpdateInterval = updateInterval;
+    } break;
+
+    case SensorHelperTypeGyro: {
+      _gyroUpdateInterval = updateInterval;
+      _motionManager.deviceMotionUpdateInterval = updateInterval;
+    } break;
+  }
+  return updateInterval;
+}
+
 - (BOOL)isAccelerometerAvailable {
   return [_motionManager isAccelerometerAvailable];
 }
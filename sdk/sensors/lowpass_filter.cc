@@ -80,4 +80,10 @@ void LowpassFilter::Reset() {
   filtered_data_ = {0, 0, 0};
 }
 
+void LowpassFilter::Reset(const Vector3& data) {
+  initialized_ = true;
+  filtered_data_ = data;
+  timestamp_most_recent_update_ns_ = 0;
+}
+
 }  // namespace cardboard
@@ -65,6 +65,13 @@ class LowpassFilter {
   // Resets filter state.
   void Reset();
 
+  // Resets filter state and initializes the filtered value with data instead
+  // of the first sample. The time step between the next two samples is used
+  // for the first update.
+  //
+  // @param data initial filtered value.
+  void Reset(const Vector3& data);
+
  private:
   const double cutoff_time_constant_;
   uint64_t timestamp_most_recent_update_ns_;
@@ -17,25 +17,21 @@
 
 namespace cardboard {
 
-MeanFilter::MeanFilter(size_t filter_size) : filter_size_(filter_size) {}
+MeanFilter::MeanFilter(size_t filter_size)
+    : filter_size_(filter_size), buffer_(filter_size), sum_(Vector3::Zero()) {}
 
 void MeanFilter::AddSample(const Vector3& sample) {
-  buffer_.push_back(sample);
-  if (buffer_.size() > filter_size_) {
-    buffer_.pop_front();
+  Vector3 evicted;
+  if (buffer_.PushBack(sample, &evicted)) {
+    sum_ -= evicted;
   }
+  sum_ += sample;
 }
 
-bool MeanFilter::IsValid() const { return buffer_.size() == filter_size_; }
+bool MeanFilter::IsValid() const { return buffer_.IsFull(); }
 
 Vector3 MeanFilter::GetFilteredData() const {
-  // Compute mean of the samples stored in buffer_.
-  Vector3 mean = Vector3::Zero();
-  for (auto sample : buffer_) {
-    mean += sample;
-  }
-
-  return mean / static_cast<double>(filter_size_);
+  return sum_ / static_cast<double>(filter_size_);
 }
 
 }  // namespace cardboard
@@ -16,13 +16,16 @@
 #ifndef CARDBOARD_SDK_SENSORS_MEAN_FILTER_H_
 #define CARDBOARD_SDK_SENSORS_MEAN_FILTER_H_
 
-#include <deque>
+#include <cstddef>
 
+#include "util/ring_buffer.h"
 #include "util/vector.h"
 
 namespace cardboard {
 
 // Fixed window FIFO mean filter for vectors of the given dimension.
+// The sum of the window is updated incrementally so both adding a sample and
+// reading the mean are O(1) and never allocate.
 class MeanFilter {
  public:
   // Create a mean filter of size filter_size.
@@ -40,7 +43,9 @@ class MeanFilter {
 
  private:
   const size_t filter_size_;
-  std::deque<Vector3> buffer_;
+  RingBuffer<Vector3> buffer_;
+  // Sum of the samples stored in buffer_.
+  Vector3 sum_;
 };
 
 }  // namespace cardboard
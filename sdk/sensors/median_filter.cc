@@ -16,49 +16,53 @@
 #include "sensors/median_filter.h"
 
 #include <algorithm>
-#include <vector>
 
 #include "util/vector.h"
 #include "util/vectorutils.h"
 
 namespace cardboard {
 
-MedianFilter::MedianFilter(size_t filter_size) : filter_size_(filter_size) {}
+MedianFilter::MedianFilter(size_t filter_size)
+    : filter_size_(filter_size), buffer_(filter_size) {
+  sorted_norms_.reserve(filter_size);
+}
 
 void MedianFilter::AddSample(const Vector3& sample) {
-  buffer_.push_back(sample);
-  norms_.push_back(Length(sample));
-  if (buffer_.size() > filter_size_) {
-    buffer_.pop_front();
-    norms_.pop_front();
+  if (filter_size_ == 0) {
+    return;
   }
-}
+  const bool evicted = buffer_.PushBack(sample);
+  const size_t slot = buffer_.SlotOf(buffer_.Size() - 1);
 
-bool MedianFilter::IsValid() const { return buffer_.size() == filter_size_; }
+  // When the buffer is full the new sample overwrites the oldest one in place,
+  // so its norm entry is the one to drop.
+  if (evicted) {
+    sorted_norms_.erase(
+        std::find_if(sorted_norms_.begin(), sorted_norms_.end(),
+                     [slot](const NormEntry& entry) {
+                       return entry.slot == slot;
+                     }));
+  }
 
-Vector3 MedianFilter::GetFilteredData() const {
-  std::vector<float> norms(norms_.begin(), norms_.end());
+  const NormEntry entry = {static_cast<float>(Length(sample)), slot};
+  sorted_norms_.insert(
+      std::upper_bound(sorted_norms_.begin(), sorted_norms_.end(), entry,
+                       [](const NormEntry& lhs, const NormEntry& rhs) {
+                         return lhs.norm < rhs.norm;
+                       }),
+      entry);
+}
 
-  // Get median of value of the norms.
-  std::nth_element(norms.begin(), norms.begin() + filter_size_ / 2,
-                   norms.end());
-  const float median_norm = norms[filter_size_ / 2];
+bool MedianFilter::IsValid() const { return buffer_.IsFull(); }
 
+Vector3 MedianFilter::GetFilteredData() const {
   // Get median value based on their norm.
-  auto median_it = buffer_.begin();
-  for (const auto norm : norms_) {
-    if (norm == median_norm) {
-      break;
-    }
-    ++median_it;
-  }
-
-  return *median_it;
+  return buffer_.AtSlot(sorted_norms_[filter_size_ / 2].slot);
 }
 
 void MedianFilter::Reset() {
-  buffer_.clear();
-  norms_.clear();
+  buffer_.Clear();
+  sorted_norms_.clear();
 }
 
 }  // namespace cardboard
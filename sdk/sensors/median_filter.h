@@ -16,13 +16,17 @@
 #ifndef CARDBOARD_SDK_SENSORS_MEDIAN_FILTER_H_
 #define CARDBOARD_SDK_SENSORS_MEDIAN_FILTER_H_
 
-#include <deque>
+#include <cstddef>
+#include <vector>
 
+#include "util/ring_buffer.h"
 #include "util/vector.h"
 
 namespace cardboard {
 
 // Fixed window FIFO median filter for vectors of the given dimension = 3.
+// Samples are ordered by their norm. The ordering is kept up to date as
+// samples are added, so reading the median does not sort nor allocate.
 class MedianFilter {
  public:
   // Creates a median filter of size filter_size.
@@ -42,10 +46,17 @@ class MedianFilter {
   void Reset();
 
  private:
+  // Norm of a sample and the buffer_ slot where the sample is stored.
+  struct NormEntry {
+    float norm;
+    size_t slot;
+  };
+
   const size_t filter_size_;
-  std::deque<Vector3> buffer_;
-  // Contains norms of the elements stored in buffer_.
-  std::deque<float> norms_;
+  RingBuffer<Vector3> buffer_;
+  // Contains norms of the elements stored in buffer_ sorted in ascending
+  // order. Its capacity is reserved at construction so it never reallocates.
+  std::vector<NormEntry> sorted_norms_;
 };
 
 }  // namespace cardboard
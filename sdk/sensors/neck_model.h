@@ -30,7 +30,7 @@ constexpr float kDefaultNeckHorizontalOffset = -0.080f;  // meters in Z
 constexpr float kDefaultNeckVerticalOffset = 0.075f;     // meters in Y
 
 // ApplyNeckModel applies a neck model offset based on the rotation of
-// |orientation|.
+// |orientation|, which must be a unit quaternion.
 // The value of |factor| is clamped from zero to one.
 std::array<float, 3> ApplyNeckModel(const std::array<float, 4>& orientation,
                                     double factor);
@@ -16,35 +16,52 @@
 #include "sensors/pose_prediction.h"
 
 #include <chrono>  // NOLINT
+#include <cmath>
 
-#include "util/logging.h"
 #include "util/vectorutils.h"
 
 namespace cardboard {
 
 namespace {
-const double kEpsilon = 1e-15;
+// Largest squared half rotation angle, in radians^2, for which the rotation is
+// built from the truncated Taylor series below. It corresponds to a rotation
+// of 1 rad, i.e. more than 100 ms at 10 rad/s, where the truncation error of
+// the series is below 3e-10. Larger rotations use the exact axis and angle
+// path.
+const double kMaxPolynomialHalfAngleSquared = 0.25;
 }  // namespace
 
 namespace pose_prediction {
 
 Rotation GetRotationFromGyroscope(const Vector3& gyroscope_value,
                                   double timestep_s) {
-  const double velocity = Length(gyroscope_value);
-
-  // When there is no rotation data return an identity rotation.
-  if (velocity < kEpsilon) {
-    CARDBOARD_LOGI(
-        "PosePrediction::GetRotationFromGyroscope: Velocity really small, "
-        "returning identity rotation.");
-    return Rotation::Identity();
-  }
   // Since the gyroscope_value is a start from sensor transformation we need to
   // invert it to have a sensor from start transformation, hence the minus sign.
   // For more info:
   // http://developer.android.com/guide/topics/sensors/sensors_motion.html#sensors-motion-gyro
-  return Rotation::FromAxisAndAngle(gyroscope_value / velocity,
-                                    -timestep_s * velocity);
+  const Vector3 half_rotation = gyroscope_value * (-0.5 * timestep_s);
+  const double half_angle_squared = Dot(half_rotation, half_rotation);
+  if (half_angle_squared > kMaxPolynomialHalfAngleSquared) {
+    return Rotation::FromAxisAndAngle(half_rotation,
+                                      2.0 * std::sqrt(half_angle_squared));
+  }
+
+  // Exponential map of the rotation vector: the quaternion is
+  // [sin(h) / h * half_rotation, cos(h)] with h = |half_rotation|. Both terms
+  // only depend on h^2, so they are evaluated as Taylor polynomials in h^2,
+  // which needs neither a square root nor a division and is exact (identity)
+  // for a zero velocity.
+  const double h2 = half_angle_squared;
+  const double sin_h_over_h =
+      1.0 +
+      h2 * (-1.0 / 6.0 +
+            h2 * (1.0 / 120.0 + h2 * (-1.0 / 5040.0 + h2 * (1.0 / 362880.0))));
+  const double cos_h =
+      1.0 +
+      h2 * (-1.0 / 2.0 +
+            h2 * (1.0 / 24.0 + h2 * (-1.0 / 720.0 + h2 * (1.0 / 40320.0))));
+  return Rotation::FromQuaternion(
+      Rotation::QuaternionType(half_rotation * sin_h_over_h, cos_h));
 }
 
 Rotation PredictPose(int64_t requested_pose_timestamp,
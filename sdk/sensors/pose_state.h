@@ -38,6 +38,9 @@ struct PoseState {
   // First derivative of the rotation.
   Vector3 sensor_from_start_rotation_velocity;
 
+  // Second derivative of the rotation, low-pass filtered.
+  Vector3 sensor_from_start_rotation_acceleration = Vector3(0, 0, 0);
+
   // Current gyroscope bias in rad/s.
   Vector3 bias;
 
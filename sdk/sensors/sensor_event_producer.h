@@ -47,6 +47,17 @@ class SensorEventProducer {
   // running. This method blocks until the sensor capture thread is finished.
   void StopSensorPolling();
 
+  // Requests a sampling period for the sensor. The request is applied
+  // asynchronously and persists across polling restarts.
+  //
+  // @param sampling_period_us requested period between sensor events in
+  //     microseconds. Zero requests the fastest rate supported by the sensor.
+  void SetSamplingPeriod(int sampling_period_us);
+
+  // Returns the sampling period currently applied to the sensor in
+  // microseconds, or zero when the sensor is not polled.
+  int GetSamplingPeriod() const;
+
  private:
   // Internal function to start sensor polling with the assumption that the lock
   // has already been obtained. Not implemented for iOS.
@@ -22,6 +22,8 @@
 #include "sensors/gyroscope_data.h"
 #include "sensors/pose_prediction.h"
 #include "util/matrixutils.h"
+#include "util/metrics.h"
+#include "util/trace.h"
 
 namespace cardboard {
 
@@ -51,6 +53,31 @@ const double kMaxAccelNormChange = 0.15;
 const double kTimestepFilterCoeff = 0.95;
 // Minimum number of sample for timestep filtering.
 const int kTimestepFilterMinSamples = 10;
+// Cutoff frequency of the angular acceleration filter. Head motion has little
+// energy above it, whereas differentiating the gyroscope noise amplifies it.
+const double kAngularAccelerationCutoffFrequency_hz = 5.0;
+// Time the bias estimator must continuously consider the device static before
+// tracking enters low power mode.
+const uint64_t kLowPowerTrackingDelay_ns = 2000000000;
+// Motion detector thresholds in low power tracking mode. A gyroscope sample
+// whose bias corrected norm, or an accelerometer sample whose distance to the
+// static reference, exceeds its threshold resumes full fusion. They are close
+// to the thresholds the bias estimator uses to detect static frames.
+const double kLowPowerGyroscopeMotionThreshold = 0.05;
+const double kLowPowerAccelerometerMotionThreshold = 0.5;
+// Maximum timestep integrated while the gyroscope runs at the low power
+// sampling period, or right after it. It is well above that period and only
+// truncates actual gaps, e.g. when the sensors were paused.
+const double kMaximumLowPowerGyroscopeTimestep_s = 0.2;
+// After low power tracking, gyroscope samples are considered back at the full
+// rate once their timestep is within this factor of the full rate timestep.
+const double kFullRateGyroscopeTimestepTolerance = 2.0;
+
+// Accelerometer residual, in radians, above which the accelerometer correction
+// rate rises above the set one, in proportion to the residual. It is above the
+// residual of accelerometer noise averaged between corrections, so that the
+// rate only rises when the pose actually drifted from gravity.
+const double kAccelerometerResidualThreshold = 0.02;
 
 // Z direction in start space.
 const Vector3 kCanonicalZDirection(0.0, 0.0, 1.0);
@@ -70,9 +97,19 @@ Rotation RotationFromVector(const Vector3& a) {
 }  // namespace
 
 SensorFusionEkf::SensorFusionEkf()
-    : execute_reset_with_next_accelerometer_sample_(false),
+    : angular_acceleration_filter_(kAngularAccelerationCutoffFrequency_hz),
+      accelerometer_correction_period_ns_(0),
+      execute_reset_with_next_accelerometer_sample_(false),
       bias_estimation_enabled_(true),
-      gyroscope_bias_estimate_({0, 0, 0}) {
+      gyroscope_bias_estimate_({0, 0, 0}),
+      initial_gyroscope_bias_({0, 0, 0}),
+      has_converged_gyroscope_bias_(false),
+      is_device_static_(false),
+      is_low_power_tracking_(false),
+      static_since_timestamp_ns_(0),
+      low_power_reference_accelerometer_({0, 0, 0}),
+      previous_gyroscope_sample_({0, 0, 0}),
+      use_measured_gyroscope_timestep_(false) {
   ResetState();
 }
 
@@ -83,15 +120,22 @@ void SensorFusionEkf::Reset() {
 void SensorFusionEkf::ResetState() {
   current_state_.sensor_from_start_rotation = Rotation::Identity();
   current_state_.sensor_from_start_rotation_velocity = Vector3::Zero();
+  current_state_.sensor_from_start_rotation_acceleration = Vector3::Zero();
+  angular_acceleration_filter_.Reset();
+  has_previous_gyroscope_sample_ = false;
+  use_measured_gyroscope_timestep_ = false;
 
   current_gyroscope_sensor_timestamp_ns_ = 0;
   current_accelerometer_sensor_timestamp_ns_ = 0;
 
-  state_covariance_ = Matrix3x3::Identity() * kInitialStateCovarianceValue;
-  process_covariance_ = Matrix3x3::Identity() * kInitialProcessCovarianceValue;
+  state_covariance_ =
+      SymmetricMatrix3x3::Identity() * kInitialStateCovarianceValue;
+  process_covariance_ =
+      SymmetricMatrix3x3::Identity() * kInitialProcessCovarianceValue;
   accelerometer_measurement_covariance_ =
-      Matrix3x3::Identity() * kMinAccelNoiseSigma * kMinAccelNoiseSigma;
-  innovation_covariance_ = Matrix3x3::Identity();
+      SymmetricMatrix3x3::Identity() *
+      (kMinAccelNoiseSigma * kMinAccelNoiseSigma);
+  innovation_covariance_ = SymmetricMatrix3x3::Identity();
 
   accelerometer_measurement_jacobian_ = Matrix3x3::Zero();
   kalman_gain_ = Matrix3x3::Zero();
@@ -102,14 +146,24 @@ void SensorFusionEkf::ResetState() {
   state_update_ = Vector3::Zero();
 
   moving_average_accelerometer_norm_change_ = 0.0;
+  moving_average_accelerometer_residual_ = 0.0;
+
+  last_accelerometer_correction_timestamp_ns_ = 0;
+  accumulated_accelerometer_samples_ = Vector3::Zero();
+  num_accumulated_accelerometer_samples_ = 0;
 
   is_timestep_filter_initialized_ = false;
   is_gyroscope_filter_valid_ = false;
   is_aligned_with_gravity_ = false;
 
   // Reset biases.
-  gyroscope_bias_estimator_.Reset();
-  gyroscope_bias_estimate_ = {0, 0, 0};
+  gyroscope_bias_worker_.Reset();
+  gyroscope_bias_estimate_ = initial_gyroscope_bias_;
+  has_converged_gyroscope_bias_ = false;
+  is_device_static_ = false;
+
+  is_low_power_tracking_ = false;
+  static_since_timestamp_ns_ = 0;
 }
 
 // Here I am doing something wrong relative to time stamps. The state timestamps
@@ -121,6 +175,8 @@ PoseState SensorFusionEkf::GetLatestPoseState() const {
 }
 
 void SensorFusionEkf::ProcessGyroscopeSample(const GyroscopeData& sample) {
+  CARDBOARD_TRACE_SCOPE("SensorFusionEkf::ProcessGyroscopeSample");
+  Metrics::ScopedTimer fusion_timer(Metrics::Timing::kFusion);
   std::unique_lock<std::mutex> lock(mutex_);
 
   // Don't accept gyroscope sample when waiting for a reset.
@@ -130,63 +186,99 @@ void SensorFusionEkf::ProcessGyroscopeSample(const GyroscopeData& sample) {
 
   // Discard outdated samples.
   if (current_gyroscope_sensor_timestamp_ns_ >= sample.sensor_timestamp_ns) {
+    Metrics::GetInstance().RecordOutdatedGyroscopeSample();
     return;
   }
+  Metrics::GetInstance().RecordGyroscopeSample(sample.sensor_timestamp_ns);
+
+  if (is_low_power_tracking_) {
+    const Vector3 rotation_velocity = sample.data - gyroscope_bias_estimate_;
+    if (LengthSquared(rotation_velocity) <
+        kLowPowerGyroscopeMotionThreshold * kLowPowerGyroscopeMotionThreshold) {
+      // Slow motion below the threshold is still integrated, without bias
+      // estimation nor angular acceleration.
+      IntegrateGyroscopeSample(
+          rotation_velocity,
+          std::min(GetGyroscopeTimestep(sample.sensor_timestamp_ns),
+                   kMaximumLowPowerGyroscopeTimestep_s));
+      current_state_.timestamp = sample.system_timestamp;
+      current_gyroscope_sensor_timestamp_ns_ = sample.sensor_timestamp_ns;
+      current_state_.sensor_from_start_rotation_velocity = rotation_velocity;
+      return;
+    }
+    ExitLowPowerTracking();
+  }
 
+  // Time since the previous gyroscope sample, zero for the first one.
+  double current_timestep_s = 0.0;
   // Checks that we received at least one gyroscope sample in the past.
   if (current_gyroscope_sensor_timestamp_ns_ != 0) {
-    double current_timestep_s =
-        std::chrono::duration_cast<std::chrono::duration<double>>(
-            std::chrono::nanoseconds(sample.sensor_timestamp_ns -
-                                     current_gyroscope_sensor_timestamp_ns_))
-            .count();
+    current_timestep_s = GetGyroscopeTimestep(sample.sensor_timestamp_ns);
     if (current_timestep_s > kMaximumGyroscopeSampleDelay_s) {
-      if (is_gyroscope_filter_valid_) {
-        // Replaces the delta timestamp by the filtered estimates of the delta
-        // time.
-        current_timestep_s = filtered_gyroscope_timestep_s_;
-      } else {
-        current_timestep_s = kDefaultGyroscopeTimestep_s;
-      }
+      // The previous sample is too old to be differentiated with.
+      has_previous_gyroscope_sample_ = false;
+    }
+    const double full_rate_timestep_s = is_gyroscope_filter_valid_
+                                            ? filtered_gyroscope_timestep_s_
+                                            : kDefaultGyroscopeTimestep_s;
+    if (use_measured_gyroscope_timestep_ &&
+        current_timestep_s >
+            kFullRateGyroscopeTimestepTolerance * full_rate_timestep_s) {
+      // Samples are sparse in low power tracking mode and until the sensors
+      // are back at their full rate after it, so the long timestep is
+      // expected and the motion it covers actually happened. It is not
+      // filtered either, as it is not representative of the full rate.
+      current_timestep_s =
+          std::min(current_timestep_s, kMaximumLowPowerGyroscopeTimestep_s);
+    } else if (current_timestep_s > kMaximumGyroscopeSampleDelay_s) {
+      Metrics::GetInstance().RecordGyroscopeTimestepFallback();
+      // Replaces the delta timestamp by the filtered estimates of the delta
+      // time.
+      current_timestep_s = full_rate_timestep_s;
     } else {
+      use_measured_gyroscope_timestep_ = false;
       FilterGyroscopeTimestep(current_timestep_s);
     }
 
     if (bias_estimation_enabled_) {
-      gyroscope_bias_estimator_.ProcessGyroscope(sample.data,
-                                                 sample.sensor_timestamp_ns);
+      gyroscope_bias_worker_.ProcessGyroscope(sample.data,
+                                              sample.sensor_timestamp_ns);
 
-      if (gyroscope_bias_estimator_.IsCurrentEstimateValid()) {
+      const GyroscopeBiasWorker::Estimate estimate =
+          gyroscope_bias_worker_.GetLatestEstimate();
+      if (estimate.is_valid) {
         // As soon as the device is considered to be static, the bias estimator
         // should have a precise estimate of the gyroscope bias.
-        gyroscope_bias_estimate_ = gyroscope_bias_estimator_.GetGyroscopeBias();
+        gyroscope_bias_estimate_ = estimate.gyroscope_bias;
+        has_converged_gyroscope_bias_ = true;
       }
+      is_device_static_ = estimate.is_static;
     }
 
-    // Only integrate after receiving a accelerometer sample.
-    if (is_aligned_with_gravity_) {
-      const Rotation rotation_from_gyroscope =
-          pose_prediction::GetRotationFromGyroscope(
-              {sample.data[0] - gyroscope_bias_estimate_[0],
-               sample.data[1] - gyroscope_bias_estimate_[1],
-               sample.data[2] - gyroscope_bias_estimate_[2]},
-              current_timestep_s);
-      current_state_.sensor_from_start_rotation =
-          rotation_from_gyroscope * current_state_.sensor_from_start_rotation;
-      UpdateStateCovariance(RotationMatrixNH(rotation_from_gyroscope));
-      state_covariance_ =
-          state_covariance_ +
-          ((current_timestep_s * current_timestep_s) * process_covariance_);
-    }
+    IntegrateGyroscopeSample(sample.data - gyroscope_bias_estimate_,
+                             current_timestep_s);
   }
 
+  // The raw samples are differentiated, rather than the bias corrected ones,
+  // so that bias estimate updates do not show up as angular acceleration.
+  if (has_previous_gyroscope_sample_ && current_timestep_s > 0.0) {
+    angular_acceleration_filter_.AddSample(
+        (sample.data - previous_gyroscope_sample_) / current_timestep_s,
+        sample.sensor_timestamp_ns);
+    current_state_.sensor_from_start_rotation_acceleration =
+        angular_acceleration_filter_.GetFilteredData();
+  }
+  previous_gyroscope_sample_ = sample.data;
+  has_previous_gyroscope_sample_ = true;
+
+  const Vector3 rotation_velocity = sample.data - gyroscope_bias_estimate_;
+
   // Saves gyroscope event for future prediction.
   current_state_.timestamp = sample.system_timestamp;
   current_gyroscope_sensor_timestamp_ns_ = sample.sensor_timestamp_ns;
-  current_state_.sensor_from_start_rotation_velocity.Set(
-      sample.data[0] - gyroscope_bias_estimate_[0],
-      sample.data[1] - gyroscope_bias_estimate_[1],
-      sample.data[2] - gyroscope_bias_estimate_[2]);
+  current_state_.sensor_from_start_rotation_velocity = rotation_velocity;
+
+  UpdateLowPowerTracking(sample.sensor_timestamp_ns);
 }
 
 Vector3 SensorFusionEkf::ComputeInnovation(const Rotation& pose) {
@@ -219,26 +311,40 @@ void SensorFusionEkf::ComputeMeasurementJacobian() {
 
 void SensorFusionEkf::ProcessAccelerometerSample(
     const AccelerometerData& sample) {
+  CARDBOARD_TRACE_SCOPE("SensorFusionEkf::ProcessAccelerometerSample");
+  Metrics::ScopedTimer fusion_timer(Metrics::Timing::kFusion);
   std::unique_lock<std::mutex> lock(mutex_);
 
   // Discard outdated samples.
   if (current_accelerometer_sensor_timestamp_ns_ >=
       sample.sensor_timestamp_ns) {
+    Metrics::GetInstance().RecordOutdatedAccelerometerSample();
     return;
   }
+  Metrics::GetInstance().RecordAccelerometerSample(sample.sensor_timestamp_ns);
 
   // Call reset state if required.
   if (execute_reset_with_next_accelerometer_sample_.exchange(false)) {
     ResetState();
   }
 
+  if (is_low_power_tracking_) {
+    if (LengthSquared(sample.data - low_power_reference_accelerometer_) <
+        kLowPowerAccelerometerMotionThreshold *
+            kLowPowerAccelerometerMotionThreshold) {
+      current_accelerometer_sensor_timestamp_ns_ = sample.sensor_timestamp_ns;
+      return;
+    }
+    ExitLowPowerTracking();
+  }
+
   accelerometer_measurement_.Set(sample.data[0], sample.data[1],
                                  sample.data[2]);
   current_accelerometer_sensor_timestamp_ns_ = sample.sensor_timestamp_ns;
 
   if (bias_estimation_enabled_) {
-    gyroscope_bias_estimator_.ProcessAccelerometer(sample.data,
-                                                   sample.sensor_timestamp_ns);
+    gyroscope_bias_worker_.ProcessAccelerometer(sample.data,
+                                                sample.sensor_timestamp_ns);
   }
 
   if (!is_aligned_with_gravity_) {
@@ -249,32 +355,56 @@ void SensorFusionEkf::ProcessAccelerometerSample(
     is_aligned_with_gravity_ = true;
 
     previous_accelerometer_norm_ = Length(accelerometer_measurement_);
+    last_accelerometer_correction_timestamp_ns_ = sample.sensor_timestamp_ns;
     return;
   }
 
+  // Pre-averages the samples received until the next correction is due.
+  accumulated_accelerometer_samples_ += sample.data;
+  ++num_accumulated_accelerometer_samples_;
+  if (sample.sensor_timestamp_ns - last_accelerometer_correction_timestamp_ns_ <
+      GetAccelerometerCorrectionPeriod()) {
+    return;
+  }
+  accelerometer_measurement_ =
+      accumulated_accelerometer_samples_ /
+      static_cast<double>(num_accumulated_accelerometer_samples_);
+  accumulated_accelerometer_samples_ = Vector3::Zero();
+  num_accumulated_accelerometer_samples_ = 0;
+  last_accelerometer_correction_timestamp_ns_ = sample.sensor_timestamp_ns;
+
   UpdateMeasurementCovariance();
 
   innovation_ = ComputeInnovation(current_state_.sensor_from_start_rotation);
+  moving_average_accelerometer_residual_ =
+      kSmoothingFactor * Length(innovation_) +
+      (1. - kSmoothingFactor) * moving_average_accelerometer_residual_;
   ComputeMeasurementJacobian();
 
   // S = H * P * H' + R
-  innovation_covariance_ = accelerometer_measurement_jacobian_ *
-                               state_covariance_ *
-                               Transpose(accelerometer_measurement_jacobian_) +
-                           accelerometer_measurement_covariance_;
-
-  // K = P * H' * S^-1
-  kalman_gain_ = state_covariance_ *
-                 Transpose(accelerometer_measurement_jacobian_) *
-                 Inverse(innovation_covariance_);
+  innovation_covariance_ =
+      CongruenceTransform(accelerometer_measurement_jacobian_,
+                          state_covariance_) +
+      accelerometer_measurement_covariance_;
+
+  // K = P * H' * S^-1. S is symmetric positive definite as long as R is, so
+  // solve through its Cholesky factor rather than forming the inverse. Skip
+  // the correction if S is numerically singular.
+  if (!SolveRightWithCholesky(
+          innovation_covariance_,
+          state_covariance_ * Transpose(accelerometer_measurement_jacobian_),
+          &kalman_gain_)) {
+    return;
+  }
 
   // x_update = K*nu
   state_update_ = kalman_gain_ * innovation_;
 
-  // P = (I - K * H) * P;
-  state_covariance_ = (Matrix3x3::Identity() -
-                       kalman_gain_ * accelerometer_measurement_jacobian_) *
-                      state_covariance_;
+  // P = (I - K * H) * P * (I - K * H)' + K * R * K' (Joseph form, which keeps
+  // P symmetric positive semi-definite).
+  state_covariance_ = JosephCovarianceUpdate(
+      state_covariance_, kalman_gain_, accelerometer_measurement_jacobian_,
+      accelerometer_measurement_covariance_);
 
   // Updates pose and associate covariance matrix.
   const Rotation rotation_from_state_update = RotationFromVector(state_update_);
@@ -284,9 +414,71 @@ void SensorFusionEkf::ProcessAccelerometerSample(
   UpdateStateCovariance(RotationMatrixNH(rotation_from_state_update));
 }
 
-void SensorFusionEkf::UpdateStateCovariance(const Matrix3x3& motion_update) {
+double SensorFusionEkf::GetGyroscopeTimestep(uint64_t timestamp_ns) const {
+  return std::chrono::duration_cast<std::chrono::duration<double>>(
+             std::chrono::nanoseconds(timestamp_ns -
+                                      current_gyroscope_sensor_timestamp_ns_))
+      .count();
+}
+
+void SensorFusionEkf::IntegrateGyroscopeSample(const Vector3& rotation_velocity,
+                                               double timestep_s) {
+  // Only integrate after receiving a accelerometer sample.
+  if (!is_aligned_with_gravity_) {
+    return;
+  }
+  const Rotation rotation_from_gyroscope =
+      pose_prediction::GetRotationFromGyroscope(rotation_velocity, timestep_s);
+  current_state_.sensor_from_start_rotation =
+      rotation_from_gyroscope * current_state_.sensor_from_start_rotation;
+  UpdateStateCovariance(RotationMatrixNH(rotation_from_gyroscope));
   state_covariance_ =
-      motion_update * state_covariance_ * Transpose(motion_update);
+      state_covariance_ + ((timestep_s * timestep_s) * process_covariance_);
+}
+
+void SensorFusionEkf::UpdateStateCovariance(const Matrix3x3& motion_update) {
+  state_covariance_ = CongruenceTransform(motion_update, state_covariance_);
+}
+
+void SensorFusionEkf::UpdateLowPowerTracking(uint64_t timestamp_ns) {
+  if (!is_device_static_ || !is_aligned_with_gravity_) {
+    static_since_timestamp_ns_ = 0;
+    return;
+  }
+  if (static_since_timestamp_ns_ == 0) {
+    static_since_timestamp_ns_ = timestamp_ns;
+    return;
+  }
+  if (timestamp_ns - static_since_timestamp_ns_ < kLowPowerTrackingDelay_ns) {
+    return;
+  }
+
+  // Gyroscope samples are still integrated, at the low power sampling period,
+  // but the angular acceleration is no longer estimated. The derivatives are
+  // zeroed so predictions do not extrapolate stale ones.
+  current_state_.sensor_from_start_rotation_velocity = Vector3::Zero();
+  current_state_.sensor_from_start_rotation_acceleration = Vector3::Zero();
+  angular_acceleration_filter_.Reset();
+  has_previous_gyroscope_sample_ = false;
+  use_measured_gyroscope_timestep_ = true;
+  accumulated_accelerometer_samples_ = Vector3::Zero();
+  num_accumulated_accelerometer_samples_ = 0;
+  low_power_reference_accelerometer_ = accelerometer_measurement_;
+  is_low_power_tracking_ = true;
+}
+
+void SensorFusionEkf::ExitLowPowerTracking() {
+  is_low_power_tracking_ = false;
+  static_since_timestamp_ns_ = 0;
+  has_previous_gyroscope_sample_ = false;
+  // Samples from before the pause must not be averaged into the first
+  // correction after it, which is applied with the next accelerometer sample.
+  accumulated_accelerometer_samples_ = Vector3::Zero();
+  num_accumulated_accelerometer_samples_ = 0;
+  last_accelerometer_correction_timestamp_ns_ = 0;
+  // The latest estimate was computed before the pause of the bias estimator
+  // and may still report the device static.
+  is_device_static_ = false;
 }
 
 void SensorFusionEkf::FilterGyroscopeTimestep(double gyroscope_timestep_s) {
@@ -331,9 +523,45 @@ void SensorFusionEkf::UpdateMeasurementCovariance() {
           norm_change_ratio * (kMaxAccelNoiseSigma - kMinAccelNoiseSigma));
 
   // Updates the accel covariance matrix with the new sigma value.
-  accelerometer_measurement_covariance_ = Matrix3x3::Identity() *
-                                          accelerometer_noise_sigma *
-                                          accelerometer_noise_sigma;
+  accelerometer_measurement_covariance_ =
+      SymmetricMatrix3x3::Identity() *
+      (accelerometer_noise_sigma * accelerometer_noise_sigma);
+}
+
+uint64_t SensorFusionEkf::GetAccelerometerCorrectionPeriod() const {
+  if (moving_average_accelerometer_residual_ <=
+      kAccelerometerResidualThreshold) {
+    return accelerometer_correction_period_ns_;
+  }
+  // The rate is proportional to the residual above the threshold.
+  return static_cast<uint64_t>(static_cast<double>(
+                                   accelerometer_correction_period_ns_) *
+                               (kAccelerometerResidualThreshold /
+                                moving_average_accelerometer_residual_));
+}
+
+void SensorFusionEkf::SetAccelerometerCorrectionRate(double rate_hz) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  accelerometer_correction_period_ns_ =
+      rate_hz > 0.0 ? static_cast<uint64_t>(1e9 / rate_hz) : 0;
+}
+
+void SensorFusionEkf::SetInitialGyroscopeBias(const Vector3& bias) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  initial_gyroscope_bias_ = bias;
+  gyroscope_bias_worker_.SetInitialGyroscopeBias(bias);
+  if (bias_estimation_enabled_ && !has_converged_gyroscope_bias_) {
+    gyroscope_bias_estimate_ = bias;
+  }
+}
+
+bool SensorFusionEkf::GetConvergedGyroscopeBias(Vector3* bias) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!has_converged_gyroscope_bias_) {
+    return false;
+  }
+  *bias = gyroscope_bias_estimate_;
+  return true;
 }
 
 bool SensorFusionEkf::IsBiasEstimationEnabled() const {
@@ -341,10 +569,15 @@ bool SensorFusionEkf::IsBiasEstimationEnabled() const {
 }
 
 void SensorFusionEkf::SetBiasEstimationEnabled(bool enable) {
+  std::unique_lock<std::mutex> lock(mutex_);
   if (bias_estimation_enabled_ != enable) {
     bias_estimation_enabled_ = enable;
-    gyroscope_bias_estimate_ = {0, 0, 0};
-    gyroscope_bias_estimator_.Reset();
+    gyroscope_bias_estimate_ =
+        enable ? initial_gyroscope_bias_ : Vector3::Zero();
+    has_converged_gyroscope_bias_ = false;
+    gyroscope_bias_worker_.Reset();
+    // Low power tracking relies on the bias estimator static detection.
+    ExitLowPowerTracking();
   }
 }
 
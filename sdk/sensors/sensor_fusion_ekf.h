@@ -22,11 +22,13 @@
 #include <mutex>  // NOLINT
 
 #include "sensors/accelerometer_data.h"
-#include "sensors/gyroscope_bias_estimator.h"
+#include "sensors/gyroscope_bias_worker.h"
 #include "sensors/gyroscope_data.h"
+#include "sensors/lowpass_filter.h"
 #include "sensors/pose_state.h"
 #include "util/matrix_3x3.h"
 #include "util/rotation.h"
+#include "util/symmetric_matrix_3x3.h"
 #include "util/vector.h"
 
 namespace cardboard {
@@ -66,6 +68,17 @@ class SensorFusionEkf {
   // @param sample accelerometer sample data.
   void ProcessAccelerometerSample(const AccelerometerData& sample);
 
+  // Sets the rate at which accelerometer measurements correct the pose.
+  // Accelerometer samples received between two corrections are averaged and
+  // the average is used as measurement. Gyroscope integration and bias
+  // estimation still run for every sample. The rate rises above the set one
+  // while the accelerometer residual, the angle between the measured and the
+  // predicted gravity, is large, e.g. after the gyroscope drifted.
+  //
+  // @param rate_hz minimum correction rate in Hz. Zero or a negative value
+  //     corrects with every accelerometer sample, which is the default.
+  void SetAccelerometerCorrectionRate(double rate_hz);
+
   // Enables or disables the drift correction by estimating the gyroscope bias.
   //
   // @param enable Enable drift correction.
@@ -76,24 +89,71 @@ class SensorFusionEkf {
   // @return true if bias estimation is enabled, false otherwise.
   bool IsBiasEstimationEnabled() const;
 
-  // Returns the current gyroscope bias estimate from GyroscopeBiasEstimator.
+  // Returns the current gyroscope bias estimate from GyroscopeBiasWorker.
   Vector3 GetGyroscopeBias() const {
     std::unique_lock<std::mutex> lock(mutex_);
     return {gyroscope_bias_estimate_[0], gyroscope_bias_estimate_[1],
             gyroscope_bias_estimate_[2]};
   }
 
+  // Seeds the gyroscope bias with a prior estimate, e.g. provided by the system
+  // or saved by a previous session. It is used to correct gyroscope samples
+  // until GyroscopeBiasWorker has a valid estimate, and as the starting
+  // point of that estimate.
+  //
+  // @param bias initial gyroscope bias in radians/sec.
+  void SetInitialGyroscopeBias(const Vector3& bias);
+
+  // Gets the gyroscope bias estimate if GyroscopeBiasWorker reported a valid
+  // estimate since the last reset.
+  //
+  // @param bias output gyroscope bias in radians/sec.
+  // @return true if a valid estimate was available.
+  bool GetConvergedGyroscopeBias(Vector3* bias) const;
+
   // Returns true after receiving the first accelerometer measurement.
   bool IsFullyInitialized() const { return is_aligned_with_gravity_; }
 
+  // Returns true if the bias estimator currently considers the device static.
+  // It is always false when bias estimation is disabled.
+  bool IsDeviceStatic() const { return is_device_static_; }
+
+  // Returns true if tracking is in low power mode. Once the bias estimator
+  // has considered the device static for a while, gyroscope samples are only
+  // integrated, without bias estimation nor accelerometer correction, and
+  // samples go through a cheap motion detector, until one of them deviates
+  // from the static reference and full fusion resumes with that sample.
+  bool IsLowPowerTracking() const { return is_low_power_tracking_; }
+
  private:
   // Estimates the average timestep between gyroscope event.
   void FilterGyroscopeTimestep(double gyroscope_timestep);
 
+  // Returns the time in seconds between the latest processed gyroscope sample
+  // and the given sensor timestamp.
+  double GetGyroscopeTimestep(uint64_t timestamp_ns) const;
+
+  // Integrates a bias corrected gyroscope sample into the pose and the state
+  // covariance. It is a no-op until the first accelerometer sample.
+  //
+  // @param rotation_velocity bias corrected angular velocity in radians/sec.
+  // @param timestep_s integration timestep in seconds.
+  void IntegrateGyroscopeSample(const Vector3& rotation_velocity,
+                                double timestep_s);
+
   // Updates the state covariance with an incremental motion. It changes the
   // space of the quadric.
   void UpdateStateCovariance(const Matrix3x3& motion_update);
 
+  // Enters low power tracking once the device has been static for long enough.
+  // Must be called with mutex_ held, after a gyroscope sample was processed.
+  //
+  // @param timestamp_ns sensor time of the processed gyroscope sample.
+  void UpdateLowPowerTracking(uint64_t timestamp_ns);
+
+  // Leaves low power tracking. Must be called with mutex_ held.
+  void ExitLowPowerTracking();
+
   // Computes the innovation vector of the Kalman based on the input pose.
   // It uses the latest measurement vector (i.e. accelerometer data), which must
   // be set prior to calling this function.
@@ -110,6 +170,10 @@ class SensorFusionEkf {
   // just gravity, and so the down vector information gravity signal is noisier.
   void UpdateMeasurementCovariance();
 
+  // Returns the time between two accelerometer corrections in nanoseconds,
+  // which is shortened while the accelerometer residual is large.
+  uint64_t GetAccelerometerCorrectionPeriod() const;
+
   // Reset all internal states. This is not thread safe. Lock should be acquired
   // outside of it. This function is called in ProcessAccelerometerSample.
   void ResetState();
@@ -128,13 +192,13 @@ class SensorFusionEkf {
   std::atomic<bool> is_aligned_with_gravity_;
 
   // Covariance of Kalman filter state (P in common formulation).
-  Matrix3x3 state_covariance_;
+  SymmetricMatrix3x3 state_covariance_;
   // Covariance of the process noise (Q in common formulation).
-  Matrix3x3 process_covariance_;
+  SymmetricMatrix3x3 process_covariance_;
   // Covariance of the accelerometer measurement (R in common formulation).
-  Matrix3x3 accelerometer_measurement_covariance_;
+  SymmetricMatrix3x3 accelerometer_measurement_covariance_;
   // Covariance of innovation (S in common formulation).
-  Matrix3x3 innovation_covariance_;
+  SymmetricMatrix3x3 innovation_covariance_;
   // Jacobian of the measurements (H in common formulation).
   Matrix3x3 accelerometer_measurement_jacobian_;
   // Gain of the Kalman filter (K in common formulation).
@@ -160,12 +224,27 @@ class SensorFusionEkf {
   double filtered_gyroscope_timestep_s_;
   // Number of timestep samples processed so far by the filter.
   uint32_t num_gyroscope_timestep_samples_;
+  // Filters the finite differences of the gyroscope samples.
+  LowpassFilter angular_acceleration_filter_;
   // Norm of the accelerometer for the previous measurement.
   double previous_accelerometer_norm_;
   // Moving average of the accelerometer norm changes. It is computed for every
-  // sensor datum.
+  // accelerometer correction.
   double moving_average_accelerometer_norm_change_;
 
+  // Time between two accelerometer corrections set by
+  // SetAccelerometerCorrectionRate() in nanoseconds.
+  uint64_t accelerometer_correction_period_ns_;
+  // Moving average of the accelerometer residual in radians. It is computed
+  // for every accelerometer correction.
+  double moving_average_accelerometer_residual_;
+  // Sensor time of the last accelerometer correction.
+  uint64_t last_accelerometer_correction_timestamp_ns_;
+  // Sum and number of the accelerometer samples received since the last
+  // correction.
+  Vector3 accumulated_accelerometer_samples_;
+  int num_accumulated_accelerometer_samples_;
+
   // Flag indicating if a state reset should be executed with the next
   // accelerometer sample.
   std::atomic<bool> execute_reset_with_next_accelerometer_sample_;
@@ -175,11 +254,41 @@ class SensorFusionEkf {
   // Flag indicating if bias estimation is enabled (enabled by default).
   std::atomic<bool> bias_estimation_enabled_;
 
-  // Bias estimator and static device detector.
-  GyroscopeBiasEstimator gyroscope_bias_estimator_;
+  // Bias estimator and static device detector. It runs on its own thread and
+  // only its latest estimate is read on the gyroscope path.
+  GyroscopeBiasWorker gyroscope_bias_worker_;
 
   // Current bias estimate_;
   Vector3 gyroscope_bias_estimate_;
+  // Prior bias estimate used until the bias estimator converges.
+  Vector3 initial_gyroscope_bias_;
+  // True if gyroscope_bias_estimate_ comes from a valid bias estimator
+  // estimate.
+  bool has_converged_gyroscope_bias_;
+
+  // Static device state reported by the bias estimator with the latest
+  // gyroscope sample.
+  std::atomic<bool> is_device_static_;
+
+  // Low power tracking state.
+  std::atomic<bool> is_low_power_tracking_;
+  // Sensor time of the first gyroscope sample of the current static period,
+  // zero if the device is not static.
+  uint64_t static_since_timestamp_ns_;
+  // Accelerometer sample the motion detector compares against in low power
+  // tracking mode.
+  Vector3 low_power_reference_accelerometer_;
+
+  // Previous gyroscope sample, the angular acceleration is differentiated
+  // from. It is invalid after a reset, around low power tracking and after a
+  // gap in the samples, until the next sample is processed.
+  Vector3 previous_gyroscope_sample_;
+  bool has_previous_gyroscope_sample_;
+
+  // True from low power tracking entry until gyroscope samples are back at the
+  // full rate. Long timesteps are then expected and integrated as measured,
+  // instead of being replaced by the filtered timestep.
+  bool use_measured_gyroscope_timestep_;
 
   SensorFusionEkf(const SensorFusionEkf&) = delete;
   SensorFusionEkf& operator=(const SensorFusionEkf&) = delete;
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensors/sensor_rate_policy.h"
+
+namespace cardboard {
+
+constexpr int SensorRatePolicy::kFullRateSamplingPeriodUs;
+constexpr int SensorRatePolicy::kReducedRateSamplingPeriodUs;
+constexpr int SensorRatePolicy::kLowPowerSamplingPeriodUs;
+
+SensorRatePolicy::SensorRatePolicy()
+    : is_device_static_(false),
+      is_low_power_tracking_(false),
+      hint_(Hint::kDefault),
+      sampling_period_us_(kFullRateSamplingPeriodUs) {}
+
+bool SensorRatePolicy::Update(bool is_device_static,
+                              bool is_low_power_tracking) {
+  if (is_device_static_ == is_device_static &&
+      is_low_power_tracking_ == is_low_power_tracking) {
+    return false;
+  }
+  is_device_static_ = is_device_static;
+  is_low_power_tracking_ = is_low_power_tracking;
+  return UpdateSamplingPeriod();
+}
+
+bool SensorRatePolicy::SetHint(Hint hint) {
+  if (hint_ == hint) {
+    return false;
+  }
+  hint_ = hint;
+  return UpdateSamplingPeriod();
+}
+
+int SensorRatePolicy::GetSamplingPeriodUs() const {
+  return sampling_period_us_;
+}
+
+bool SensorRatePolicy::UpdateSamplingPeriod() {
+  int sampling_period_us = kFullRateSamplingPeriodUs;
+  if (is_low_power_tracking_) {
+    sampling_period_us = kLowPowerSamplingPeriodUs;
+  } else if (hint_ != Hint::kDefault || is_device_static_) {
+    sampling_period_us = kReducedRateSamplingPeriodUs;
+  }
+  if (sampling_period_us_ == sampling_period_us) {
+    return false;
+  }
+  sampling_period_us_ = sampling_period_us;
+  return true;
+}
+
+}  // namespace cardboard
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_SENSORS_SENSOR_RATE_POLICY_H_
+#define CARDBOARD_SDK_SENSORS_SENSOR_RATE_POLICY_H_
+
+namespace cardboard {
+
+// Decides the sampling period requested to the accelerometer and gyroscope.
+// Sensors run at the fastest rate they support unless the device is static or
+// the app hints that it does not need low latency tracking, in which case they
+// run at a reduced rate. While tracking is in low power mode they run at an
+// even lower rate, only used to detect motion. The rate decided by the hint is
+// restored as soon as motion is detected.
+//
+// It is not thread-safe. HeadTracker serializes the updates from the sensor
+// thread and the app hints, together with the request of the resulting
+// sampling period to the sensors.
+class SensorRatePolicy {
+ public:
+  // Sampling rate needs of the app.
+  enum class Hint {
+    // Full rate unless the device is static.
+    kDefault,
+    // Reduced rate, e.g. when the app is showing a menu.
+    kLow,
+  };
+
+  // Sampling period that requests the fastest rate supported by the sensor.
+  static constexpr int kFullRateSamplingPeriodUs = 0;
+  // Sampling period used when full rate is not needed. This corresponds to
+  // 50 Hz, which is one of the update intervals supported by CMMotionManager.
+  static constexpr int kReducedRateSamplingPeriodUs = 20000;
+  // Sampling period used in low power tracking mode. This corresponds to
+  // 20 Hz, which bounds the delay to resume full rate tracking after the
+  // device starts moving to 50 ms.
+  static constexpr int kLowPowerSamplingPeriodUs = 50000;
+
+  SensorRatePolicy();
+
+  // Updates the policy with the latest device static and tracking states.
+  //
+  // @param is_device_static true if the device is currently considered static.
+  // @param is_low_power_tracking true if tracking is in low power mode.
+  // @return true if the requested sampling period changed.
+  bool Update(bool is_device_static, bool is_low_power_tracking);
+
+  // Sets the app hint.
+  //
+  // @param hint sampling rate needs of the app.
+  // @return true if the requested sampling period changed.
+  bool SetHint(Hint hint);
+
+  // Returns the sampling period in microseconds that should be requested to
+  // the sensors. kFullRateSamplingPeriodUs means the fastest rate.
+  int GetSamplingPeriodUs() const;
+
+ private:
+  // Recomputes sampling_period_us_ and returns true if it changed.
+  bool UpdateSamplingPeriod();
+
+  bool is_device_static_;
+  bool is_low_power_tracking_;
+  Hint hint_;
+  int sampling_period_us_;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_SENSORS_SENSOR_RATE_POLICY_H_
@@ -0,0 +1,373 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "rendering/compositor.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cardboard {
+namespace rendering {
+namespace {
+
+constexpr int64_t kPeriodNs = 16666667;
+
+// Gives a timeout to waits on the compositor thread, so that a broken
+// handoff fails the test instead of hanging it.
+constexpr std::chrono::seconds kTimeout(5);
+
+// Display clock ticking only when the test calls Tick().
+class FakeDisplayClock : public DisplayClock {
+ public:
+  int64_t WaitForNextFrame() override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    is_waiting_ = true;
+    state_changed_.notify_all();
+    state_changed_.wait(lock, [this]() {
+      return is_interrupted_ || granted_ticks_ > taken_ticks_;
+    });
+    is_waiting_ = false;
+    ++taken_ticks_;
+    return taken_ticks_ * kPeriodNs;
+  }
+
+  void Interrupt() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_interrupted_ = true;
+    state_changed_.notify_all();
+  }
+
+  // Lets the compositor compose one more frame.
+  void Tick() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++granted_ticks_;
+    state_changed_.notify_all();
+  }
+
+  // Waits until the compositor thread composed all ticks and waits for the
+  // next one, or the timeout expires.
+  bool WaitUntilIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return state_changed_.wait_for(lock, kTimeout, [this]() {
+      return is_waiting_ && granted_ticks_ == taken_ticks_;
+    });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable state_changed_;
+  int64_t granted_ticks_ = 0;
+  int64_t taken_ticks_ = 0;
+  bool is_waiting_ = false;
+  bool is_interrupted_ = false;
+};
+
+// Record of the presented frames and of the life of the fences of a
+// FakeBackend. It outlives the backend, which the compositor destroys.
+class BackendLog {
+ public:
+  enum class FenceState { kCreated, kWaited, kDestroyed, kEndedTwice };
+
+  struct Presentation {
+    int64_t render_timestamp_ns;
+    int64_t display_timestamp_ns;
+  };
+
+  void* CreateFence() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fences_.emplace_back(new int(static_cast<int>(fences_.size())));
+    fence_states_[fences_.back().get()] = FenceState::kCreated;
+    return fences_.back().get();
+  }
+
+  void EndFence(void* fence, FenceState state) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FenceState& fence_state = fence_states_.at(fence);
+    fence_state =
+        fence_state == FenceState::kCreated ? state : FenceState::kEndedTwice;
+  }
+
+  void AddPresentation(const Presentation& presentation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    presentations_.push_back(presentation);
+    presented_.notify_all();
+  }
+
+  // Waits until count frames were presented, or the timeout expires.
+  bool WaitForPresentations(size_t count,
+                            std::chrono::milliseconds timeout = kTimeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return presented_.wait_for(lock, timeout, [this, count]() {
+      return presentations_.size() >= count;
+    });
+  }
+
+  std::vector<Presentation> GetPresentations() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return presentations_;
+  }
+
+  // Returns the state of the index-th created fence.
+  FenceState GetFenceState(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fence_states_.at(fences_.at(index).get());
+  }
+
+  size_t GetFenceCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fences_.size();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable presented_;
+  std::vector<std::unique_ptr<int>> fences_;
+  std::map<void*, FenceState> fence_states_;
+  std::vector<Presentation> presentations_;
+};
+
+// Backend logging its calls to a BackendLog.
+class FakeBackend : public CompositorBackend {
+ public:
+  FakeBackend(BackendLog* log, bool initializes)
+      : log_(log), initializes_(initializes) {}
+
+  bool Initialize() override { return initializes_; }
+
+  void* CreateFence() override { return log_->CreateFence(); }
+
+  void WaitFence(void* fence) override {
+    log_->EndFence(fence, BackendLog::FenceState::kWaited);
+  }
+
+  void DestroyFence(void* fence) override {
+    log_->EndFence(fence, BackendLog::FenceState::kDestroyed);
+  }
+
+  void Present(const CompositorFrame& frame,
+               int64_t display_timestamp_ns) override {
+    log_->AddPresentation({frame.render_timestamp_ns, display_timestamp_ns});
+  }
+
+  void Shutdown() override {}
+
+ private:
+  BackendLog* const log_;
+  const bool initializes_;
+};
+
+class CompositorTest : public ::testing::Test {
+ protected:
+  CompositorTest()
+      : clock_(new FakeDisplayClock()),
+        compositor_(new Compositor(
+            std::unique_ptr<CompositorBackend>(
+                new FakeBackend(&log_, /*initializes=*/true)),
+            std::unique_ptr<DisplayClock>(clock_))) {}
+
+
+  // Acquires a frame and submits it with render_timestamp_ns. Returns its
+  // index.
+  int SubmitNewFrame(int64_t render_timestamp_ns) {
+    const int index = compositor_->AcquireFrame();
+    EXPECT_NE(index, -1);
+    CompositorFrame frame = {};
+    frame.render_timestamp_ns = render_timestamp_ns;
+    compositor_->SubmitFrame(index, frame);
+    return index;
+  }
+
+  // Ticks the clock and waits until the compositor is done with the tick.
+  void TickAndWait() {
+    clock_->Tick();
+    ASSERT_TRUE(clock_->WaitUntilIdle());
+  }
+
+  BackendLog log_;
+  // Owned by compositor_.
+  FakeDisplayClock* clock_;
+  std::unique_ptr<Compositor> compositor_;
+};
+
+TEST_F(CompositorTest, PresentsSubmittedFrame) {
+  SubmitNewFrame(100);
+  TickAndWait();
+
+  const std::vector<BackendLog::Presentation> presentations =
+      log_.GetPresentations();
+  ASSERT_EQ(presentations.size(), 1u);
+  EXPECT_EQ(presentations[0].render_timestamp_ns, 100);
+  EXPECT_EQ(presentations[0].display_timestamp_ns, kPeriodNs);
+  // The compositor waits on the fence before presenting the frame.
+  EXPECT_EQ(log_.GetFenceState(0), BackendLog::FenceState::kWaited);
+
+  const Compositor::Stats stats = compositor_->GetStats();
+  EXPECT_EQ(stats.presented_frames, 1);
+  EXPECT_EQ(stats.repeated_frames, 0);
+  EXPECT_EQ(stats.dropped_frames, 0);
+}
+
+TEST_F(CompositorTest, RepeatsFrameWhenNoNewFrameIsSubmitted) {
+  SubmitNewFrame(100);
+  TickAndWait();
+  TickAndWait();
+  TickAndWait();
+
+  // The same frame is presented again, for each new display timestamp.
+  const std::vector<BackendLog::Presentation> presentations =
+      log_.GetPresentations();
+  ASSERT_EQ(presentations.size(), 3u);
+  for (size_t i = 0; i < presentations.size(); ++i) {
+    EXPECT_EQ(presentations[i].render_timestamp_ns, 100);
+    EXPECT_EQ(presentations[i].display_timestamp_ns,
+              static_cast<int64_t>(i + 1) * kPeriodNs);
+  }
+  // Its fence is only waited on once.
+  EXPECT_EQ(log_.GetFenceCount(), 1u);
+
+  const Compositor::Stats stats = compositor_->GetStats();
+  EXPECT_EQ(stats.presented_frames, 3);
+  EXPECT_EQ(stats.repeated_frames, 2);
+  EXPECT_EQ(stats.dropped_frames, 0);
+}
+
+TEST_F(CompositorTest, SwitchesToNewFrameAndReleasesPreviousOne) {
+  const int first = SubmitNewFrame(100);
+  TickAndWait();
+  SubmitNewFrame(200);
+  TickAndWait();
+
+  const std::vector<BackendLog::Presentation> presentations =
+      log_.GetPresentations();
+  ASSERT_EQ(presentations.size(), 2u);
+  EXPECT_EQ(presentations[1].render_timestamp_ns, 200);
+
+  // The first frame is no longer displayed, so it can be acquired again.
+  EXPECT_EQ(compositor_->AcquireFrame(), first);
+}
+
+TEST_F(CompositorTest, DropsSupersededFrame) {
+  SubmitNewFrame(100);
+  const int superseded = SubmitNewFrame(200);
+  SubmitNewFrame(300);
+  TickAndWait();
+
+  // Only the latest frame is presented. The superseded ones never got their
+  // fence waited on, which is destroyed instead.
+  const std::vector<BackendLog::Presentation> presentations =
+      log_.GetPresentations();
+  ASSERT_EQ(presentations.size(), 1u);
+  EXPECT_EQ(presentations[0].render_timestamp_ns, 300);
+  EXPECT_EQ(log_.GetFenceState(0), BackendLog::FenceState::kDestroyed);
+  EXPECT_EQ(log_.GetFenceState(1), BackendLog::FenceState::kDestroyed);
+  EXPECT_EQ(log_.GetFenceState(2), BackendLog::FenceState::kWaited);
+
+  const Compositor::Stats stats = compositor_->GetStats();
+  EXPECT_EQ(stats.presented_frames, 1);
+  EXPECT_EQ(stats.dropped_frames, 2);
+
+  // The superseded frame went back to the app right away.
+  EXPECT_EQ(compositor_->AcquireFrame(), superseded);
+}
+
+TEST_F(CompositorTest, IgnoresFrameThatWasNotAcquired) {
+  SubmitNewFrame(100);
+  TickAndWait();
+
+  // Index 1 is free and index 5 is out of range.
+  CompositorFrame frame = {};
+  frame.render_timestamp_ns = 200;
+  compositor_->SubmitFrame(1, frame);
+  compositor_->SubmitFrame(5, frame);
+  TickAndWait();
+
+  const std::vector<BackendLog::Presentation> presentations =
+      log_.GetPresentations();
+  ASSERT_EQ(presentations.size(), 2u);
+  EXPECT_EQ(presentations[1].render_timestamp_ns, 100);
+  // The fence of the rejected frame is destroyed. Out of range indices are
+  // rejected before creating one.
+  ASSERT_EQ(log_.GetFenceCount(), 2u);
+  EXPECT_EQ(log_.GetFenceState(1), BackendLog::FenceState::kDestroyed);
+  EXPECT_EQ(compositor_->GetStats().dropped_frames, 0);
+}
+
+TEST_F(CompositorTest, AcquireBlocksWhileCompositorOwnsAllFrames) {
+  SubmitNewFrame(100);
+  TickAndWait();
+  // One frame is displayed, one submitted and one acquired by the app.
+  SubmitNewFrame(200);
+  EXPECT_NE(compositor_->AcquireFrame(), -1);
+
+  std::future<int> acquired = std::async(std::launch::async, [this]() {
+    return compositor_->AcquireFrame();
+  });
+  EXPECT_EQ(acquired.wait_for(std::chrono::milliseconds(50)),
+            std::future_status::timeout);
+
+  // Displaying the submitted frame releases the previous one.
+  TickAndWait();
+  ASSERT_EQ(acquired.wait_for(kTimeout), std::future_status::ready);
+  EXPECT_NE(acquired.get(), -1);
+}
+
+TEST_F(CompositorTest, DestructorDestroysFenceOfUndisplayedFrame) {
+  SubmitNewFrame(100);
+  TickAndWait();
+  SubmitNewFrame(200);
+  ASSERT_EQ(log_.GetFenceState(1), BackendLog::FenceState::kCreated);
+
+  compositor_.reset();
+  EXPECT_EQ(log_.GetFenceState(0), BackendLog::FenceState::kWaited);
+  EXPECT_EQ(log_.GetFenceState(1), BackendLog::FenceState::kDestroyed);
+}
+
+TEST_F(CompositorTest, DoesNotComposeBeforeFirstSubmission) {
+  clock_->Tick();
+  EXPECT_FALSE(log_.WaitForPresentations(1, std::chrono::milliseconds(50)));
+
+  SubmitNewFrame(100);
+  ASSERT_TRUE(log_.WaitForPresentations(1));
+  EXPECT_EQ(log_.GetPresentations()[0].render_timestamp_ns, 100);
+}
+
+TEST(CompositorInitializationTest, StopsWhenBackendFailsToInitialize) {
+  BackendLog log;
+  Compositor compositor(
+      std::unique_ptr<CompositorBackend>(
+          new FakeBackend(&log, /*initializes=*/false)),
+      std::unique_ptr<DisplayClock>(new FakeDisplayClock()));
+
+  // Free frames may be acquired before the compositor thread stops, but once
+  // they are all acquired, AcquireFrame() returns -1 instead of blocking.
+  int index = 0;
+  for (int i = 0; i <= Compositor::kFrameCount && index != -1; ++i) {
+    index = compositor.AcquireFrame();
+  }
+  EXPECT_EQ(index, -1);
+  EXPECT_TRUE(log.GetPresentations().empty());
+}
+
+}  // namespace
+}  // namespace rendering
+}  // namespace cardboard
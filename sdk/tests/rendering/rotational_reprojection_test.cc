@@ -0,0 +1,210 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "rendering/rotational_reprojection.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <random>
+
+#include "head_tracker.h"
+#include "include/cardboard.h"
+#include "util/rotation.h"
+#include "util/vector.h"
+
+namespace cardboard {
+
+// The head tracker needs the platform sensors, and these tests do not query
+// it. This definition only satisfies the reference from LatchRotation().
+void HeadTracker::GetPose(int64_t /*timestamp_ns*/,
+                          std::array<float, 3>& out_position,
+                          std::array<float, 4>& out_orientation) const {
+  out_position = {0.0f, 0.0f, 0.0f};
+  out_orientation = {0.0f, 0.0f, 0.0f, 1.0f};
+}
+
+namespace rendering {
+namespace {
+
+// The shader math runs in single precision.
+constexpr float kTolerance = 1e-5f;
+
+// Left eye field of view of a typical viewer, in radians: left, right, bottom
+// and top.
+const std::array<float, 4> kFov = {0.87f, 0.7f, 0.8f, 0.9f};
+
+Rotation ToRotation(const std::array<float, 4>& orientation) {
+  return Rotation::FromQuaternion(Vector4(orientation[0], orientation[1],
+                                          orientation[2], orientation[3]));
+}
+
+std::array<float, 4> RandomOrientation(std::mt19937* generator) {
+  std::normal_distribution<float> distribution;
+  std::array<float, 4> q;
+  for (float& value : q) {
+    value = distribution(*generator);
+  }
+  const float norm = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] +
+                               q[3] * q[3]);
+  for (float& value : q) {
+    value /= norm;
+  }
+  return q;
+}
+
+// Returns latest_orientation turned away from render_orientation by a small
+// head motion of up to max_angle radians.
+std::array<float, 4> PerturbOrientation(
+    const std::array<float, 4>& render_orientation, float max_angle,
+    std::mt19937* generator) {
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  const Vector3 axis(distribution(*generator), distribution(*generator),
+                     distribution(*generator));
+  const Rotation latest =
+      Rotation::FromAxisAndAngle(axis, max_angle * distribution(*generator)) *
+      ToRotation(render_orientation);
+  const Vector4 q = latest.GetQuaternion();
+  return {static_cast<float>(q[0]), static_cast<float>(q[1]),
+          static_cast<float>(q[2]), static_cast<float>(q[3])};
+}
+
+// Reprojects a UV coordinate directly with the head orientation quaternions,
+// which map world directions to head directions: the latest head direction
+// of the UV tan-angle is rotated to the world, then to the render head frame,
+// and projected back.
+std::array<float, 2> ReprojectUvWithQuaternions(
+    const std::array<float, 4>& render_orientation,
+    const std::array<float, 4>& latest_orientation,
+    const std::array<float, 4>& tan_angle_rect,
+    const std::array<float, 2>& uv) {
+  const Vector3 latest_direction(
+      uv[0] * tan_angle_rect[2] - tan_angle_rect[0],
+      uv[1] * tan_angle_rect[3] - tan_angle_rect[1], -1.0);
+  const Vector3 world_direction =
+      -ToRotation(latest_orientation) * latest_direction;
+  const Vector3 render_direction =
+      ToRotation(render_orientation) * world_direction;
+  const double tan_angle_x = render_direction[0] / -render_direction[2];
+  const double tan_angle_y = render_direction[1] / -render_direction[2];
+  return {static_cast<float>((tan_angle_x + tan_angle_rect[0]) /
+                             tan_angle_rect[2]),
+          static_cast<float>((tan_angle_y + tan_angle_rect[1]) /
+                             tan_angle_rect[3])};
+}
+
+TEST(RotationalReprojectionTest, DisabledIsExactIdentity) {
+  RotationalReprojection reprojection;
+  reprojection.SetRenderPose(0, {0.1f, 0.2f, 0.3f, 0.93f});
+  const std::array<float, 9> rotation = reprojection.LatchRotation();
+  EXPECT_EQ(rotation, (std::array<float, 9>{1, 0, 0, 0, 1, 0, 0, 0, 1}));
+  const std::array<float, 4> rect = reprojection.GetTanAngleRect(kLeft);
+  EXPECT_EQ(rect, (std::array<float, 4>{0, 0, 1, 1}));
+
+  for (float u : {0.0f, 0.3f, 1.0f}) {
+    for (float v : {0.0f, 0.6f, 1.0f}) {
+      const std::array<float, 2> uv = {u, v};
+      EXPECT_EQ(RotationalReprojection::ReprojectUv(rotation, rect, uv), uv);
+    }
+  }
+}
+
+TEST(RotationalReprojectionTest, TanAngleRectMapsUvToEyeTanAngles) {
+  RotationalReprojection reprojection;
+  reprojection.Enable(nullptr, kFov, kFov);
+  const std::array<float, 4> rect = reprojection.GetTanAngleRect(kLeft);
+
+  // UV (0, 0) is the bottom left edge of the field of view, and UV (1, 1) the
+  // top right one.
+  EXPECT_NEAR(0 * rect[2] - rect[0], -std::tan(kFov[0]), kTolerance);
+  EXPECT_NEAR(0 * rect[3] - rect[1], -std::tan(kFov[2]), kTolerance);
+  EXPECT_NEAR(1 * rect[2] - rect[0], std::tan(kFov[1]), kTolerance);
+  EXPECT_NEAR(1 * rect[3] - rect[1], std::tan(kFov[3]), kTolerance);
+}
+
+TEST(RotationalReprojectionTest, SameOrientationIsIdentity) {
+  std::mt19937 generator(1);
+  const std::array<float, 4> orientation = RandomOrientation(&generator);
+  const std::array<float, 9> rotation =
+      RotationalReprojection::GetRenderFromLatestRotation(orientation,
+                                                          orientation);
+  const std::array<float, 9> identity = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+  for (int i = 0; i < 9; ++i) {
+    EXPECT_NEAR(rotation[i], identity[i], kTolerance);
+  }
+}
+
+// The matrix and the UV mapping, which mirror the u_Reprojection and
+// u_TanAngleRects shader math, must match reprojecting each tan-angle point
+// directly with the quaternions.
+TEST(RotationalReprojectionTest, MatrixReprojectionMatchesQuaternions) {
+  RotationalReprojection reprojection;
+  reprojection.Enable(nullptr, kFov, kFov);
+  const std::array<float, 4> rect = reprojection.GetTanAngleRect(kLeft);
+
+  std::mt19937 generator(2);
+  for (int i = 0; i < 200; ++i) {
+    const std::array<float, 4> render_orientation =
+        RandomOrientation(&generator);
+    // Up to 0.1 rad, about 50 ms of a fast head turn.
+    const std::array<float, 4> latest_orientation =
+        PerturbOrientation(render_orientation, 0.1f, &generator);
+    const std::array<float, 9> rotation =
+        RotationalReprojection::GetRenderFromLatestRotation(
+            render_orientation, latest_orientation);
+
+    for (int row = 0; row <= 4; ++row) {
+      for (int col = 0; col <= 4; ++col) {
+        const std::array<float, 2> uv = {col / 4.0f, row / 4.0f};
+        const std::array<float, 2> reprojected =
+            RotationalReprojection::ReprojectUv(rotation, rect, uv);
+        const std::array<float, 2> expected = ReprojectUvWithQuaternions(
+            render_orientation, latest_orientation, rect, uv);
+        ASSERT_NEAR(reprojected[0], expected[0], kTolerance)
+            << "uv (" << uv[0] << ", " << uv[1] << ")";
+        ASSERT_NEAR(reprojected[1], expected[1], kTolerance)
+            << "uv (" << uv[0] << ", " << uv[1] << ")";
+      }
+    }
+  }
+}
+
+// Turning the head to the left after rendering shows texture content further
+// left, so the sampled UV moves left.
+TEST(RotationalReprojectionTest, YawToTheLeftSamplesFurtherLeft) {
+  RotationalReprojection reprojection;
+  reprojection.Enable(nullptr, kFov, kFov);
+  const std::array<float, 4> rect = reprojection.GetTanAngleRect(kLeft);
+
+  // The head orientation maps world to head, so a head turned left by an
+  // angle around +y has the inverse rotation.
+  const float half_angle = 0.05f;
+  const std::array<float, 4> render_orientation = {0.0f, 0.0f, 0.0f, 1.0f};
+  const std::array<float, 4> latest_orientation = {
+      0.0f, -std::sin(half_angle), 0.0f, std::cos(half_angle)};
+  // UV of the view direction, which a yaw keeps at the same height.
+  const std::array<float, 2> uv = {rect[0] / rect[2], rect[1] / rect[3]};
+  const std::array<float, 2> reprojected = RotationalReprojection::ReprojectUv(
+      RotationalReprojection::GetRenderFromLatestRotation(render_orientation,
+                                                          latest_orientation),
+      rect, uv);
+  EXPECT_LT(reprojected[0], uv[0]);
+  EXPECT_NEAR(reprojected[1], uv[1], kTolerance);
+}
+
+}  // namespace
+}  // namespace rendering
+}  // namespace cardboard
@@ -0,0 +1,396 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "rendering/software_distortion_renderer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "distortion_mesh.h"
+#include "head_tracker.h"
+#include "include/cardboard.h"
+#include "polynomial_radial_distortion.h"
+
+namespace cardboard {
+
+// The head tracker needs the platform sensors, and these tests do not set a
+// render pose. This definition only satisfies the reference from
+// LatchRotation().
+void HeadTracker::GetPose(int64_t /*timestamp_ns*/,
+                          std::array<float, 3>& out_position,
+                          std::array<float, 4>& out_orientation) const {
+  out_position = {0.0f, 0.0f, 0.0f};
+  out_orientation = {0.0f, 0.0f, 0.0f, 1.0f};
+}
+
+namespace rendering {
+namespace {
+
+// Hash of the distorted frame rendered by DistortedFrameMatchesGoldenHash.
+// This test is built with and without the SIMD paths, which must both give
+// this frame. It is the IEEE single precision result without fused
+// multiply-adds, see CMakeLists.txt.
+constexpr uint64_t kGoldenFrameHash = 0x2a7a3f5051627101ull;
+
+constexpr int kTargetWidth = 960;
+constexpr int kTargetHeight = 540;
+constexpr int kEyeImageSize = 512;
+
+class Image {
+ public:
+  Image(int width, int height) : pixels_(4 * width * height, 0) {
+    image_ = {pixels_.data(), width, height, 4 * width};
+  }
+
+  const CardboardSoftwareImage& Get() const { return image_; }
+  uint8_t* Pixel(int x, int y) { return &pixels_[4 * (y * image_.width + x)]; }
+  const uint8_t* Pixel(int x, int y) const {
+    return &pixels_[4 * (y * image_.width + x)];
+  }
+
+  void Fill(uint8_t value) { std::fill(pixels_.begin(), pixels_.end(), value); }
+  void FillRandom(std::mt19937* generator) {
+    for (uint8_t& value : pixels_) {
+      value = static_cast<uint8_t>((*generator)());
+    }
+  }
+
+  // FNV-1a hash of the pixels.
+  uint64_t Hash() const {
+    uint64_t hash = 14695981039346656037ull;
+    for (uint8_t value : pixels_) {
+      hash = (hash ^ value) * 1099511628211ull;
+    }
+    return hash;
+  }
+
+ private:
+  std::vector<uint8_t> pixels_;
+  CardboardSoftwareImage image_;
+};
+
+CardboardSoftwareEyeTextureDescription FullImage(const Image& image) {
+  return {&image.Get(), 0.0f, 1.0f, 1.0f, 0.0f};
+}
+
+// Distortion meshes of a viewer with barrel distortion correction. Fields of
+// view are tan-angle literals, so that the meshes only depend on IEEE
+// arithmetic.
+class DistortedMeshes {
+ public:
+  DistortedMeshes()
+      : distortion_({0.441f, 0.156f}),
+        left_(distortion_, kScreenWidth, kScreenHeight,
+              (kScreenWidth - kInterLensDistance) / 2, kScreenHeight / 2,
+              kTanOuter + kTanInner, 2 * kTanVertical, kTanOuter,
+              kTanVertical, 0.0f, 0.5f),
+        right_(distortion_, kScreenWidth, kScreenHeight,
+               (kScreenWidth + kInterLensDistance) / 2, kScreenHeight / 2,
+               kTanOuter + kTanInner, 2 * kTanVertical, kTanInner,
+               kTanVertical, 0.5f, 1.0f) {}
+
+  CardboardMesh Get(CardboardEye eye) const {
+    return eye == kLeft ? left_.GetMesh() : right_.GetMesh();
+  }
+
+  void SetOn(SoftwareDistortionRenderer* renderer) const {
+    for (CardboardEye eye : {kLeft, kRight}) {
+      const CardboardMesh mesh = Get(eye);
+      renderer->SetMesh(&mesh, eye);
+    }
+  }
+
+ private:
+  // Screen sizes in tan-angle units, the screen being 0.042 m from the
+  // lenses.
+  static constexpr float kScreenWidth = 0.11f / 0.042f;
+  static constexpr float kScreenHeight = 0.062f / 0.042f;
+  static constexpr float kInterLensDistance = 0.06f / 0.042f;
+  static constexpr float kTanOuter = 0.84f;
+  static constexpr float kTanInner = 0.72f;
+  static constexpr float kTanVertical = 0.84f;
+
+  PolynomialRadialDistortion distortion_;
+  DistortionMesh left_;
+  DistortionMesh right_;
+};
+
+// Identity mesh of an eye, covering its half of the viewport.
+CardboardMesh IdentityMesh(CardboardEye eye, std::array<float, 8>* vertices) {
+  static const int kIndices[] = {0, 1, 2, 3};
+  static const float kUvs[] = {0, 0, 1, 0, 0, 1, 1, 1};
+  const float offset = eye == kLeft ? -0.5f : 0.5f;
+  *vertices = {offset - 0.5f, -1, offset + 0.5f, -1,
+               offset - 0.5f, 1,  offset + 0.5f, 1};
+  return {const_cast<int*>(kIndices), 4, vertices->data(),
+          const_cast<float*>(kUvs), 4};
+}
+
+// Renders a distortion mesh in double precision, like the GPU rasterizer
+// would. Pixels covered by the mesh are counted in coverage.
+void RenderReference(const CardboardMesh& mesh, const Image& eye_image,
+                     int min_x, int end_x, Image* target,
+                     std::vector<int>* coverage) {
+  const int width = target->Get().width;
+  const int height = target->Get().height;
+  const int size = eye_image.Get().width;
+  const auto texel = [&eye_image, size](int x, int y, int channel) {
+    x = std::min(std::max(x, 0), size - 1);
+    y = std::min(std::max(y, 0), size - 1);
+    return static_cast<double>(eye_image.Pixel(x, y)[channel]);
+  };
+  for (int i = 2; i < mesh.n_indices; ++i) {
+    const int ids[] = {mesh.indices[i - 2], mesh.indices[i - 1],
+                       mesh.indices[i]};
+    double x[3], y[3], s[3], t[3];
+    for (int k = 0; k < 3; ++k) {
+      x[k] = (mesh.vertices[2 * ids[k]] + 1.0) * 0.5 * width;
+      y[k] = (mesh.vertices[2 * ids[k] + 1] + 1.0) * 0.5 * height;
+      s[k] = mesh.uvs[2 * ids[k]] * size - 0.5;
+      t[k] = mesh.uvs[2 * ids[k] + 1] * size - 0.5;
+    }
+    const double area =
+        (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if (area == 0.0) {
+      continue;
+    }
+    const int x0 = std::max(
+        min_x, static_cast<int>(std::floor(std::min({x[0], x[1], x[2]}))));
+    const int x1 = std::min(
+        end_x - 1, static_cast<int>(std::ceil(std::max({x[0], x[1], x[2]}))));
+    const int y0 = std::max(
+        0, static_cast<int>(std::floor(std::min({y[0], y[1], y[2]}))));
+    const int y1 = std::min(
+        height - 1,
+        static_cast<int>(std::ceil(std::max({y[0], y[1], y[2]}))));
+    for (int py = y0; py <= y1; ++py) {
+      for (int px = x0; px <= x1; ++px) {
+        const double cx = px + 0.5;
+        const double cy = py + 0.5;
+        const double w0 =
+            ((x[1] - cx) * (y[2] - cy) - (y[1] - cy) * (x[2] - cx)) / area;
+        const double w1 =
+            ((x[2] - cx) * (y[0] - cy) - (y[2] - cy) * (x[0] - cx)) / area;
+        const double w2 = 1.0 - w0 - w1;
+        if (w0 < 0.0 || w1 < 0.0 || w2 < 0.0) {
+          continue;
+        }
+        const double sc = w0 * s[0] + w1 * s[1] + w2 * s[2];
+        const double tc = w0 * t[0] + w1 * t[1] + w2 * t[2];
+        const int xi = static_cast<int>(std::floor(sc));
+        const int yi = static_cast<int>(std::floor(tc));
+        const double fx = sc - xi;
+        const double fy = tc - yi;
+        for (int channel = 0; channel < 4; ++channel) {
+          const double bottom =
+              texel(xi, yi, channel) +
+              fx * (texel(xi + 1, yi, channel) - texel(xi, yi, channel));
+          const double top = texel(xi, yi + 1, channel) +
+                             fx * (texel(xi + 1, yi + 1, channel) -
+                                   texel(xi, yi + 1, channel));
+          target->Pixel(px, py)[channel] = static_cast<uint8_t>(
+              std::floor(bottom + fy * (top - bottom) + 0.5));
+        }
+        ++(*coverage)[py * width + px];
+      }
+    }
+  }
+}
+
+TEST(SoftwareDistortionRendererTest, IdentityMeshCopiesEyeImages) {
+  SoftwareDistortionRenderer renderer(2);
+  std::array<float, 8> left_vertices;
+  std::array<float, 8> right_vertices;
+  const CardboardMesh left_mesh = IdentityMesh(kLeft, &left_vertices);
+  const CardboardMesh right_mesh = IdentityMesh(kRight, &right_vertices);
+  renderer.SetMesh(&left_mesh, kLeft);
+  renderer.SetMesh(&right_mesh, kRight);
+
+  std::mt19937 generator(1);
+  Image left_image(256, 256);
+  Image right_image(512, 512);
+  left_image.FillRandom(&generator);
+  right_image.FillRandom(&generator);
+  Image target(512, 256);
+  renderer.SetTargetImage(target.Get());
+  // The right eye samples the center quarter of its image.
+  const CardboardSoftwareEyeTextureDescription left_eye =
+      FullImage(left_image);
+  const CardboardSoftwareEyeTextureDescription right_eye = {
+      &right_image.Get(), 0.25f, 0.75f, 0.75f, 0.25f};
+  renderer.RenderEyeImages(0, 0, 512, 256, left_eye, right_eye);
+
+  int mismatches = 0;
+  for (int y = 0; y < 256; ++y) {
+    for (int x = 0; x < 256; ++x) {
+      mismatches += std::memcmp(target.Pixel(x, y), left_image.Pixel(x, y), 4)
+                        ? 1
+                        : 0;
+      mismatches += std::memcmp(target.Pixel(256 + x, y),
+                                right_image.Pixel(128 + x, 128 + y), 4)
+                        ? 1
+                        : 0;
+    }
+  }
+  EXPECT_EQ(mismatches, 0);
+}
+
+TEST(SoftwareDistortionRendererTest, SideBySideLayoutSamplesLeftEyeImage) {
+  SoftwareDistortionRenderer renderer(2);
+  std::array<float, 8> left_vertices;
+  std::array<float, 8> right_vertices;
+  const CardboardMesh left_mesh = IdentityMesh(kLeft, &left_vertices);
+  const CardboardMesh right_mesh = IdentityMesh(kRight, &right_vertices);
+  renderer.SetMesh(&left_mesh, kLeft);
+  renderer.SetMesh(&right_mesh, kRight);
+  renderer.SetEyeTextureLayout(kEyeTextureLayoutSideBySide);
+
+  std::mt19937 generator(2);
+  Image image(512, 256);
+  image.FillRandom(&generator);
+  Image target(512, 256);
+  renderer.SetTargetImage(target.Get());
+  const CardboardSoftwareEyeTextureDescription left_eye = {
+      &image.Get(), 0.0f, 0.5f, 1.0f, 0.0f};
+  const CardboardSoftwareEyeTextureDescription right_eye = {
+      nullptr, 0.5f, 1.0f, 1.0f, 0.0f};
+  renderer.RenderEyeImages(0, 0, 512, 256, left_eye, right_eye);
+
+  EXPECT_EQ(target.Hash(), image.Hash());
+}
+
+TEST(SoftwareDistortionRendererTest, DistortedFrameMatchesReference) {
+  const DistortedMeshes meshes;
+  SoftwareDistortionRenderer renderer(1);
+  meshes.SetOn(&renderer);
+
+  std::mt19937 generator(3);
+  Image left_image(kEyeImageSize, kEyeImageSize);
+  Image right_image(kEyeImageSize, kEyeImageSize);
+  left_image.FillRandom(&generator);
+  right_image.FillRandom(&generator);
+  Image target(kTargetWidth, kTargetHeight);
+  renderer.SetTargetImage(target.Get());
+  renderer.RenderEyeImages(0, 0, kTargetWidth, kTargetHeight,
+                           FullImage(left_image), FullImage(right_image));
+
+  Image reference(kTargetWidth, kTargetHeight);
+  std::vector<int> coverage(kTargetWidth * kTargetHeight, 0);
+  RenderReference(meshes.Get(kLeft), left_image, 0, kTargetWidth / 2,
+                  &reference, &coverage);
+  RenderReference(meshes.Get(kRight), right_image, kTargetWidth / 2,
+                  kTargetWidth, &reference, &coverage);
+
+  // Texel coordinates are interpolated in single precision, which moves
+  // filtered channels by at most one step.
+  const uint8_t kBlack[] = {0, 0, 0, 255};
+  int covered_pixels = 0;
+  int max_difference = 0;
+  int pixels_outside_reference = 0;
+  for (int y = 0; y < kTargetHeight; ++y) {
+    for (int x = 0; x < kTargetWidth; ++x) {
+      if (coverage[y * kTargetWidth + x] == 0) {
+        pixels_outside_reference +=
+            std::memcmp(target.Pixel(x, y), kBlack, 4) ? 1 : 0;
+        continue;
+      }
+      ++covered_pixels;
+      for (int channel = 0; channel < 4; ++channel) {
+        max_difference = std::max(
+            max_difference, std::abs(target.Pixel(x, y)[channel] -
+                                     reference.Pixel(x, y)[channel]));
+      }
+    }
+  }
+  EXPECT_GT(covered_pixels, kTargetWidth * kTargetHeight / 2);
+  EXPECT_LE(max_difference, 1);
+  EXPECT_EQ(pixels_outside_reference, 0);
+}
+
+TEST(SoftwareDistortionRendererTest, DistortedFrameHasNoHoles) {
+  const DistortedMeshes meshes;
+  SoftwareDistortionRenderer renderer(1);
+  meshes.SetOn(&renderer);
+
+  Image white(kEyeImageSize, kEyeImageSize);
+  white.Fill(255);
+  Image target(kTargetWidth, kTargetHeight);
+  renderer.SetTargetImage(target.Get());
+  renderer.RenderEyeImages(0, 0, kTargetWidth, kTargetHeight,
+                           FullImage(white), FullImage(white));
+
+  Image reference(kTargetWidth, kTargetHeight);
+  std::vector<int> coverage(kTargetWidth * kTargetHeight, 0);
+  RenderReference(meshes.Get(kLeft), white, 0, kTargetWidth / 2, &reference,
+                  &coverage);
+  RenderReference(meshes.Get(kRight), white, kTargetWidth / 2, kTargetWidth,
+                  &reference, &coverage);
+  int holes = 0;
+  for (int y = 0; y < kTargetHeight; ++y) {
+    for (int x = 0; x < kTargetWidth; ++x) {
+      if (coverage[y * kTargetWidth + x] > 0 && target.Pixel(x, y)[0] != 255) {
+        ++holes;
+      }
+    }
+  }
+  EXPECT_EQ(holes, 0);
+}
+
+TEST(SoftwareDistortionRendererTest, DistortedFrameMatchesGoldenHash) {
+  const DistortedMeshes meshes;
+  std::mt19937 generator(4);
+  Image left_image(kEyeImageSize, kEyeImageSize);
+  Image right_image(kEyeImageSize, kEyeImageSize);
+  left_image.FillRandom(&generator);
+  right_image.FillRandom(&generator);
+
+  // Tiles are rendered in parallel, which must not change the frame.
+  for (int thread_count : {1, 2, 4, 8}) {
+    SCOPED_TRACE(thread_count);
+    SoftwareDistortionRenderer renderer(thread_count);
+    meshes.SetOn(&renderer);
+    Image target(kTargetWidth, kTargetHeight);
+    renderer.SetTargetImage(target.Get());
+    renderer.RenderEyeImages(0, 0, kTargetWidth, kTargetHeight,
+                             FullImage(left_image), FullImage(right_image));
+    EXPECT_EQ(target.Hash(), kGoldenFrameHash);
+  }
+}
+
+TEST(SoftwareDistortionRendererTest, RenderEyeToDisplayDoesNotRender) {
+  SoftwareDistortionRenderer renderer(1);
+  DistortedMeshes().SetOn(&renderer);
+  Image target(kTargetWidth, kTargetHeight);
+  target.Fill(7);
+  const uint64_t hash = target.Hash();
+  renderer.SetTargetImage(target.Get());
+  const CardboardEyeTextureDescription eye = {1, 0.0f, 1.0f, 1.0f, 0.0f};
+  renderer.RenderEyeToDisplay(0, 0, 0, kTargetWidth, kTargetHeight, &eye,
+                              &eye);
+
+  EXPECT_EQ(target.Hash(), hash);
+}
+
+}  // namespace
+}  // namespace rendering
+}  // namespace cardboard
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensors/mean_filter.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <deque>
+#include <random>
+
+#include "util/vector.h"
+
+namespace cardboard {
+namespace {
+
+constexpr size_t kFilterSize = 16;
+
+TEST(MeanFilterTest, IsValidOnceFull) {
+  MeanFilter filter(kFilterSize);
+  for (size_t i = 0; i < kFilterSize; ++i) {
+    EXPECT_FALSE(filter.IsValid());
+    filter.AddSample({1, 2, 3});
+  }
+  EXPECT_TRUE(filter.IsValid());
+
+  const Vector3 mean = filter.GetFilteredData();
+  EXPECT_DOUBLE_EQ(mean[0], 1);
+  EXPECT_DOUBLE_EQ(mean[1], 2);
+  EXPECT_DOUBLE_EQ(mean[2], 3);
+}
+
+// The filter keeps a running sum, updated with each added and evicted sample.
+// It must match the mean of the last samples recomputed from scratch, also
+// after many evictions.
+TEST(MeanFilterTest, RunningSumMatchesMeanOfLastSamples) {
+  MeanFilter filter(kFilterSize);
+  std::deque<Vector3> window;
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<double> distribution(-20.0, 20.0);
+
+  for (int i = 0; i < 100000; ++i) {
+    const Vector3 sample(distribution(generator), distribution(generator),
+                         distribution(generator));
+    filter.AddSample(sample);
+    window.push_back(sample);
+    if (window.size() > kFilterSize) {
+      window.pop_front();
+    }
+    if (!filter.IsValid()) {
+      continue;
+    }
+
+    Vector3 expected = Vector3::Zero();
+    for (const Vector3& v : window) {
+      expected += v;
+    }
+    expected /= static_cast<double>(kFilterSize);
+    const Vector3 mean = filter.GetFilteredData();
+    for (int axis = 0; axis < 3; ++axis) {
+      ASSERT_NEAR(mean[axis], expected[axis], 1e-9) << "sample " << i;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace cardboard
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensors/median_filter.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "util/vector.h"
+#include "util/vectorutils.h"
+
+namespace cardboard {
+namespace {
+
+constexpr size_t kFilterSize = 9;
+
+// Returns the sample of window with the median norm, by sorting a copy.
+Vector3 SortedMedian(const std::deque<Vector3>& window) {
+  std::vector<Vector3> sorted(window.begin(), window.end());
+  std::sort(sorted.begin(), sorted.end(),
+            [](const Vector3& lhs, const Vector3& rhs) {
+              return Length(lhs) < Length(rhs);
+            });
+  return sorted[sorted.size() / 2];
+}
+
+TEST(MedianFilterTest, IsValidOnceFull) {
+  MedianFilter filter(kFilterSize);
+  for (size_t i = 0; i < kFilterSize; ++i) {
+    EXPECT_FALSE(filter.IsValid());
+    filter.AddSample({static_cast<double>(i), 0, 0});
+  }
+  EXPECT_TRUE(filter.IsValid());
+  EXPECT_EQ(filter.GetFilteredData()[0], kFilterSize / 2);
+}
+
+TEST(MedianFilterTest, RejectsOutliers) {
+  MedianFilter filter(kFilterSize);
+  for (size_t i = 0; i < kFilterSize; ++i) {
+    filter.AddSample(i % 3 == 0 ? Vector3(100, 0, 0) : Vector3(0, 1, 0));
+  }
+  const Vector3 median = filter.GetFilteredData();
+  EXPECT_EQ(median[0], 0);
+  EXPECT_EQ(median[1], 1);
+}
+
+// The filter keeps the norms sorted incrementally, replacing the entry of the
+// evicted sample. It must pick the same sample as sorting the last samples.
+TEST(MedianFilterTest, IncrementalSortMatchesSortedWindow) {
+  MedianFilter filter(kFilterSize);
+  std::deque<Vector3> window;
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<double> distribution(-20.0, 20.0);
+
+  for (int i = 0; i < 10000; ++i) {
+    const Vector3 sample(distribution(generator), distribution(generator),
+                         distribution(generator));
+    filter.AddSample(sample);
+    window.push_back(sample);
+    if (window.size() > kFilterSize) {
+      window.pop_front();
+    }
+    if (!filter.IsValid()) {
+      continue;
+    }
+
+    const Vector3 median = filter.GetFilteredData();
+    const Vector3 expected = SortedMedian(window);
+    for (int axis = 0; axis < 3; ++axis) {
+      ASSERT_EQ(median[axis], expected[axis]) << "sample " << i;
+    }
+  }
+}
+
+TEST(MedianFilterTest, ResetDropsSamples) {
+  MedianFilter filter(kFilterSize);
+  for (size_t i = 0; i < kFilterSize; ++i) {
+    filter.AddSample({100, 0, 0});
+  }
+  filter.Reset();
+  EXPECT_FALSE(filter.IsValid());
+
+  for (size_t i = 0; i < kFilterSize; ++i) {
+    filter.AddSample({1, 0, 0});
+  }
+  EXPECT_TRUE(filter.IsValid());
+  EXPECT_EQ(filter.GetFilteredData()[0], 1);
+}
+
+}  // namespace
+}  // namespace cardboard
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensors/pose_prediction.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "sensors/pose_state.h"
+#include "util/rotation.h"
+#include "util/vector.h"
+#include "util/vectorutils.h"
+
+namespace cardboard {
+namespace {
+
+// The polynomial path truncates the Taylor series of the exponential map. At
+// its largest half angle of 0.5 rad, the truncation error is below 3e-10, so
+// both paths must agree within this angle, in radians.
+constexpr double kTolerance = 1e-9;
+
+// Returns the angle of the rotation between a and b, in radians.
+double AngleBetween(const Rotation& a, const Rotation& b) {
+  const Vector4 q = ((-a) * b).GetQuaternion();
+  const double sin_half_angle =
+      std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+  return 2.0 * std::asin(std::min(1.0, sin_half_angle));
+}
+
+// Integrates the gyroscope value with the axis and angle formula.
+Rotation ExactRotationFromGyroscope(const Vector3& gyroscope_value,
+                                    double timestep_s) {
+  const Vector3 rotation = gyroscope_value * -timestep_s;
+  return Rotation::FromAxisAndAngle(rotation, Length(rotation));
+}
+
+// Unit axes the velocity sweep rotates around.
+const Vector3 kAxes[] = {
+    {1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {0.48, -0.6, 0.64}, {-0.8, 0, 0.6}};
+
+// Angular velocities in rad/s, up to fast head turns.
+constexpr double kSpeeds[] = {0, 1e-6, 0.01, 0.5, 1, 3, 6, 10, 20, 40};
+
+// Prediction horizons in seconds, including past timestamps.
+constexpr double kHorizons[] = {-0.05, 0,     1e-4,  0.001, 0.005, 0.01,
+                                0.02,  0.033, 0.05,  0.08,  0.1,   0.2};
+
+TEST(PosePredictionTest, GyroscopeRotationMatchesExactIntegration) {
+  for (const Vector3& axis : kAxes) {
+    for (double speed : kSpeeds) {
+      for (double horizon : kHorizons) {
+        const Vector3 gyroscope_value = axis * speed;
+        EXPECT_LT(AngleBetween(pose_prediction::GetRotationFromGyroscope(
+                                   gyroscope_value, horizon),
+                               ExactRotationFromGyroscope(gyroscope_value,
+                                                          horizon)),
+                  kTolerance)
+            << "speed " << speed << " rad/s, horizon " << horizon << " s";
+      }
+    }
+  }
+}
+
+// The fast path is used up to a rotation of 1 rad. Both sides of the switch
+// must match the exact rotation.
+TEST(PosePredictionTest, GyroscopeRotationIsContinuousAtPathSwitch) {
+  const Vector3 gyroscope_value(0, 10, 0);
+  for (double angle : {0.999, 0.999999, 1.0, 1.000001, 1.001}) {
+    const double timestep_s = angle / 10;
+    EXPECT_LT(AngleBetween(pose_prediction::GetRotationFromGyroscope(
+                               gyroscope_value, timestep_s),
+                           ExactRotationFromGyroscope(gyroscope_value,
+                                                      timestep_s)),
+              kTolerance)
+        << "angle " << angle << " rad";
+  }
+}
+
+TEST(PosePredictionTest, ZeroVelocityIsExactIdentity) {
+  const Vector4 q =
+      pose_prediction::GetRotationFromGyroscope(Vector3::Zero(), 0.05)
+          .GetQuaternion();
+  EXPECT_EQ(q[0], 0);
+  EXPECT_EQ(q[1], 0);
+  EXPECT_EQ(q[2], 0);
+  EXPECT_EQ(q[3], 1);
+}
+
+TEST(PosePredictionTest, PredictedPosesMatchExactIntegration) {
+  PoseState state;
+  state.timestamp = 1000000000;
+  state.sensor_from_start_rotation =
+      Rotation::FromAxisAndAngle(Vector3(1, 2, 3), 0.7);
+  for (const Vector3& axis : kAxes) {
+    for (double speed : kSpeeds) {
+      state.sensor_from_start_rotation_velocity = axis * speed;
+      for (double horizon : kHorizons) {
+        const int64_t timestamp =
+            state.timestamp + static_cast<int64_t>(std::llround(horizon * 1e9));
+        const Rotation update = ExactRotationFromGyroscope(
+            state.sensor_from_start_rotation_velocity,
+            static_cast<double>(timestamp - state.timestamp) * 1e-9);
+
+        EXPECT_LT(AngleBetween(pose_prediction::PredictPose(timestamp, state),
+                               update * state.sensor_from_start_rotation),
+                  kTolerance);
+        EXPECT_LT(
+            AngleBetween(pose_prediction::PredictPoseInv(timestamp, state),
+                         state.sensor_from_start_rotation * (-update)),
+            kTolerance);
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace cardboard
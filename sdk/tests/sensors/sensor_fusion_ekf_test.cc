@@ -0,0 +1,125 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensors/sensor_fusion_ekf.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "sensors/accelerometer_data.h"
+#include "sensors/gyroscope_data.h"
+#include "util/rotation.h"
+#include "util/vector.h"
+#include "util/vectorutils.h"
+
+namespace cardboard {
+namespace {
+
+constexpr double kGravity = 9.81;
+// Sensors are sampled at 200 Hz.
+constexpr uint64_t kSamplePeriod_ns = 5000000;
+constexpr double kCorrectionRate_hz = 10.0;
+
+class SensorFusionEkfTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // The device does not move in these tests. Without the bias estimator, it
+    // is never considered static and tracking stays at full rate.
+    ekf_.SetBiasEstimationEnabled(false);
+    ekf_.SetAccelerometerCorrectionRate(kCorrectionRate_hz);
+  }
+
+  // Feeds a still gyroscope and the given gravity direction for a duration.
+  // The gyroscope does not rotate the pose, so the pose only changes with
+  // accelerometer corrections.
+  //
+  // @return number of accelerometer corrections.
+  int Run(const Vector3& down, double duration_s) {
+    int corrections = 0;
+    const uint64_t end_ns =
+        timestamp_ns_ + static_cast<uint64_t>(duration_s * 1e9);
+    while (timestamp_ns_ < end_ns) {
+      timestamp_ns_ += kSamplePeriod_ns;
+      ekf_.ProcessGyroscopeSample(
+          {timestamp_ns_, timestamp_ns_, Vector3::Zero()});
+      const Vector4 before = GetOrientation();
+      ekf_.ProcessAccelerometerSample(
+          {timestamp_ns_, timestamp_ns_, down * kGravity});
+      const Vector4 after = GetOrientation();
+      if (after[0] != before[0] || after[1] != before[1] ||
+          after[2] != before[2] || after[3] != before[3]) {
+        ++corrections;
+      }
+    }
+    return corrections;
+  }
+
+  Vector4 GetOrientation() const {
+    return ekf_.GetLatestPoseState()
+        .sensor_from_start_rotation.GetQuaternion();
+  }
+
+  // Returns the angle between the estimated and the given gravity direction.
+  double GetTiltError(const Vector3& down) const {
+    const Vector3 estimated_down =
+        ekf_.GetLatestPoseState().sensor_from_start_rotation *
+        Vector3(0, 0, 1);
+    return std::acos(std::min(1.0, Dot(estimated_down, down)));
+  }
+
+  SensorFusionEkf ekf_;
+  uint64_t timestamp_ns_ = 0;
+};
+
+TEST_F(SensorFusionEkfTest, CorrectsAtSetRateWhileResidualIsSmall) {
+  Run(Vector3(0, 0, 1), 10.0);
+
+  // Tilts gravity by half a degree, which is below the residual threshold.
+  // Each correction reduces the error, so each one changes the pose.
+  const double tilt = 0.5 * M_PI / 180.0;
+  const Vector3 down(std::sin(tilt), 0, std::cos(tilt));
+  EXPECT_NEAR(Run(down, 10.0), 10.0 * kCorrectionRate_hz, 1);
+  EXPECT_LT(GetTiltError(down), 0.5 * tilt);
+}
+
+TEST_F(SensorFusionEkfTest, RaisesCorrectionRateWhileResidualIsLarge) {
+  Run(Vector3(0, 0, 1), 10.0);
+
+  // Tilts gravity by 20 degrees.
+  const double tilt = 20.0 * M_PI / 180.0;
+  const Vector3 down(std::sin(tilt), 0, std::cos(tilt));
+  EXPECT_GT(Run(down, 1.0), 2 * kCorrectionRate_hz);
+  // At the set rate, the error would still be about 0.28 radians.
+  EXPECT_LT(GetTiltError(down), 0.15);
+
+  // Once the estimate converged, the rate settles back to the set one.
+  Run(down, 5.0);
+  EXPECT_NEAR(Run(down, 10.0), 10.0 * kCorrectionRate_hz, 1);
+}
+
+TEST_F(SensorFusionEkfTest, CorrectsWithEverySampleByDefault) {
+  ekf_.SetAccelerometerCorrectionRate(0.0);
+  Run(Vector3(0, 0, 1), 1.0);
+
+  const double tilt = 5.0 * M_PI / 180.0;
+  const Vector3 down(0, std::sin(tilt), std::cos(tilt));
+  EXPECT_EQ(Run(down, 0.1), 20);
+}
+
+}  // namespace
+}  // namespace cardboard
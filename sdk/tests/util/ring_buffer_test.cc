@@ -0,0 +1,100 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/ring_buffer.h"
+
+#include <gtest/gtest.h>
+
+namespace cardboard {
+namespace {
+
+TEST(RingBufferTest, KeepsElementsInPushOrderUntilFull) {
+  RingBuffer<int> buffer(3);
+  EXPECT_EQ(buffer.Size(), 0u);
+  EXPECT_EQ(buffer.Capacity(), 3u);
+
+  int evicted = -1;
+  EXPECT_FALSE(buffer.PushBack(1, &evicted));
+  EXPECT_FALSE(buffer.PushBack(2, &evicted));
+  EXPECT_FALSE(buffer.IsFull());
+  EXPECT_FALSE(buffer.PushBack(3, &evicted));
+  EXPECT_TRUE(buffer.IsFull());
+  EXPECT_EQ(evicted, -1);
+
+  EXPECT_EQ(buffer.Size(), 3u);
+  EXPECT_EQ(buffer[0], 1);
+  EXPECT_EQ(buffer[1], 2);
+  EXPECT_EQ(buffer[2], 3);
+}
+
+TEST(RingBufferTest, OverwritesOldestElementWhenFull) {
+  RingBuffer<int> buffer(3);
+  for (int i = 0; i < 3; ++i) {
+    buffer.PushBack(i);
+  }
+
+  for (int i = 3; i < 10; ++i) {
+    int evicted = -1;
+    EXPECT_TRUE(buffer.PushBack(i, &evicted));
+    EXPECT_EQ(evicted, i - 3);
+    EXPECT_EQ(buffer.Size(), 3u);
+    EXPECT_EQ(buffer[0], i - 2);
+    EXPECT_EQ(buffer[1], i - 1);
+    EXPECT_EQ(buffer[2], i);
+  }
+}
+
+TEST(RingBufferTest, SlotsAreStableWhileElementsAreStored) {
+  RingBuffer<int> buffer(4);
+  for (int i = 0; i < 4; ++i) {
+    buffer.PushBack(i);
+  }
+  const size_t newest_slot = buffer.SlotOf(3);
+
+  buffer.PushBack(4);
+  buffer.PushBack(5);
+
+  // The newest element of the first batch moved to the front by two, but it
+  // stays in the same slot.
+  EXPECT_EQ(buffer.SlotOf(1), newest_slot);
+  EXPECT_EQ(buffer.AtSlot(newest_slot), 3);
+  // The new element overwrote the slot of the evicted one.
+  EXPECT_EQ(buffer.AtSlot(buffer.SlotOf(3)), 5);
+}
+
+TEST(RingBufferTest, ClearKeepsCapacity) {
+  RingBuffer<int> buffer(2);
+  buffer.PushBack(1);
+  buffer.PushBack(2);
+  buffer.PushBack(3);
+
+  buffer.Clear();
+  EXPECT_EQ(buffer.Size(), 0u);
+  EXPECT_EQ(buffer.Capacity(), 2u);
+
+  EXPECT_FALSE(buffer.PushBack(4));
+  EXPECT_EQ(buffer[0], 4);
+}
+
+TEST(RingBufferTest, ZeroCapacityIgnoresElements) {
+  RingBuffer<int> buffer(0);
+  int evicted = -1;
+  EXPECT_FALSE(buffer.PushBack(1, &evicted));
+  EXPECT_EQ(evicted, -1);
+  EXPECT_EQ(buffer.Size(), 0u);
+}
+
+}  // namespace
+}  // namespace cardboard
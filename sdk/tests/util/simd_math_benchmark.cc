@@ -0,0 +1,102 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Compares the dispatching kernels of util/simd_math.h to their scalar
+// reference, and measures the Rotation and Matrix3x3 operators built on them.
+#include <benchmark/benchmark.h>
+
+#include <array>
+
+#include "util/matrix_3x3.h"
+#include "util/rotation.h"
+#include "util/simd_math.h"
+#include "util/vector.h"
+
+namespace cardboard {
+namespace {
+
+template <typename T>
+void BM_QuaternionMultiplyScalar(benchmark::State& state) {
+  std::array<T, 4> q = {{T(0.1), T(0.2), T(0.3), T(0.927)}};
+  const std::array<T, 4> step = {{T(0.001), T(0.002), T(0.003), T(1)}};
+  for (auto _ : state) {
+    simd_math::QuaternionMultiplyScalar(q.data(), step.data(), q.data());
+    benchmark::DoNotOptimize(q);
+  }
+}
+BENCHMARK_TEMPLATE(BM_QuaternionMultiplyScalar, float);
+BENCHMARK_TEMPLATE(BM_QuaternionMultiplyScalar, double);
+
+template <typename T>
+void BM_QuaternionMultiply(benchmark::State& state) {
+  std::array<T, 4> q = {{T(0.1), T(0.2), T(0.3), T(0.927)}};
+  const std::array<T, 4> step = {{T(0.001), T(0.002), T(0.003), T(1)}};
+  for (auto _ : state) {
+    simd_math::QuaternionMultiply(q.data(), step.data(), q.data());
+    benchmark::DoNotOptimize(q);
+  }
+}
+BENCHMARK_TEMPLATE(BM_QuaternionMultiply, float);
+BENCHMARK_TEMPLATE(BM_QuaternionMultiply, double);
+
+void BM_Matrix3x3MultiplyScalar(benchmark::State& state) {
+  const std::array<double, 9> a = {{1, 2, 3, 4, 5, 6, 7, 8, 9}};
+  std::array<double, 9> b = {{9, 8, 7, 6, 5, 4, 3, 2, 1}};
+  std::array<double, 9> result;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(b);
+    simd_math::Matrix3x3MultiplyScalar(a.data(), b.data(), result.data());
+    benchmark::DoNotOptimize(result);
+  }
+}
+BENCHMARK(BM_Matrix3x3MultiplyScalar);
+
+void BM_Matrix3x3Multiply(benchmark::State& state) {
+  const std::array<double, 9> a = {{1, 2, 3, 4, 5, 6, 7, 8, 9}};
+  std::array<double, 9> b = {{9, 8, 7, 6, 5, 4, 3, 2, 1}};
+  std::array<double, 9> result;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(b);
+    simd_math::Matrix3x3Multiply(a.data(), b.data(), result.data());
+    benchmark::DoNotOptimize(result);
+  }
+}
+BENCHMARK(BM_Matrix3x3Multiply);
+
+void BM_RotationProduct(benchmark::State& state) {
+  const Rotation step = Rotation::FromAxisAndAngle(Vector3(1, 2, 3), 0.01);
+  Rotation rotation;
+  for (auto _ : state) {
+    rotation *= step;
+    benchmark::DoNotOptimize(rotation);
+  }
+}
+BENCHMARK(BM_RotationProduct);
+
+void BM_RotationApplyToVector(benchmark::State& state) {
+  const Rotation rotation =
+      Rotation::FromAxisAndAngle(Vector3(1, 2, 3), 0.5);
+  Vector3 v(1, 0, 0);
+  for (auto _ : state) {
+    v = rotation * v;
+    benchmark::DoNotOptimize(v);
+  }
+}
+BENCHMARK(BM_RotationApplyToVector);
+
+}  // namespace
+}  // namespace cardboard
+
+BENCHMARK_MAIN();
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/simd_math.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <random>
+
+#include "util/matrix_3x3.h"
+#include "util/rotation.h"
+#include "util/vector.h"
+
+namespace cardboard {
+namespace {
+
+// The vector kernels reorder the products and sums of the scalar ones, so
+// they only match up to rounding.
+constexpr double kFloatTolerance = 2e-6;
+constexpr double kDoubleTolerance = 1e-14;
+
+template <typename T, size_t N>
+std::array<T, N> RandomArray(std::mt19937* generator) {
+  std::uniform_real_distribution<T> distribution(-1, 1);
+  std::array<T, N> values;
+  for (T& value : values) {
+    value = distribution(*generator);
+  }
+  return values;
+}
+
+template <typename T>
+void TestQuaternionMultiplyMatchesScalar(double tolerance) {
+  std::mt19937 generator(1);
+  for (int i = 0; i < 1000; ++i) {
+    const std::array<T, 4> a = RandomArray<T, 4>(&generator);
+    const std::array<T, 4> b = RandomArray<T, 4>(&generator);
+    std::array<T, 4> expected;
+    simd_math::QuaternionMultiplyScalar(a.data(), b.data(), expected.data());
+
+    std::array<T, 4> result;
+    simd_math::QuaternionMultiply(a.data(), b.data(), result.data());
+    // The output may alias an input.
+    std::array<T, 4> aliased = a;
+    simd_math::QuaternionMultiply(aliased.data(), b.data(), aliased.data());
+    for (int j = 0; j < 4; ++j) {
+      ASSERT_NEAR(result[j], expected[j], tolerance);
+      ASSERT_NEAR(aliased[j], expected[j], tolerance);
+    }
+  }
+}
+
+TEST(SimdMathTest, FloatQuaternionMultiplyMatchesScalar) {
+  TestQuaternionMultiplyMatchesScalar<float>(kFloatTolerance);
+}
+
+TEST(SimdMathTest, DoubleQuaternionMultiplyMatchesScalar) {
+  TestQuaternionMultiplyMatchesScalar<double>(kDoubleTolerance);
+}
+
+TEST(SimdMathTest, QuaternionMultiplyIsHamiltonProduct) {
+  // i * j = k and j * i = -k.
+  const std::array<double, 4> i = {{1, 0, 0, 0}};
+  const std::array<double, 4> j = {{0, 1, 0, 0}};
+  std::array<double, 4> result;
+  simd_math::QuaternionMultiply(i.data(), j.data(), result.data());
+  EXPECT_EQ(result, (std::array<double, 4>{{0, 0, 1, 0}}));
+  simd_math::QuaternionMultiply(j.data(), i.data(), result.data());
+  EXPECT_EQ(result, (std::array<double, 4>{{0, 0, -1, 0}}));
+}
+
+TEST(SimdMathTest, Matrix3x3MultiplyMatchesScalar) {
+  std::mt19937 generator(2);
+  for (int i = 0; i < 1000; ++i) {
+    const std::array<double, 9> a = RandomArray<double, 9>(&generator);
+    const std::array<double, 9> b = RandomArray<double, 9>(&generator);
+    std::array<double, 9> expected;
+    simd_math::Matrix3x3MultiplyScalar(a.data(), b.data(), expected.data());
+    std::array<double, 9> result;
+    simd_math::Matrix3x3Multiply(a.data(), b.data(), result.data());
+    for (int j = 0; j < 9; ++j) {
+      ASSERT_NEAR(result[j], expected[j], kDoubleTolerance);
+    }
+  }
+}
+
+// The float pose path must agree with the double Rotation class it replaces.
+TEST(SimdMathTest, FloatKernelsMatchRotation) {
+  std::mt19937 generator(3);
+  for (int i = 0; i < 1000; ++i) {
+    const std::array<double, 4> qa = RandomArray<double, 4>(&generator);
+    const std::array<double, 4> qb = RandomArray<double, 4>(&generator);
+    const std::array<double, 3> v = RandomArray<double, 3>(&generator);
+    const Rotation a =
+        Rotation::FromQuaternion(Vector4(qa[0], qa[1], qa[2], qa[3]));
+    const Rotation b =
+        Rotation::FromQuaternion(Vector4(qb[0], qb[1], qb[2], qb[3]));
+    const Rotation product = a * b;
+    const Vector3 rotated = a * Vector3(v[0], v[1], v[2]);
+
+    std::array<float, 4> fa, fb;
+    for (int j = 0; j < 4; ++j) {
+      fa[j] = static_cast<float>(a.GetQuaternion()[j]);
+      fb[j] = static_cast<float>(b.GetQuaternion()[j]);
+    }
+    const std::array<float, 3> fv = {{static_cast<float>(v[0]),
+                                      static_cast<float>(v[1]),
+                                      static_cast<float>(v[2])}};
+    std::array<float, 4> float_product;
+    simd_math::QuaternionMultiply(fa.data(), fb.data(), float_product.data());
+    std::array<float, 3> float_rotated;
+    simd_math::QuaternionRotateVector(fa.data(), fv.data(),
+                                      float_rotated.data());
+
+    for (int j = 0; j < 4; ++j) {
+      ASSERT_NEAR(float_product[j], product.GetQuaternion()[j],
+                  kFloatTolerance);
+    }
+    for (int j = 0; j < 3; ++j) {
+      ASSERT_NEAR(float_rotated[j], rotated[j], kFloatTolerance);
+    }
+  }
+}
+
+// Rotation normalizes its products lazily. Its quaternion must stay unit
+// length over a long chain of products.
+TEST(SimdMathTest, LazyNormalizationKeepsUnitQuaternion) {
+  const Rotation step = Rotation::FromAxisAndAngle(Vector3(1, 2, 3), 0.01);
+  Rotation rotation;
+  for (int i = 0; i < 1000000; ++i) {
+    rotation *= step;
+    const Vector4& q = rotation.GetQuaternion();
+    const double norm_squared =
+        q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+    ASSERT_NEAR(norm_squared, 1.0, 2e-12) << "product " << i;
+  }
+}
+
+}  // namespace
+}  // namespace cardboard
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/symmetric_matrix_3x3.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "util/matrix_3x3.h"
+#include "util/matrixutils.h"
+
+namespace cardboard {
+namespace {
+
+constexpr double kTolerance = 1e-12;
+
+Matrix3x3 RandomMatrix(std::mt19937* generator) {
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  Matrix3x3 m;
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 3; ++col) {
+      m(row, col) = distribution(*generator);
+    }
+  }
+  return m;
+}
+
+// Returns a random symmetric positive definite matrix a * a^T + epsilon * I.
+SymmetricMatrix3x3 RandomPositiveDefinite(std::mt19937* generator) {
+  const Matrix3x3 a = RandomMatrix(generator);
+  return SymmetricMatrix3x3::FromMatrix(a * Transpose(a)) +
+         1e-3 * SymmetricMatrix3x3::Identity();
+}
+
+void ExpectMatrixNear(const Matrix3x3& actual, const Matrix3x3& expected,
+                      double tolerance) {
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 3; ++col) {
+      EXPECT_NEAR(actual(row, col), expected(row, col), tolerance)
+          << "at (" << row << ", " << col << ")";
+    }
+  }
+}
+
+TEST(SymmetricMatrix3x3Test, StoresUpperTriangleSymmetrically) {
+  const SymmetricMatrix3x3 m(1, 2, 3, 4, 5, 6);
+  ExpectMatrixNear(m.ToMatrix(), Matrix3x3(1, 2, 3, 2, 4, 5, 3, 5, 6), 0);
+
+  const Matrix3x3 general(1, 2, 3, 4, 5, 6, 7, 8, 9);
+  ExpectMatrixNear(SymmetricMatrix3x3::FromMatrix(general).ToMatrix(),
+                   Matrix3x3(1, 3, 5, 3, 5, 7, 5, 7, 9), 0);
+}
+
+TEST(SymmetricMatrix3x3Test, ProductMatchesDenseProduct) {
+  std::mt19937 generator(1);
+  for (int i = 0; i < 100; ++i) {
+    const SymmetricMatrix3x3 m = RandomPositiveDefinite(&generator);
+    const Matrix3x3 rhs = RandomMatrix(&generator);
+    ExpectMatrixNear(m * rhs, m.ToMatrix() * rhs, kTolerance);
+  }
+}
+
+TEST(SymmetricMatrix3x3Test, CongruenceTransformMatchesDenseProduct) {
+  std::mt19937 generator(2);
+  for (int i = 0; i < 100; ++i) {
+    const SymmetricMatrix3x3 m = RandomPositiveDefinite(&generator);
+    const Matrix3x3 a = RandomMatrix(&generator);
+    ExpectMatrixNear(CongruenceTransform(a, m).ToMatrix(),
+                     a * m.ToMatrix() * Transpose(a), kTolerance);
+  }
+}
+
+TEST(SymmetricMatrix3x3Test, CholeskySolveMatchesInverse) {
+  std::mt19937 generator(3);
+  for (int i = 0; i < 100; ++i) {
+    const SymmetricMatrix3x3 m = RandomPositiveDefinite(&generator);
+    const Matrix3x3 b = RandomMatrix(&generator);
+    Matrix3x3 x;
+    ASSERT_TRUE(SolveRightWithCholesky(m, b, &x));
+    // x * m must give back b. The solution itself is compared relative to
+    // the conditioning of m.
+    ExpectMatrixNear(x * m.ToMatrix(), b, 1e-9);
+    ExpectMatrixNear(x, b * Inverse(m.ToMatrix()), 1e-6);
+  }
+}
+
+TEST(SymmetricMatrix3x3Test, CholeskySolveRejectsNonPositiveDefinite) {
+  const Matrix3x3 b = Matrix3x3::Identity();
+  const Matrix3x3 untouched(1, 2, 3, 4, 5, 6, 7, 8, 9);
+
+  const SymmetricMatrix3x3 non_positive_definites[] = {
+      SymmetricMatrix3x3::Zero(),
+      // Negative first pivot.
+      SymmetricMatrix3x3(-1, 0, 0, 1, 0, 1),
+      // Singular, the third row is the sum of the first two.
+      SymmetricMatrix3x3(1, 0, 1, 1, 1, 2),
+      // Indefinite, eigenvalues 3 and -1 in the first block.
+      SymmetricMatrix3x3(1, 2, 0, 1, 0, 1),
+  };
+  for (const SymmetricMatrix3x3& m : non_positive_definites) {
+    Matrix3x3 x = untouched;
+    EXPECT_FALSE(SolveRightWithCholesky(m, b, &x));
+    ExpectMatrixNear(x, untouched, 0);
+  }
+}
+
+// With the optimal gain k = p * h^T * (h * p * h^T + r)^-1, the Joseph form
+// equals the standard update (I - k * h) * p.
+TEST(SymmetricMatrix3x3Test, JosephUpdateMatchesStandardUpdateForOptimalGain) {
+  std::mt19937 generator(4);
+  for (int i = 0; i < 100; ++i) {
+    const SymmetricMatrix3x3 p = RandomPositiveDefinite(&generator);
+    const SymmetricMatrix3x3 r = RandomPositiveDefinite(&generator);
+    const Matrix3x3 h = RandomMatrix(&generator);
+
+    const SymmetricMatrix3x3 innovation_covariance =
+        CongruenceTransform(h, p) + r;
+    Matrix3x3 k;
+    ASSERT_TRUE(
+        SolveRightWithCholesky(innovation_covariance, p * Transpose(h), &k));
+
+    const Matrix3x3 standard = (Matrix3x3::Identity() - k * h) * p.ToMatrix();
+    ExpectMatrixNear(JosephCovarianceUpdate(p, k, h, r).ToMatrix(), standard,
+                     1e-9);
+  }
+}
+
+// For any gain, the Joseph form matches its dense expression and stays
+// positive definite, which the standard update does not guarantee.
+TEST(SymmetricMatrix3x3Test, JosephUpdateStaysPositiveDefiniteForAnyGain) {
+  std::mt19937 generator(5);
+  for (int i = 0; i < 100; ++i) {
+    const SymmetricMatrix3x3 p = RandomPositiveDefinite(&generator);
+    const SymmetricMatrix3x3 r = RandomPositiveDefinite(&generator);
+    const Matrix3x3 h = RandomMatrix(&generator);
+    const Matrix3x3 k = 5.0 * RandomMatrix(&generator);
+
+    const Matrix3x3 i_kh = Matrix3x3::Identity() - k * h;
+    const Matrix3x3 expected = i_kh * p.ToMatrix() * Transpose(i_kh) +
+                               k * r.ToMatrix() * Transpose(k);
+    const SymmetricMatrix3x3 updated = JosephCovarianceUpdate(p, k, h, r);
+    ExpectMatrixNear(updated.ToMatrix(), expected, 1e-9);
+
+    Matrix3x3 unused;
+    EXPECT_TRUE(
+        SolveRightWithCholesky(updated, Matrix3x3::Identity(), &unused));
+  }
+}
+
+}  // namespace
+}  // namespace cardboard
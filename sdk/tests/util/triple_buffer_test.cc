@@ -0,0 +1,126 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/triple_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace cardboard {
+namespace {
+
+// Value whose fields are all derived from its sequence number, so that a
+// partially written value is detected.
+struct Payload {
+  int64_t sequence;
+  std::array<int64_t, 15> data;
+};
+
+Payload MakePayload(int64_t sequence) {
+  Payload payload;
+  payload.sequence = sequence;
+  for (size_t i = 0; i < payload.data.size(); ++i) {
+    payload.data[i] = sequence * 31 + static_cast<int64_t>(i);
+  }
+  return payload;
+}
+
+bool IsConsistent(const Payload& payload) {
+  return payload.data == MakePayload(payload.sequence).data;
+}
+
+TEST(TripleBufferTest, ReadsInitialValueBeforeFirstWrite) {
+  TripleBuffer<int> buffer(7);
+  EXPECT_EQ(buffer.Read(), 7);
+  EXPECT_EQ(buffer.Read(), 7);
+}
+
+TEST(TripleBufferTest, ReadsLatestWrite) {
+  TripleBuffer<int> buffer(0);
+  buffer.Write(1);
+  EXPECT_EQ(buffer.Read(), 1);
+
+  // Intermediate values are skipped.
+  buffer.Write(2);
+  buffer.Write(3);
+  buffer.Write(4);
+  EXPECT_EQ(buffer.Read(), 4);
+
+  // Without a new write, the same value is read again.
+  EXPECT_EQ(buffer.Read(), 4);
+  buffer.Write(5);
+  EXPECT_EQ(buffer.Read(), 5);
+}
+
+TEST(TripleBufferTest, WritesAfterReadDoNotTouchReadValue) {
+  TripleBuffer<int> buffer(0);
+  buffer.Write(1);
+  const int& value = buffer.Read();
+
+  // The consumer slot is never handed to the producer until the next Read().
+  buffer.Write(2);
+  buffer.Write(3);
+  buffer.Write(4);
+  EXPECT_EQ(value, 1);
+  EXPECT_EQ(buffer.Read(), 4);
+}
+
+// One producer publishes an increasing sequence while one consumer reads
+// concurrently. The consumer must never see a torn value or go back in the
+// sequence, and must end on the last published value.
+TEST(TripleBufferTest, ConcurrentHandoffIsConsistentAndMonotonic) {
+  constexpr int64_t kWriteCount = 200000;
+  TripleBuffer<Payload> buffer(MakePayload(0));
+  std::atomic<bool> done(false);
+
+  std::thread producer([&buffer, &done]() {
+    for (int64_t sequence = 1; sequence <= kWriteCount; ++sequence) {
+      buffer.Write(MakePayload(sequence));
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  int64_t last_sequence = 0;
+  int64_t distinct_reads = 0;
+  bool consistent = true;
+  bool monotonic = true;
+  while (true) {
+    const bool producer_done = done.load(std::memory_order_acquire);
+    const Payload& payload = buffer.Read();
+    consistent = consistent && IsConsistent(payload);
+    monotonic = monotonic && payload.sequence >= last_sequence;
+    if (payload.sequence != last_sequence) {
+      ++distinct_reads;
+    }
+    last_sequence = payload.sequence;
+    // Reads after the producer finished see its last value.
+    if (producer_done) {
+      break;
+    }
+  }
+  producer.join();
+
+  EXPECT_TRUE(consistent);
+  EXPECT_TRUE(monotonic);
+  EXPECT_EQ(last_sequence, kWriteCount);
+  EXPECT_GT(distinct_reads, 0);
+}
+
+}  // namespace
+}  // namespace cardboard
@@ -21,6 +21,7 @@
 #include "unity/xr_unity_plugin/cardboard_xr_unity.h"
 #include "unity/xr_provider/load.h"
 #include "unity/xr_provider/math_tools.h"
+#include "util/trace.h"
 #include "IUnityInterface.h"
 #include "IUnityXRDisplay.h"
 #include "IUnityXRTrace.h"
@@ -104,6 +105,7 @@ class CardboardDisplayProvider {
 
   UnitySubsystemErrorCode GfxThread_Start(
       UnityXRRenderingCapabilities* rendering_caps) const {
+    CARDBOARD_TRACE_SCOPE("CardboardDisplayProvider::GfxThread_Start");
     // The display provider uses multipass redering.
     rendering_caps->noSinglePassRenderingSupport = true;
     rendering_caps->invalidateRenderStateAfterEachCallback = true;
@@ -114,6 +116,8 @@ class CardboardDisplayProvider {
   }
 
   UnitySubsystemErrorCode GfxThread_SubmitCurrentFrame() {
+    CARDBOARD_TRACE_SCOPE(
+        "CardboardDisplayProvider::GfxThread_SubmitCurrentFrame");
     if (!is_initialized_) {
       CARDBOARD_DISPLAY_XR_TRACE_LOG(
           trace_, "Skip the rendering because Cardboard SDK is uninitialized.");
@@ -127,6 +131,8 @@ class CardboardDisplayProvider {
   UnitySubsystemErrorCode GfxThread_PopulateNextFrameDesc(
       const UnityXRFrameSetupHints* frame_hints,
       UnityXRNextFrameDesc* next_frame) {
+    CARDBOARD_TRACE_SCOPE(
+        "CardboardDisplayProvider::GfxThread_PopulateNextFrameDesc");
     // Allocate new color texture descriptors if needed and update device
     // parameters in Cardboard SDK.
     if ((frame_hints->changedFlags &
@@ -220,6 +226,7 @@ class CardboardDisplayProvider {
   }
 
   UnitySubsystemErrorCode GfxThread_Stop() {
+    CARDBOARD_TRACE_SCOPE("CardboardDisplayProvider::GfxThread_Stop");
     cardboard_api_.reset();
     is_initialized_ = false;
     return kUnitySubsystemErrorCodeSuccess;
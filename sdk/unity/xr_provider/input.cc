@@ -128,10 +128,18 @@ class CardboardInputProvider {
   UnitySubsystemErrorCode Tick() {
     std::array<float, 4> out_orientation;
     std::array<float, 3> out_position;
-    cardboard_api_->GetHeadTrackerPose(out_position.data(),
-                                       out_orientation.data());
+    std::array<float, 3> out_angular_velocity;
+    std::array<float, 3> out_angular_acceleration;
+    cardboard_api_->GetHeadTrackerPoseWithDerivatives(
+        out_position.data(), out_orientation.data(),
+        out_angular_velocity.data(), out_angular_acceleration.data());
     // TODO(b/151817737): Compute pose position within SDK with custom rotation.
     head_pose_ = cardboard::unity::CardboardRotationToUnityPose(out_orientation);
+    head_angular_velocity_ = cardboard::unity::CardboardAngularDerivativeToUnity(
+        out_orientation, out_angular_velocity);
+    head_angular_acceleration_ =
+        cardboard::unity::CardboardAngularDerivativeToUnity(
+            out_orientation, out_angular_acceleration);
     return kUnitySubsystemErrorCodeSuccess;
   }
 
@@ -151,6 +159,13 @@ class CardboardInputProvider {
     input_->DeviceDefinition_AddFeatureWithUsage(
         definition, "Center Eye Rotation", kUnityXRInputFeatureTypeRotation,
         kUnityXRInputFeatureUsageCenterEyeRotation);
+    input_->DeviceDefinition_AddFeatureWithUsage(
+        definition, "Device Angular Velocity", kUnityXRInputFeatureTypeAxis3D,
+        kUnityXRInputFeatureUsageDeviceAngularVelocity);
+    input_->DeviceDefinition_AddFeatureWithUsage(
+        definition, "Device Angular Acceleration",
+        kUnityXRInputFeatureTypeAxis3D,
+        kUnityXRInputFeatureUsageDeviceAngularAcceleration);
 
     return kUnitySubsystemErrorCodeSuccess;
   }
@@ -166,6 +181,10 @@ class CardboardInputProvider {
                                        head_pose_.position);
     input_->DeviceState_SetRotationValue(state, feature_index++,
                                          head_pose_.rotation);
+    input_->DeviceState_SetAxis3DValue(state, feature_index++,
+                                       head_angular_velocity_);
+    input_->DeviceState_SetAxis3DValue(state, feature_index++,
+                                       head_angular_acceleration_);
 
     return kUnitySubsystemErrorCodeSuccess;
   }
@@ -203,6 +222,10 @@ class CardboardInputProvider {
 
   UnityXRPose head_pose_;
 
+  UnityXRVector3 head_angular_velocity_;
+
+  UnityXRVector3 head_angular_acceleration_;
+
   std::unique_ptr<cardboard::unity::CardboardApi> cardboard_api_;
 
   static std::unique_ptr<CardboardInputProvider> cardboard_input_provider_;
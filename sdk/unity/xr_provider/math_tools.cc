@@ -132,6 +132,23 @@ UnityXRPose CardboardRotationToUnityPose(const std::array<float, 4>& rotation) {
   return result;
 }
 
+UnityXRVector3 CardboardAngularDerivativeToUnity(
+    const std::array<float, 4>& rotation,
+    const std::array<float, 3>& angular_derivative) {
+  // Cardboard orientation rotates world space into head space, so its inverse
+  // brings the head frame vector into world space.
+  const UnityXRVector4 head_to_world = {-rotation.at(0), -rotation.at(1),
+                                        -rotation.at(2), rotation.at(3)};
+  const UnityXRVector3 world = QuatMulVec(
+      head_to_world,
+      {angular_derivative.at(0), angular_derivative.at(1),
+       angular_derivative.at(2)});
+
+  // Mirroring the z axis to change handedness flips the rotation sense around
+  // the other two axes.
+  return {-world.x, -world.y, world.z};
+}
+
 // TODO(b/155113586): refactor this function to be part of the same
 //                    transformation as the above.
 UnityXRPose CardboardTransformToUnityPose(
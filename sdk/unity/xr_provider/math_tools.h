@@ -30,6 +30,17 @@ namespace unity {
 /// @returns A UnityXRPose from Cardboard @p rotation.
 UnityXRPose CardboardRotationToUnityPose(const std::array<float, 4>& rotation);
 
+/// @brief Converts a Cardboard head angular velocity or acceleration to a
+///        Unity tracking space one.
+/// @param rotation The Cardboard rotation quaternion of the head expressed as
+///        [x, y, z, w].
+/// @param angular_derivative A Cardboard angular velocity or acceleration
+///        expressed in head frame axes.
+/// @returns @p angular_derivative expressed in Unity's tracking space.
+UnityXRVector3 CardboardAngularDerivativeToUnity(
+    const std::array<float, 4>& rotation,
+    const std::array<float, 3>& angular_derivative);
+
 /// @brief Creates a UnityXRPose from a Cardboard transformation matrix.
 /// @param transform A 4x4 float transformation matrix.
 /// @returns A UnityXRPose from Cardboard @p transform.
@@ -77,8 +77,20 @@ void NSLog(CFStringRef format, ...);
 #define LOGF(...)
 #endif
 
-// @def Forwards the call to CheckGlError().
-#define CHECKGLERROR(label) CheckGlError(__FILE__, __LINE__)
+// @def Forwards the call to CheckGlError() when the SDK GL validation level is
+//      kGlValidationSynchronous. Checks are compiled out when
+//      CARDBOARD_DISABLE_GL_VALIDATION is defined.
+#ifdef CARDBOARD_DISABLE_GL_VALIDATION
+#define CHECKGLERROR(label)
+#else
+#define CHECKGLERROR(label)                                    \
+  do {                                                         \
+    if (CardboardDistortionRenderer_getGlValidationLevel() ==  \
+        kGlValidationSynchronous) {                            \
+      CheckGlError(__FILE__, __LINE__);                        \
+    }                                                          \
+  } while (false)
+#endif
 
 namespace {
 /**
@@ -276,6 +288,29 @@ class CardboardApi::CardboardApiImpl {
                                  position, orientation);
   }
 
+  void GetHeadTrackerPoseWithDerivatives(float* position, float* orientation,
+                                         float* angular_velocity,
+                                         float* angular_acceleration) {
+    if (head_tracker_ == nullptr) {
+      LOGW("Uninitialized head tracker was queried for the pose.");
+      for (int i = 0; i < 3; ++i) {
+        position[i] = 0.0f;
+        angular_velocity[i] = 0.0f;
+        angular_acceleration[i] = 0.0f;
+      }
+      orientation[0] = 0.0f;
+      orientation[1] = 0.0f;
+      orientation[2] = 0.0f;
+      orientation[3] = 1.0f;
+      return;
+    }
+    CardboardHeadTracker_getPoseWithDerivatives(
+        head_tracker_.get(),
+        CardboardApiImpl::GetMonotonicTimeNano() +
+            kPredictionTimeWithoutVsyncNanos,
+        position, orientation, angular_velocity, angular_acceleration);
+  }
+
   static void ScanDeviceParams() {
     CardboardQrCode_scanQrCodeAndSaveDeviceParams();
   }
@@ -711,6 +746,13 @@ void CardboardApi::GetHeadTrackerPose(float* position, float* orientation) {
   p_impl_->GetHeadTrackerPose(position, orientation);
 }
 
+void CardboardApi::GetHeadTrackerPoseWithDerivatives(
+    float* position, float* orientation, float* angular_velocity,
+    float* angular_acceleration) {
+  p_impl_->GetHeadTrackerPoseWithDerivatives(
+      position, orientation, angular_velocity, angular_acceleration);
+}
+
 void CardboardApi::ScanDeviceParams() { CardboardApiImpl::ScanDeviceParams(); }
 
 void CardboardApi::UpdateDeviceParams() { p_impl_->UpdateDeviceParams(); }
@@ -84,6 +84,25 @@ class CardboardApi {
   // TODO(b/154305848): Move argument types to std::array*.
   void GetHeadTrackerPose(float* position, float* orientation);
 
+  /// @brief Gets the pose of the HeadTracker module along with the head
+  ///        angular velocity and acceleration.
+  /// @details When the HeadTracker has not been initialized, @p position,
+  ///          @p angular_velocity and @p angular_acceleration are zeroed and
+  ///          @p orientation is set to identity.
+  /// @param[out] position A pointer to an array with three floats to fill in
+  ///             the position of the head.
+  /// @param[out] orientation A pointer to an array with four floats to fill in
+  ///             the quaternion that denotes the orientation of the head.
+  /// @param[out] angular_velocity A pointer to an array with three floats to
+  ///             fill in the angular velocity of the head in radians per
+  ///             second, in head frame axes.
+  /// @param[out] angular_acceleration A pointer to an array with three floats
+  ///             to fill in the angular acceleration of the head in radians
+  ///             per second squared, in head frame axes.
+  void GetHeadTrackerPoseWithDerivatives(float* position, float* orientation,
+                                         float* angular_velocity,
+                                         float* angular_acceleration);
+
   /// @brief Triggers a device parameters scan.
   /// @pre When using Android, the pointer to `JavaVM` must be previously set.
   void ScanDeviceParams();
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/latency_histogram.h"
+
+#include <algorithm>
+
+namespace cardboard {
+
+constexpr int LatencyHistogram::kSubBucketBits;
+constexpr int LatencyHistogram::kSubBucketCount;
+constexpr int LatencyHistogram::kMaxExponent;
+constexpr int LatencyHistogram::kBucketCount;
+
+LatencyHistogram::LatencyHistogram() { Reset(); }
+
+void LatencyHistogram::Record(int64_t latency_ns) {
+  const uint64_t latency = latency_ns > 0 ? latency_ns : 0;
+  buckets_[BucketIndex(latency)].fetch_add(1, std::memory_order_relaxed);
+  sum_ns_.fetch_add(latency, std::memory_order_relaxed);
+  uint64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+  while (latency > max_ns &&
+         !max_ns_.compare_exchange_weak(max_ns, latency,
+                                        std::memory_order_relaxed)) {
+  }
+}
+
+LatencyHistogram::Stats LatencyHistogram::GetStats() const {
+  std::array<uint64_t, kBucketCount> bucket_counts;
+  uint64_t count = 0;
+  for (int i = 0; i < kBucketCount; ++i) {
+    bucket_counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    count += bucket_counts[i];
+  }
+  if (count == 0) {
+    return {0, 0, 0, 0, 0, 0};
+  }
+
+  Stats stats;
+  stats.count = static_cast<int64_t>(count);
+  stats.mean_ns =
+      static_cast<int64_t>(sum_ns_.load(std::memory_order_relaxed) / count);
+  stats.max_ns = static_cast<int64_t>(max_ns_.load(std::memory_order_relaxed));
+  stats.p50_ns = Percentile(bucket_counts, count, 0.5);
+  stats.p90_ns = Percentile(bucket_counts, count, 0.9);
+  stats.p99_ns = Percentile(bucket_counts, count, 0.99);
+  return stats;
+}
+
+void LatencyHistogram::Reset() {
+  for (std::atomic<uint64_t>& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  sum_ns_.store(0, std::memory_order_relaxed);
+  max_ns_.store(0, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::BucketIndex(uint64_t latency_ns) {
+  // Values below kSubBucketCount have one bucket each.
+  if (latency_ns < kSubBucketCount) {
+    return static_cast<int>(latency_ns);
+  }
+  const int exponent = 63 - __builtin_clzll(latency_ns);
+  if (exponent > kMaxExponent) {
+    return kBucketCount - 1;
+  }
+  const int shift = exponent - kSubBucketBits;
+  const int sub_bucket =
+      static_cast<int>(latency_ns >> shift) & (kSubBucketCount - 1);
+  return kSubBucketCount * (shift + 1) + sub_bucket;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(int bucket) {
+  if (bucket < kSubBucketCount) {
+    return bucket + 1;
+  }
+  const int shift = bucket / kSubBucketCount - 1;
+  const uint64_t sub_bucket = bucket % kSubBucketCount;
+  return (kSubBucketCount + sub_bucket + 1) << shift;
+}
+
+int64_t LatencyHistogram::Percentile(
+    const std::array<uint64_t, kBucketCount>& bucket_counts, uint64_t count,
+    double percentile) const {
+  const uint64_t rank =
+      std::max<uint64_t>(static_cast<uint64_t>(percentile * count), 1);
+  uint64_t cumulative_count = 0;
+  int bucket = 0;
+  for (; bucket < kBucketCount - 1; ++bucket) {
+    cumulative_count += bucket_counts[bucket];
+    if (cumulative_count >= rank) {
+      break;
+    }
+  }
+  return static_cast<int64_t>(std::min(
+      BucketUpperBound(bucket), max_ns_.load(std::memory_order_relaxed)));
+}
+
+}  // namespace cardboard
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_LATENCY_HISTOGRAM_H_
+#define CARDBOARD_SDK_UTIL_LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace cardboard {
+
+// Lock-free histogram of latencies in nanoseconds with fixed buckets.
+//
+// Buckets are log-linear: every power of two range is split into 4 equal
+// buckets, so percentiles are reported with at most 25% relative error while
+// recording a value is a few relaxed atomic operations. It covers latencies up
+// to 2^34 ns (about 17 s); larger values fall into the last bucket.
+//
+// Record, GetStats and Reset may be called concurrently from any thread.
+// Statistics read while values are being recorded may be slightly
+// inconsistent with each other.
+class LatencyHistogram {
+ public:
+  // Summary of the recorded latencies. All values are zero if no latency was
+  // recorded.
+  struct Stats {
+    // Number of recorded latencies.
+    int64_t count;
+    // Mean latency.
+    int64_t mean_ns;
+    // Latency percentiles. Each one is the upper bound of the bucket holding
+    // it, capped to max_ns.
+    int64_t p50_ns;
+    int64_t p90_ns;
+    int64_t p99_ns;
+    // Maximum latency.
+    int64_t max_ns;
+  };
+
+  LatencyHistogram();
+
+  // Records a latency. Negative latencies, e.g. due to clock jitter, are
+  // recorded as zero.
+  //
+  // @param latency_ns latency in nanoseconds.
+  void Record(int64_t latency_ns);
+
+  // Returns a summary of the latencies recorded since the last reset.
+  Stats GetStats() const;
+
+  // Clears all recorded latencies.
+  void Reset();
+
+ private:
+  // Number of linear buckets per power of two range.
+  static constexpr int kSubBucketBits = 2;
+  static constexpr int kSubBucketCount = 1 << kSubBucketBits;
+  // Largest power of two range with its own buckets.
+  static constexpr int kMaxExponent = 33;
+  static constexpr int kBucketCount =
+      kSubBucketCount * (kMaxExponent - kSubBucketBits + 2);
+
+  // Returns the bucket holding latency_ns.
+  static int BucketIndex(uint64_t latency_ns);
+
+  // Returns the smallest latency that is larger than all latencies in bucket.
+  static uint64_t BucketUpperBound(int bucket);
+
+  // Returns the upper bound of the bucket holding the given percentile.
+  int64_t Percentile(
+      const std::array<uint64_t, kBucketCount>& bucket_counts,
+      uint64_t count, double percentile) const;
+
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_;
+  std::atomic<uint64_t> sum_ns_;
+  std::atomic<uint64_t> max_ns_;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_LATENCY_HISTOGRAM_H_
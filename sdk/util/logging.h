@@ -34,8 +34,14 @@
 
 #else
 
-#define CARDBOARD_LOGI(...)
-#define CARDBOARD_LOGE(...)
+#include <cstdio>
+
+// There is no system log on other platforms. The arguments are kept in an
+// unevaluated operand, so that they count as used and are format checked.
+#define CARDBOARD_LOGI(...) \
+  static_cast<void>(sizeof(std::printf(__VA_ARGS__)))
+#define CARDBOARD_LOGE(...) \
+  static_cast<void>(sizeof(std::printf(__VA_ARGS__)))
 
 #endif
 
@@ -15,6 +15,8 @@
  */
 #include "util/matrix_3x3.h"
 
+#include "util/simd_math.h"
+
 namespace cardboard {
 
 Matrix3x3::Matrix3x3(double m00, double m01, double m02, double m10, double m11,
@@ -83,13 +85,7 @@ Matrix3x3 Matrix3x3::Subtraction(const Matrix3x3& lhs, const Matrix3x3& rhs) {
 
 Matrix3x3 Matrix3x3::Product(const Matrix3x3& m0, const Matrix3x3& m1) {
   Matrix3x3 result;
-  for (int row = 0; row < 3; ++row) {
-    for (int col = 0; col < 3; ++col) {
-      result.elem_[row][col] = 0;
-      for (int i = 0; i < 3; ++i)
-        result.elem_[row][col] += m0.elem_[row][i] * m1.elem_[i][col];
-    }
-  }
+  simd_math::Matrix3x3Multiply(m0.Data(), m1.Data(), result.Data());
   return result;
 }
 
@@ -21,30 +21,12 @@ namespace cardboard {
 
 namespace {
 
-// Returns true if the cofactor for a given row and column should be negated.
-static bool IsCofactorNegated(int row, int col) {
-  // Negated iff (row + col) is odd.
-  return ((row + col) & 1) != 0;
-}
-
-static double CofactorElement3(const Matrix3x3& m, int row, int col) {
-  static const int index[3][2] = {{1, 2}, {0, 2}, {0, 1}};
-  const int i0 = index[row][0];
-  const int i1 = index[row][1];
-  const int j0 = index[col][0];
-  const int j1 = index[col][1];
-  const double cofactor = m(i0, j0) * m(i1, j1) - m(i0, j1) * m(i1, j0);
-  return IsCofactorNegated(row, col) ? -cofactor : cofactor;
-}
-
 // Multiplies a matrix and some type of column vector to
 // produce another column vector of the same type.
 Vector3 MultiplyMatrixAndVector(const Matrix3x3& m, const Vector3& v) {
-  Vector3 result = Vector3::Zero();
-  for (int row = 0; row < 3; ++row) {
-    for (int col = 0; col < 3; ++col) result[row] += m(row, col) * v[col];
-  }
-  return result;
+  return Vector3(m(0, 0) * v[0] + m(0, 1) * v[1] + m(0, 2) * v[2],
+                 m(1, 0) * v[0] + m(1, 1) * v[1] + m(1, 2) * v[2],
+                 m(2, 0) * v[0] + m(2, 1) * v[1] + m(2, 2) * v[2]);
 }
 
 // Sets the upper 3x3 of a Matrix to represent a 3D rotation.
@@ -90,12 +72,17 @@ Vector3 operator*(const Matrix3x3& m, const Vector3& v) {
 }
 
 Matrix3x3 CofactorMatrix(const Matrix3x3& m) {
-  Matrix3x3 result;
-  for (int row = 0; row < 3; ++row) {
-    for (int col = 0; col < 3; ++col)
-      result(row, col) = CofactorElement3(m, row, col);
-  }
-  return result;
+  // Each cofactor is the signed determinant of the 2x2 minor obtained by
+  // removing its row and column.
+  return Matrix3x3(m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1),
+                   m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2),
+                   m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0),
+                   m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2),
+                   m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0),
+                   m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1),
+                   m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1),
+                   m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2),
+                   m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0));
 }
 
 Matrix3x3 AdjugateWithDeterminant(const Matrix3x3& m, double* determinant) {
@@ -110,11 +97,8 @@ Matrix3x3 AdjugateWithDeterminant(const Matrix3x3& m, double* determinant) {
 
 // Returns the transpose of a matrix.
 Matrix3x3 Transpose(const Matrix3x3& m) {
-  Matrix3x3 result;
-  for (int row = 0; row < 3; ++row) {
-    for (int col = 0; col < 3; ++col) result(row, col) = m(col, row);
-  }
-  return result;
+  return Matrix3x3(m(0, 0), m(1, 0), m(2, 0), m(0, 1), m(1, 1), m(2, 1),
+                   m(0, 2), m(1, 2), m(2, 2));
 }
 
 Matrix3x3 InverseWithDeterminant(const Matrix3x3& m, double* determinant) {
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/metrics.h"
+
+namespace cardboard {
+
+namespace {
+
+// Weight of the latest interval in the moving average of sampling intervals.
+// It averages roughly the last 20 samples.
+constexpr double kRateSmoothingFactor = 0.05;
+
+// Intervals longer than this, e.g. while sensors are paused, are not sampling
+// intervals and are ignored.
+constexpr double kMaxSamplingInterval_s = 1.0;
+
+}  // namespace
+
+Metrics::Metrics()
+    : accelerometer_outdated_samples_(0),
+      gyroscope_outdated_samples_(0),
+      gyroscope_timestep_fallbacks_(0) {}
+
+Metrics& Metrics::GetInstance() {
+  // Never destroyed, so sensor threads can still record during exit.
+  static Metrics* instance = new Metrics();
+  return *instance;
+}
+
+void Metrics::RecordDuration(Timing timing, int64_t duration_ns) {
+  switch (timing) {
+    case Timing::kFusion:
+      fusion_time_.Record(duration_ns);
+      break;
+    case Timing::kDistortionSubmit:
+      distortion_submit_time_.Record(duration_ns);
+      break;
+  }
+}
+
+Metrics::Snapshot Metrics::GetSnapshot() const {
+  Snapshot snapshot;
+  snapshot.accelerometer_rate_hz = accelerometer_rate_.GetRateHz();
+  snapshot.gyroscope_rate_hz = gyroscope_rate_.GetRateHz();
+  snapshot.accelerometer_outdated_samples =
+      accelerometer_outdated_samples_.load(std::memory_order_relaxed);
+  snapshot.gyroscope_outdated_samples =
+      gyroscope_outdated_samples_.load(std::memory_order_relaxed);
+  snapshot.gyroscope_timestep_fallbacks =
+      gyroscope_timestep_fallbacks_.load(std::memory_order_relaxed);
+  snapshot.fusion_time = fusion_time_.GetStats();
+  snapshot.distortion_submit_time = distortion_submit_time_.GetStats();
+  return snapshot;
+}
+
+void Metrics::Reset() {
+  accelerometer_rate_.Reset();
+  gyroscope_rate_.Reset();
+  accelerometer_outdated_samples_.store(0, std::memory_order_relaxed);
+  gyroscope_outdated_samples_.store(0, std::memory_order_relaxed);
+  gyroscope_timestep_fallbacks_.store(0, std::memory_order_relaxed);
+  fusion_time_.Reset();
+  distortion_submit_time_.Reset();
+}
+
+Metrics::RateEstimator::RateEstimator()
+    : last_timestamp_ns_(0), mean_interval_s_(0.0) {}
+
+void Metrics::RateEstimator::AddSample(uint64_t timestamp_ns) {
+  const uint64_t last_timestamp_ns =
+      last_timestamp_ns_.exchange(timestamp_ns, std::memory_order_relaxed);
+  if (last_timestamp_ns == 0 || timestamp_ns <= last_timestamp_ns) {
+    return;
+  }
+  const double interval_s = (timestamp_ns - last_timestamp_ns) * 1e-9;
+  if (interval_s > kMaxSamplingInterval_s) {
+    return;
+  }
+  const double mean_interval_s =
+      mean_interval_s_.load(std::memory_order_relaxed);
+  mean_interval_s_.store(
+      mean_interval_s == 0.0
+          ? interval_s
+          : mean_interval_s +
+                kRateSmoothingFactor * (interval_s - mean_interval_s),
+      std::memory_order_relaxed);
+}
+
+float Metrics::RateEstimator::GetRateHz() const {
+  const double mean_interval_s =
+      mean_interval_s_.load(std::memory_order_relaxed);
+  return mean_interval_s > 0.0 ? static_cast<float>(1.0 / mean_interval_s)
+                               : 0.0f;
+}
+
+void Metrics::RateEstimator::Reset() {
+  last_timestamp_ns_.store(0, std::memory_order_relaxed);
+  mean_interval_s_.store(0.0, std::memory_order_relaxed);
+}
+
+}  // namespace cardboard
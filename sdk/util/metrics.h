@@ -0,0 +1,150 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_METRICS_H_
+#define CARDBOARD_SDK_UTIL_METRICS_H_
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+
+#include "util/latency_histogram.h"
+
+namespace cardboard {
+
+// Process wide runtime metrics of the sensor and rendering pipelines, meant
+// for telemetry. Recording only uses relaxed atomic operations so it can stay
+// on in the hot paths.
+//
+// Each sensor sample type must be recorded from a single thread at a time,
+// which is the case for the sensor threads. Everything else may be called
+// from any thread.
+class Metrics {
+ public:
+  // Durations measured by ScopedTimer.
+  enum class Timing {
+    // Sensor fusion of one accelerometer or gyroscope sample.
+    kFusion,
+    // CPU time to submit the distortion pass of a frame.
+    kDistortionSubmit,
+  };
+
+  // Snapshot of the metrics since the last reset.
+  struct Snapshot {
+    // Effective sampling rates in Hz, zero until two samples were received.
+    float accelerometer_rate_hz;
+    float gyroscope_rate_hz;
+    // Samples discarded by the sensor fusion because they were older than the
+    // latest processed one.
+    int64_t accelerometer_outdated_samples;
+    int64_t gyroscope_outdated_samples;
+    // Gyroscope samples whose timestep exceeded the maximum sample delay and
+    // was replaced by the filtered timestep.
+    int64_t gyroscope_timestep_fallbacks;
+    // Durations of the Timing stages.
+    LatencyHistogram::Stats fusion_time;
+    LatencyHistogram::Stats distortion_submit_time;
+  };
+
+  // Records the duration of a Timing stage for the lifetime of the object.
+  class ScopedTimer {
+   public:
+    explicit ScopedTimer(Timing timing)
+        : timing_(timing), begin_time_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+      GetInstance().RecordDuration(
+          timing_, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - begin_time_)
+                       .count());
+    }
+
+   private:
+    const Timing timing_;
+    const std::chrono::steady_clock::time_point begin_time_;
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+  };
+
+  // Returns the process wide instance.
+  static Metrics& GetInstance();
+
+  // Records a sensor sample accepted by the sensor fusion.
+  //
+  // @param sensor_timestamp_ns sensor time of the sample.
+  void RecordAccelerometerSample(uint64_t sensor_timestamp_ns) {
+    accelerometer_rate_.AddSample(sensor_timestamp_ns);
+  }
+  void RecordGyroscopeSample(uint64_t sensor_timestamp_ns) {
+    gyroscope_rate_.AddSample(sensor_timestamp_ns);
+  }
+
+  // Records a sensor sample discarded as outdated.
+  void RecordOutdatedAccelerometerSample() {
+    accelerometer_outdated_samples_.fetch_add(1, std::memory_order_relaxed);
+  }
+  void RecordOutdatedGyroscopeSample() {
+    gyroscope_outdated_samples_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Records a gyroscope timestep replaced by the filtered timestep.
+  void RecordGyroscopeTimestepFallback() {
+    gyroscope_timestep_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Records the duration of a Timing stage.
+  //
+  // @param timing measured stage.
+  // @param duration_ns duration in nanoseconds.
+  void RecordDuration(Timing timing, int64_t duration_ns);
+
+  // Returns the metrics recorded since the last reset.
+  Snapshot GetSnapshot() const;
+
+  // Clears all metrics.
+  void Reset();
+
+ private:
+  // Estimates a sampling rate from an exponential moving average of the
+  // intervals between sample timestamps.
+  class RateEstimator {
+   public:
+    RateEstimator();
+    void AddSample(uint64_t timestamp_ns);
+    float GetRateHz() const;
+    void Reset();
+
+   private:
+    std::atomic<uint64_t> last_timestamp_ns_;
+    std::atomic<double> mean_interval_s_;
+  };
+
+  Metrics();
+
+  RateEstimator accelerometer_rate_;
+  RateEstimator gyroscope_rate_;
+  std::atomic<int64_t> accelerometer_outdated_samples_;
+  std::atomic<int64_t> gyroscope_outdated_samples_;
+  std::atomic<int64_t> gyroscope_timestep_fallbacks_;
+  LatencyHistogram fusion_time_;
+  LatencyHistogram distortion_submit_time_;
+
+  Metrics(const Metrics&) = delete;
+  Metrics& operator=(const Metrics&) = delete;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_METRICS_H_
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_RING_BUFFER_H_
+#define CARDBOARD_SDK_UTIL_RING_BUFFER_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace cardboard {
+
+// Fixed capacity FIFO ring buffer. Storage is allocated once at construction,
+// so pushing elements never allocates. When the buffer is full, pushing a new
+// element overwrites the oldest one.
+template <typename T>
+class RingBuffer {
+ public:
+  // Creates a ring buffer that holds at most capacity elements.
+  // @param capacity maximum number of elements stored in the buffer.
+  explicit RingBuffer(size_t capacity)
+      : storage_(capacity), head_(0), size_(0) {}
+
+  // Appends value at the back of the buffer.
+  //
+  // @param value element to append.
+  // @param evicted if not null and the buffer was full, it is set to the
+  //     element that got dropped from the front of the buffer.
+  // @return true if an element was evicted to make room for value.
+  bool PushBack(const T& value, T* evicted = nullptr) {
+    if (storage_.empty()) {
+      return false;
+    }
+    const size_t slot = SlotOf(size_);
+    if (size_ < storage_.size()) {
+      storage_[slot] = value;
+      ++size_;
+      return false;
+    }
+    // Buffer is full, the back slot is the front one. Overwrite it and move
+    // the front forward.
+    if (evicted) {
+      *evicted = storage_[slot];
+    }
+    storage_[slot] = value;
+    head_ = SlotOf(1);
+    return true;
+  }
+
+  // Returns the element at position index, with 0 being the oldest element.
+  const T& operator[](size_t index) const { return storage_[SlotOf(index)]; }
+
+  // Returns the storage slot holding the element at position index. Slots are
+  // stable for the lifetime of an element in the buffer.
+  size_t SlotOf(size_t index) const {
+    const size_t slot = head_ + index;
+    return slot < storage_.size() ? slot : slot - storage_.size();
+  }
+
+  // Returns the element stored in the given storage slot.
+  const T& AtSlot(size_t slot) const { return storage_[slot]; }
+
+  // Returns the number of elements currently stored.
+  size_t Size() const { return size_; }
+
+  // Returns the maximum number of elements the buffer can hold.
+  size_t Capacity() const { return storage_.size(); }
+
+  // Returns true if the buffer holds Capacity() elements.
+  bool IsFull() const { return size_ == storage_.size(); }
+
+  // Removes all elements. This does not release the storage.
+  void Clear() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+ private:
+  std::vector<T> storage_;
+  // Storage slot of the oldest element.
+  size_t head_;
+  // Number of elements currently stored.
+  size_t size_;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_RING_BUFFER_H_
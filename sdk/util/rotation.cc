@@ -15,6 +15,7 @@
  */
 #include "util/rotation.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -75,7 +76,8 @@ Rotation Rotation::FromRotationMatrix(const Matrix3x3& mat) {
 void Rotation::GetAxisAndAngle(VectorType* axis, double* angle) const {
   VectorType vec(quat_[0], quat_[1], quat_[2]);
   if (Normalize(&vec)) {
-    *angle = 2 * acos(quat_[3]);
+    // The scalar part can exceed one by the normalization tolerance.
+    *angle = 2 * acos(std::min(1.0, std::max(-1.0, quat_[3])));
     *axis = vec;
   } else {
     *axis = VectorType(1, 0, 0);
@@ -16,7 +16,10 @@
 #ifndef CARDBOARD_SDK_UTIL_ROTATION_H_
 #define CARDBOARD_SDK_UTIL_ROTATION_H_
 
+#include <cmath>
+
 #include "util/matrix_3x3.h"
+#include "util/simd_math.h"
 #include "util/vector.h"
 #include "util/vectorutils.h"
 
@@ -24,6 +27,12 @@ namespace cardboard {
 
 // The Rotation class represents a rotation around a 3-dimensional axis. It
 // uses normalized quaternions internally to make the math robust.
+//
+// It is double precision only, like the Vector and Matrix3x3 it builds on.
+// Its users, the EKF and the pose prediction, keep their state in double. A
+// float instantiation would turn all three classes into templates on the
+// scalar type with no caller for it, so single precision pose math calls the
+// float kernels of util/simd_math.h on arrays instead.
 class Rotation {
  public:
   // Convenience typedefs for vector of the correct type.
@@ -41,7 +50,8 @@ class Rotation {
     quat_ = Normalized(quaternion);
   }
 
-  // Returns the Rotation as a normalized quaternion (4D vector).
+  // Returns the Rotation as a normalized quaternion (4D vector). Its squared
+  // norm is within kNormalizationTolerance of one.
   const QuaternionType& GetQuaternion() const { return quat_; }
 
   // Sets the Rotation to rotate by the given angle around the given axis,
@@ -106,13 +116,14 @@ class Rotation {
 
   // Appends a rotation to this one.
   Rotation& operator*=(const Rotation& r) {
-    const QuaternionType& qr = r.quat_;
-    QuaternionType& qt = quat_;
-    SetQuaternion(QuaternionType(
-        qr[3] * qt[0] + qr[0] * qt[3] + qr[2] * qt[1] - qr[1] * qt[2],
-        qr[3] * qt[1] + qr[1] * qt[3] + qr[0] * qt[2] - qr[2] * qt[0],
-        qr[3] * qt[2] + qr[2] * qt[3] + qr[1] * qt[0] - qr[0] * qt[1],
-        qr[3] * qt[3] - qr[0] * qt[0] - qr[1] * qt[1] - qr[2] * qt[2]));
+    simd_math::QuaternionMultiply(quat_.Data(), r.quat_.Data(), quat_.Data());
+    // The product of two unit quaternions only drifts from unit length by
+    // rounding errors, so it is normalized lazily once the drift is
+    // noticeable.
+    const double norm_squared = LengthSquared(quat_);
+    if (std::abs(norm_squared - 1.0) > kNormalizationTolerance) {
+      quat_ /= std::sqrt(norm_squared);
+    }
     return *this;
   }
 
@@ -127,6 +138,10 @@ class Rotation {
   VectorType operator*(const VectorType& v) const;
 
  private:
+  // Maximum deviation of the squared quaternion norm from one before a
+  // product gets normalized.
+  static constexpr double kNormalizationTolerance = 1e-12;
+
   // Private constructor that builds a Rotation from quaternion components.
   Rotation(double q0, double q1, double q2, double q3)
       : quat_(q0, q1, q2, q3) {}
@@ -134,9 +149,9 @@ class Rotation {
   // Applies a Rotation to a Vector to rotate the Vector. Method borrowed from:
   // http://blog.molecular-matters.com/2013/05/24/a-faster-quaternion-vector-multiplication/
   VectorType ApplyToVector(const VectorType& v) const {
-    VectorType im(quat_[0], quat_[1], quat_[2]);
-    VectorType temp = 2.0 * Cross(im, v);
-    return v + quat_[3] * temp + Cross(im, temp);
+    VectorType result;
+    simd_math::QuaternionRotateVector(quat_.Data(), v.Data(), result.Data());
+    return result;
   }
 
   // The rotation represented as a normalized quaternion. (Unit quaternions are
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_SIMD_MATH_H_
+#define CARDBOARD_SDK_UTIL_SIMD_MATH_H_
+
+// Small fixed-size math kernels used by the Vector, Rotation and Matrix3x3
+// classes and by single precision hot paths.
+//
+// The classes are double precision only, see util/rotation.h, so single
+// precision code calls the float kernels on plain arrays. Only the kernels
+// that have a single precision caller have a float variant: the quaternion
+// product and vector rotation, for the head tracker pose composition and the
+// neck model. Matrix3x3Multiply is double only.
+//
+// A NEON or SSE2 implementation is selected at compile time when available,
+// with a scalar fallback. Double precision NEON is only available on AArch64.
+// Defining CARDBOARD_DISABLE_SIMD forces the scalar implementation.
+//
+// Quaternions are stored as [x, y, z, w] and matrices in row-major order.
+
+#if !defined(CARDBOARD_DISABLE_SIMD)
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CARDBOARD_SIMD_NEON 1
+#if defined(__aarch64__)
+#define CARDBOARD_SIMD_NEON_FLOAT64 1
+#endif
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CARDBOARD_SIMD_SSE2 1
+#endif
+#endif  // !defined(CARDBOARD_DISABLE_SIMD)
+
+namespace cardboard {
+namespace simd_math {
+
+// Scalar reference implementations.
+
+// Computes the Hamilton product out = a * b. out may alias a or b.
+template <typename T>
+inline void QuaternionMultiplyScalar(const T* a, const T* b, T* out) {
+  const T x = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+  const T y = a[3] * b[1] + a[1] * b[3] + a[2] * b[0] - a[0] * b[2];
+  const T z = a[3] * b[2] + a[2] * b[3] + a[0] * b[1] - a[1] * b[0];
+  const T w = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+  out[0] = x;
+  out[1] = y;
+  out[2] = z;
+  out[3] = w;
+}
+
+// Computes the matrix product out = a * b. out must not alias a or b.
+template <typename T>
+inline void Matrix3x3MultiplyScalar(const T* a, const T* b, T* out) {
+  for (int row = 0; row < 3; ++row) {
+    const T a0 = a[row * 3];
+    const T a1 = a[row * 3 + 1];
+    const T a2 = a[row * 3 + 2];
+    out[row * 3] = a0 * b[0] + a1 * b[3] + a2 * b[6];
+    out[row * 3 + 1] = a0 * b[1] + a1 * b[4] + a2 * b[7];
+    out[row * 3 + 2] = a0 * b[2] + a1 * b[5] + a2 * b[8];
+  }
+}
+
+// Rotates the 3D vector v by the unit quaternion q = (u, w), computing
+// v + 2w (u x v) + 2u x (u x v). out may alias v.
+//
+// Three wide vectors would need padded storage to benefit from 4 lane
+// registers, so this kernel is scalar on every backend.
+template <typename T>
+inline void QuaternionRotateVector(const T* q, const T* v, T* out) {
+  // t = 2 (u x v).
+  const T t0 = T(2) * (q[1] * v[2] - q[2] * v[1]);
+  const T t1 = T(2) * (q[2] * v[0] - q[0] * v[2]);
+  const T t2 = T(2) * (q[0] * v[1] - q[1] * v[0]);
+  const T x = v[0] + q[3] * t0 + (q[1] * t2 - q[2] * t1);
+  const T y = v[1] + q[3] * t1 + (q[2] * t0 - q[0] * t2);
+  const T z = v[2] + q[3] * t2 + (q[0] * t1 - q[1] * t0);
+  out[0] = x;
+  out[1] = y;
+  out[2] = z;
+}
+
+// Dispatching kernels.
+
+// Computes the Hamilton product out = a * b. out may alias a or b.
+inline void QuaternionMultiply(const float* a, const float* b, float* out) {
+#if defined(CARDBOARD_SIMD_NEON)
+  // out = a.w * b + a.x * [bw, -bz, by, -bx] + a.y * [bz, bw, -bx, -by] +
+  //       a.z * [-by, bx, bw, -bz]
+  const float32x4_t vb = vld1q_f32(b);
+  const float32x4_t b_wzyx = __builtin_shufflevector(vb, vb, 3, 2, 1, 0);
+  const float32x4_t b_zwxy = __builtin_shufflevector(vb, vb, 2, 3, 0, 1);
+  const float32x4_t b_yxwz = __builtin_shufflevector(vb, vb, 1, 0, 3, 2);
+  const float32x4_t sign_x = {1.0f, -1.0f, 1.0f, -1.0f};
+  const float32x4_t sign_y = {1.0f, 1.0f, -1.0f, -1.0f};
+  const float32x4_t sign_z = {-1.0f, 1.0f, 1.0f, -1.0f};
+  float32x4_t result = vmulq_n_f32(vb, a[3]);
+  result = vmlaq_n_f32(result, vmulq_f32(b_wzyx, sign_x), a[0]);
+  result = vmlaq_n_f32(result, vmulq_f32(b_zwxy, sign_y), a[1]);
+  result = vmlaq_n_f32(result, vmulq_f32(b_yxwz, sign_z), a[2]);
+  vst1q_f32(out, result);
+#elif defined(CARDBOARD_SIMD_SSE2)
+  const __m128 vb = _mm_loadu_ps(b);
+  const __m128 b_wzyx = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(0, 1, 2, 3));
+  const __m128 b_zwxy = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(1, 0, 3, 2));
+  const __m128 b_yxwz = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 0, 1));
+  const __m128 sign_x = _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f);
+  const __m128 sign_y = _mm_setr_ps(1.0f, 1.0f, -1.0f, -1.0f);
+  const __m128 sign_z = _mm_setr_ps(-1.0f, 1.0f, 1.0f, -1.0f);
+  __m128 result = _mm_mul_ps(vb, _mm_set1_ps(a[3]));
+  result = _mm_add_ps(
+      result, _mm_mul_ps(_mm_mul_ps(b_wzyx, sign_x), _mm_set1_ps(a[0])));
+  result = _mm_add_ps(
+      result, _mm_mul_ps(_mm_mul_ps(b_zwxy, sign_y), _mm_set1_ps(a[1])));
+  result = _mm_add_ps(
+      result, _mm_mul_ps(_mm_mul_ps(b_yxwz, sign_z), _mm_set1_ps(a[2])));
+  _mm_storeu_ps(out, result);
+#else
+  QuaternionMultiplyScalar(a, b, out);
+#endif
+}
+
+// Computes the Hamilton product out = a * b. out may alias a or b.
+inline void QuaternionMultiply(const double* a, const double* b, double* out) {
+#if defined(CARDBOARD_SIMD_NEON_FLOAT64) || defined(CARDBOARD_SIMD_SSE2)
+  // Same decomposition as the single precision kernel, on the [x, y] and
+  // [z, w] halves.
+#if defined(CARDBOARD_SIMD_NEON_FLOAT64)
+  typedef float64x2_t Lanes;
+  const Lanes b_xy = vld1q_f64(b);
+  const Lanes b_zw = vld1q_f64(b + 2);
+  const Lanes b_yx = vextq_f64(b_xy, b_xy, 1);
+  const Lanes b_wz = vextq_f64(b_zw, b_zw, 1);
+  const Lanes plus_minus = {1.0, -1.0};
+  const Lanes minus_plus = {-1.0, 1.0};
+  const auto mul = [](Lanes l, Lanes r) { return vmulq_f64(l, r); };
+  const auto mul_n = [](Lanes l, double s) { return vmulq_n_f64(l, s); };
+  const auto add = [](Lanes l, Lanes r) { return vaddq_f64(l, r); };
+  const auto sub = [](Lanes l, Lanes r) { return vsubq_f64(l, r); };
+#else
+  typedef __m128d Lanes;
+  const Lanes b_xy = _mm_loadu_pd(b);
+  const Lanes b_zw = _mm_loadu_pd(b + 2);
+  const Lanes b_yx = _mm_shuffle_pd(b_xy, b_xy, 1);
+  const Lanes b_wz = _mm_shuffle_pd(b_zw, b_zw, 1);
+  const Lanes plus_minus = _mm_setr_pd(1.0, -1.0);
+  const Lanes minus_plus = _mm_setr_pd(-1.0, 1.0);
+  const auto mul = [](Lanes l, Lanes r) { return _mm_mul_pd(l, r); };
+  const auto mul_n = [](Lanes l, double s) {
+    return _mm_mul_pd(l, _mm_set1_pd(s));
+  };
+  const auto add = [](Lanes l, Lanes r) { return _mm_add_pd(l, r); };
+  const auto sub = [](Lanes l, Lanes r) { return _mm_sub_pd(l, r); };
+#endif
+  // [x, y] = a.w [bx, by] + a.x [bw, -bz] + a.y [bz, bw] + a.z [-by, bx]
+  Lanes xy = mul_n(b_xy, a[3]);
+  xy = add(xy, mul_n(mul(b_wz, plus_minus), a[0]));
+  xy = add(xy, mul_n(b_zw, a[1]));
+  xy = add(xy, mul_n(mul(b_yx, minus_plus), a[2]));
+  // [z, w] = a.w [bz, bw] + a.x [by, -bx] - a.y [bx, by] + a.z [bw, -bz]
+  Lanes zw = mul_n(b_zw, a[3]);
+  zw = add(zw, mul_n(mul(b_yx, plus_minus), a[0]));
+  zw = sub(zw, mul_n(b_xy, a[1]));
+  zw = add(zw, mul_n(mul(b_wz, plus_minus), a[2]));
+#if defined(CARDBOARD_SIMD_NEON_FLOAT64)
+  vst1q_f64(out, xy);
+  vst1q_f64(out + 2, zw);
+#else
+  _mm_storeu_pd(out, xy);
+  _mm_storeu_pd(out + 2, zw);
+#endif
+#else
+  QuaternionMultiplyScalar(a, b, out);
+#endif
+}
+
+// Computes the matrix product out = a * b. out must not alias a or b.
+inline void Matrix3x3Multiply(const double* a, const double* b, double* out) {
+#if defined(CARDBOARD_SIMD_NEON_FLOAT64) || defined(CARDBOARD_SIMD_SSE2)
+  // Each output row is a linear combination of the rows of b. The first two
+  // columns are computed in vector lanes and the third one in scalar.
+  for (int row = 0; row < 3; ++row) {
+    const double a0 = a[row * 3];
+    const double a1 = a[row * 3 + 1];
+    const double a2 = a[row * 3 + 2];
+#if defined(CARDBOARD_SIMD_NEON_FLOAT64)
+    float64x2_t result = vmulq_n_f64(vld1q_f64(b), a0);
+    result = vfmaq_n_f64(result, vld1q_f64(b + 3), a1);
+    result = vfmaq_n_f64(result, vld1q_f64(b + 6), a2);
+    vst1q_f64(out + row * 3, result);
+#else
+    __m128d result = _mm_mul_pd(_mm_loadu_pd(b), _mm_set1_pd(a0));
+    result =
+        _mm_add_pd(result, _mm_mul_pd(_mm_loadu_pd(b + 3), _mm_set1_pd(a1)));
+    result =
+        _mm_add_pd(result, _mm_mul_pd(_mm_loadu_pd(b + 6), _mm_set1_pd(a2)));
+    _mm_storeu_pd(out + row * 3, result);
+#endif
+    out[row * 3 + 2] = a0 * b[2] + a1 * b[5] + a2 * b[8];
+  }
+#else
+  Matrix3x3MultiplyScalar(a, b, out);
+#endif
+}
+
+}  // namespace simd_math
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_SIMD_MATH_H_
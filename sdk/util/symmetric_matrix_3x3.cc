@@ -0,0 +1,149 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/symmetric_matrix_3x3.h"
+
+#include <cmath>
+
+namespace cardboard {
+
+SymmetricMatrix3x3::SymmetricMatrix3x3() { elem_.fill(0); }
+
+SymmetricMatrix3x3::SymmetricMatrix3x3(double m00, double m01, double m02,
+                                       double m11, double m12, double m22)
+    : elem_{{m00, m01, m02, m11, m12, m22}} {}
+
+SymmetricMatrix3x3 SymmetricMatrix3x3::Zero() { return SymmetricMatrix3x3(); }
+
+SymmetricMatrix3x3 SymmetricMatrix3x3::Identity() {
+  return SymmetricMatrix3x3(1, 0, 0, 1, 0, 1);
+}
+
+SymmetricMatrix3x3 SymmetricMatrix3x3::FromMatrix(const Matrix3x3& m) {
+  return SymmetricMatrix3x3(m(0, 0), 0.5 * (m(0, 1) + m(1, 0)),
+                            0.5 * (m(0, 2) + m(2, 0)), m(1, 1),
+                            0.5 * (m(1, 2) + m(2, 1)), m(2, 2));
+}
+
+Matrix3x3 SymmetricMatrix3x3::ToMatrix() const {
+  return Matrix3x3(elem_[0], elem_[1], elem_[2], elem_[1], elem_[3], elem_[4],
+                   elem_[2], elem_[4], elem_[5]);
+}
+
+SymmetricMatrix3x3 SymmetricMatrix3x3::Scale(const SymmetricMatrix3x3& m,
+                                             double s) {
+  SymmetricMatrix3x3 result;
+  for (int i = 0; i < 6; ++i) {
+    result.elem_[i] = m.elem_[i] * s;
+  }
+  return result;
+}
+
+SymmetricMatrix3x3 SymmetricMatrix3x3::Addition(const SymmetricMatrix3x3& lhs,
+                                                const SymmetricMatrix3x3& rhs) {
+  SymmetricMatrix3x3 result;
+  for (int i = 0; i < 6; ++i) {
+    result.elem_[i] = lhs.elem_[i] + rhs.elem_[i];
+  }
+  return result;
+}
+
+Matrix3x3 SymmetricMatrix3x3::Product(const SymmetricMatrix3x3& m,
+                                      const Matrix3x3& rhs) {
+  const std::array<double, 6>& e = m.elem_;
+  Matrix3x3 result;
+  for (int col = 0; col < 3; ++col) {
+    const double r0 = rhs(0, col);
+    const double r1 = rhs(1, col);
+    const double r2 = rhs(2, col);
+    result(0, col) = e[0] * r0 + e[1] * r1 + e[2] * r2;
+    result(1, col) = e[1] * r0 + e[3] * r1 + e[4] * r2;
+    result(2, col) = e[2] * r0 + e[4] * r1 + e[5] * r2;
+  }
+  return result;
+}
+
+SymmetricMatrix3x3 CongruenceTransform(const Matrix3x3& a,
+                                       const SymmetricMatrix3x3& m) {
+  const double m00 = m(0, 0), m01 = m(0, 1), m02 = m(0, 2);
+  const double m11 = m(1, 1), m12 = m(1, 2), m22 = m(2, 2);
+  // Rows of t = a * m.
+  double t[3][3];
+  for (int i = 0; i < 3; ++i) {
+    const double a0 = a(i, 0);
+    const double a1 = a(i, 1);
+    const double a2 = a(i, 2);
+    t[i][0] = a0 * m00 + a1 * m01 + a2 * m02;
+    t[i][1] = a0 * m01 + a1 * m11 + a2 * m12;
+    t[i][2] = a0 * m02 + a1 * m12 + a2 * m22;
+  }
+  // Only the upper triangle of t * a^T is needed.
+  const auto dot = [&t, &a](int i, int j) {
+    return t[i][0] * a(j, 0) + t[i][1] * a(j, 1) + t[i][2] * a(j, 2);
+  };
+  return SymmetricMatrix3x3(dot(0, 0), dot(0, 1), dot(0, 2), dot(1, 1),
+                            dot(1, 2), dot(2, 2));
+}
+
+bool SolveRightWithCholesky(const SymmetricMatrix3x3& m, const Matrix3x3& b,
+                            Matrix3x3* x) {
+  // m = L * L^T with L lower triangular.
+  const double l00_squared = m(0, 0);
+  if (!(l00_squared > 0.0)) {
+    return false;
+  }
+  const double l00 = std::sqrt(l00_squared);
+  const double inv_l00 = 1.0 / l00;
+  const double l10 = m(1, 0) * inv_l00;
+  const double l20 = m(2, 0) * inv_l00;
+  const double l11_squared = m(1, 1) - l10 * l10;
+  if (!(l11_squared > 0.0)) {
+    return false;
+  }
+  const double inv_l11 = 1.0 / std::sqrt(l11_squared);
+  const double l21 = (m(2, 1) - l20 * l10) * inv_l11;
+  const double l22_squared = m(2, 2) - l20 * l20 - l21 * l21;
+  if (!(l22_squared > 0.0)) {
+    return false;
+  }
+  const double inv_l22 = 1.0 / std::sqrt(l22_squared);
+
+  // Since m is symmetric, every row of x solves m * x_row^T = b_row^T. Solve
+  // L * y = b_row^T by forward substitution, then L^T * x_row^T = y by back
+  // substitution.
+  Matrix3x3& result = *x;
+  for (int row = 0; row < 3; ++row) {
+    const double y0 = b(row, 0) * inv_l00;
+    const double y1 = (b(row, 1) - l10 * y0) * inv_l11;
+    const double y2 = (b(row, 2) - l20 * y0 - l21 * y1) * inv_l22;
+    const double x2 = y2 * inv_l22;
+    const double x1 = (y1 - l21 * x2) * inv_l11;
+    const double x0 = (y0 - l10 * x1 - l20 * x2) * inv_l00;
+    result(row, 0) = x0;
+    result(row, 1) = x1;
+    result(row, 2) = x2;
+  }
+  return true;
+}
+
+SymmetricMatrix3x3 JosephCovarianceUpdate(const SymmetricMatrix3x3& p,
+                                          const Matrix3x3& k,
+                                          const Matrix3x3& h,
+                                          const SymmetricMatrix3x3& r) {
+  return CongruenceTransform(Matrix3x3::Identity() - k * h, p) +
+         CongruenceTransform(k, r);
+}
+
+}  // namespace cardboard
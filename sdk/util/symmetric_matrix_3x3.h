@@ -0,0 +1,118 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_SYMMETRIC_MATRIX_3X3_H_
+#define CARDBOARD_SDK_UTIL_SYMMETRIC_MATRIX_3X3_H_
+
+#include <array>
+
+#include "util/matrix_3x3.h"
+
+namespace cardboard {
+
+// The SymmetricMatrix3x3 class defines a symmetric 3x3 matrix, e.g. a
+// covariance. Only the upper triangle is stored, packed row by row as
+// [m00, m01, m02, m11, m12, m22], so symmetry holds by construction.
+class SymmetricMatrix3x3 {
+ public:
+  // The default constructor zero-initializes all elements.
+  SymmetricMatrix3x3();
+
+  // Constructor that is passed the upper triangle elements.
+  SymmetricMatrix3x3(double m00, double m01, double m02, double m11,
+                     double m12, double m22);
+
+  // Returns a SymmetricMatrix3x3 containing all zeroes.
+  static SymmetricMatrix3x3 Zero();
+
+  // Returns an identity SymmetricMatrix3x3.
+  static SymmetricMatrix3x3 Identity();
+
+  // Returns the symmetric part (m + m^T) / 2 of a matrix.
+  static SymmetricMatrix3x3 FromMatrix(const Matrix3x3& m);
+
+  // Returns the matrix as a general Matrix3x3.
+  Matrix3x3 ToMatrix() const;
+
+  // Read-only element accessor.
+  double operator()(int row, int col) const { return elem_[Index(row, col)]; }
+
+  // Binary scale operators.
+  friend SymmetricMatrix3x3 operator*(const SymmetricMatrix3x3& m, double s) {
+    return Scale(m, s);
+  }
+  friend SymmetricMatrix3x3 operator*(double s, const SymmetricMatrix3x3& m) {
+    return Scale(m, s);
+  }
+
+  // Binary matrix addition.
+  friend SymmetricMatrix3x3 operator+(const SymmetricMatrix3x3& lhs,
+                                      const SymmetricMatrix3x3& rhs) {
+    return Addition(lhs, rhs);
+  }
+
+  // Multiplication by a general matrix, m * rhs.
+  friend Matrix3x3 operator*(const SymmetricMatrix3x3& m,
+                             const Matrix3x3& rhs) {
+    return Product(m, rhs);
+  }
+
+ private:
+  // Returns the index in elem_ of the element at (row, col).
+  static int Index(int row, int col) {
+    static const int kIndex[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+    return kIndex[row][col];
+  }
+
+  static SymmetricMatrix3x3 Scale(const SymmetricMatrix3x3& m, double s);
+  static SymmetricMatrix3x3 Addition(const SymmetricMatrix3x3& lhs,
+                                     const SymmetricMatrix3x3& rhs);
+  static Matrix3x3 Product(const SymmetricMatrix3x3& m, const Matrix3x3& rhs);
+
+  std::array<double, 6> elem_;
+};
+
+// Returns the congruence transform a * m * a^T, computing only the upper
+// triangle of the result.
+SymmetricMatrix3x3 CongruenceTransform(const Matrix3x3& a,
+                                       const SymmetricMatrix3x3& m);
+
+// Computes x = b * m^-1 for a symmetric positive definite m, using its
+// Cholesky decomposition m = L * L^T.
+//
+// @param m symmetric positive definite matrix.
+// @param b right hand side.
+// @param x output solution.
+// @return false if m is not numerically positive definite, in which case x is
+//     not modified.
+bool SolveRightWithCholesky(const SymmetricMatrix3x3& m, const Matrix3x3& b,
+                            Matrix3x3* x);
+
+// Returns the Joseph form covariance update
+// (I - k * h) * p * (I - k * h)^T + k * r * k^T, which keeps the covariance
+// symmetric positive semi-definite for any gain k.
+//
+// @param p prior state covariance.
+// @param k Kalman gain.
+// @param h measurement jacobian.
+// @param r measurement covariance.
+SymmetricMatrix3x3 JosephCovarianceUpdate(const SymmetricMatrix3x3& p,
+                                          const Matrix3x3& k,
+                                          const Matrix3x3& h,
+                                          const SymmetricMatrix3x3& r);
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_SYMMETRIC_MATRIX_3X3_H_
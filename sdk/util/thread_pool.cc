@@ -0,0 +1,108 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/thread_pool.h"
+
+namespace cardboard {
+
+ThreadPool::ThreadPool(int thread_count)
+    : loop_generation_(0),
+      busy_workers_(0),
+      is_stopping_(false),
+      task_(nullptr),
+      iteration_count_(0),
+      next_iteration_(0) {
+  if (thread_count < 1) {
+    thread_count = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  for (int i = 1; i < thread_count; ++i) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  loop_started_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::ParallelFor(int count,
+                             const std::function<void(int)>& task) {
+  if (count <= 0) {
+    return;
+  }
+  if (workers_.empty() || count == 1) {
+    for (int i = 0; i < count; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    iteration_count_ = count;
+    next_iteration_.store(0, std::memory_order_relaxed);
+    busy_workers_ = static_cast<int>(workers_.size());
+    ++loop_generation_;
+  }
+  loop_started_.notify_all();
+
+  RunIterations();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  loop_finished_.wait(lock, [this] { return busy_workers_ == 0; });
+  task_ = nullptr;
+}
+
+void ThreadPool::WorkerLoop() {
+  uint64_t seen_generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      loop_started_.wait(lock, [this, seen_generation] {
+        return is_stopping_ || loop_generation_ != seen_generation;
+      });
+      if (is_stopping_) {
+        return;
+      }
+      seen_generation = loop_generation_;
+    }
+
+    RunIterations();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--busy_workers_ == 0) {
+      loop_finished_.notify_one();
+    }
+  }
+}
+
+void ThreadPool::RunIterations() {
+  while (true) {
+    const int i = next_iteration_.fetch_add(1, std::memory_order_relaxed);
+    if (i >= iteration_count_) {
+      return;
+    }
+    (*task_)(i);
+  }
+}
+
+}  // namespace cardboard
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_THREAD_POOL_H_
+#define CARDBOARD_SDK_UTIL_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cardboard {
+
+// Fixed set of worker threads running the iterations of a parallel loop. The
+// thread calling ParallelFor() runs iterations too, so a pool of one thread
+// has no worker and runs everything inline.
+class ThreadPool {
+ public:
+  // Starts the worker threads.
+  // @param thread_count number of threads running iterations, including the
+  //     calling thread. Values lower than 1 select the hardware concurrency.
+  explicit ThreadPool(int thread_count);
+
+  // Stops the worker threads and waits for them to exit.
+  ~ThreadPool();
+
+  // Runs task(i) for every i in [0, count), spread over the threads, and
+  // returns once all of them ran. Iterations are handed out one at a time, so
+  // uneven iterations balance out. It must not be called concurrently or from
+  // a task.
+  //
+  // @param count number of iterations.
+  // @param task function called with each iteration index.
+  void ParallelFor(int count, const std::function<void(int)>& task);
+
+  // Returns the number of threads running iterations.
+  int GetThreadCount() const { return static_cast<int>(workers_.size()) + 1; }
+
+ private:
+  void WorkerLoop();
+  // Runs iterations of the current loop until none is left.
+  void RunIterations();
+
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable loop_started_;
+  std::condition_variable loop_finished_;
+  // Incremented for each loop, so workers tell a new loop from a spurious
+  // wake-up.
+  uint64_t loop_generation_;
+  // Number of workers still running iterations of the current loop.
+  int busy_workers_;
+  bool is_stopping_;
+
+  const std::function<void(int)>* task_;
+  int iteration_count_;
+  std::atomic<int> next_iteration_;
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_THREAD_POOL_H_
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/trace.h"
+
+#ifdef CARDBOARD_ENABLE_TRACING
+
+#ifdef __ANDROID__
+#include <dlfcn.h>
+#else
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#endif
+
+namespace cardboard {
+namespace trace {
+
+namespace {
+
+#ifdef __ANDROID__
+
+// ATrace functions are only exported from API level 23 (29 for counters), so
+// they are looked up at runtime. Missing functions disable the matching events.
+struct ATraceFunctions {
+  ATraceFunctions() {
+    void* lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+    if (lib == nullptr) {
+      return;
+    }
+    begin_section = reinterpret_cast<void (*)(const char*)>(
+        dlsym(lib, "ATrace_beginSection"));
+    end_section = reinterpret_cast<void (*)()>(dlsym(lib, "ATrace_endSection"));
+    set_counter = reinterpret_cast<void (*)(const char*, int64_t)>(
+        dlsym(lib, "ATrace_setCounter"));
+  }
+
+  void (*begin_section)(const char*) = nullptr;
+  void (*end_section)() = nullptr;
+  void (*set_counter)(const char*, int64_t) = nullptr;
+};
+
+const ATraceFunctions& GetATraceFunctions() {
+  static const ATraceFunctions* functions = new ATraceFunctions();
+  return *functions;
+}
+
+#else  // __ANDROID__
+
+// Default name of the trace file.
+constexpr char kDefaultTraceFile[] = "cardboard_trace.json";
+
+int64_t GetMonotonicTimeNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Appends trace events to a file in the Chrome trace event JSON array format.
+// The writer lives until the process exits, as threads may emit events during
+// exit, so the closing bracket is never written. Trace viewers accept files
+// without it. Each event is flushed, so the file is complete at any time.
+class JsonTraceWriter {
+ public:
+  JsonTraceWriter() : file_(nullptr), is_first_event_(true) {
+    const char* path = std::getenv("CARDBOARD_TRACE_FILE");
+    file_ = std::fopen(path != nullptr ? path : kDefaultTraceFile, "w");
+    if (file_ != nullptr) {
+      std::fputs("[\n", file_);
+    }
+  }
+
+  void WriteCompleteEvent(const char* name, int64_t begin_time_ns,
+                          int64_t end_time_ns) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (BeginEvent()) {
+      std::fprintf(file_,
+                   "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                   "\"pid\":%d,\"tid\":%u}",
+                   name, begin_time_ns * 1e-3,
+                   (end_time_ns - begin_time_ns) * 1e-3, getpid(),
+                   GetThreadId());
+      std::fflush(file_);
+    }
+  }
+
+  void WriteCounterEvent(const char* name, int64_t value) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (BeginEvent()) {
+      std::fprintf(file_,
+                   "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,"
+                   "\"args\":{\"value\":%lld}}",
+                   name, GetMonotonicTimeNs() * 1e-3, getpid(),
+                   static_cast<long long>(value));
+      std::fflush(file_);
+    }
+  }
+
+ private:
+  // Writes the separator before a new event. Returns false if there is no
+  // trace file. Must be called with mutex_ held.
+  bool BeginEvent() {
+    if (file_ == nullptr) {
+      return false;
+    }
+    if (!is_first_event_) {
+      std::fputs(",\n", file_);
+    }
+    is_first_event_ = false;
+    return true;
+  }
+
+  static unsigned int GetThreadId() {
+    return static_cast<unsigned int>(
+        std::hash<std::thread::id>()(std::this_thread::get_id()));
+  }
+
+  std::mutex mutex_;
+  std::FILE* file_;
+  bool is_first_event_;
+};
+
+JsonTraceWriter& GetJsonTraceWriter() {
+  static JsonTraceWriter* writer = new JsonTraceWriter();
+  return *writer;
+}
+
+#endif  // __ANDROID__
+
+}  // namespace
+
+#ifdef __ANDROID__
+
+ScopedTrace::ScopedTrace(const char* name) : name_(name), begin_time_ns_(0) {
+  const ATraceFunctions& atrace = GetATraceFunctions();
+  if (atrace.begin_section != nullptr) {
+    atrace.begin_section(name_);
+  }
+}
+
+ScopedTrace::~ScopedTrace() {
+  const ATraceFunctions& atrace = GetATraceFunctions();
+  if (atrace.end_section != nullptr) {
+    atrace.end_section();
+  }
+}
+
+void SetCounter(const char* name, int64_t value) {
+  const ATraceFunctions& atrace = GetATraceFunctions();
+  if (atrace.set_counter != nullptr) {
+    atrace.set_counter(name, value);
+  }
+}
+
+#else  // __ANDROID__
+
+ScopedTrace::ScopedTrace(const char* name)
+    : name_(name), begin_time_ns_(GetMonotonicTimeNs()) {}
+
+ScopedTrace::~ScopedTrace() {
+  GetJsonTraceWriter().WriteCompleteEvent(name_, begin_time_ns_,
+                                          GetMonotonicTimeNs());
+}
+
+void SetCounter(const char* name, int64_t value) {
+  GetJsonTraceWriter().WriteCounterEvent(name, value);
+}
+
+#endif  // __ANDROID__
+
+}  // namespace trace
+}  // namespace cardboard
+
+#endif  // CARDBOARD_ENABLE_TRACING
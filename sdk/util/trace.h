@@ -0,0 +1,81 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_TRACE_H_
+#define CARDBOARD_SDK_UTIL_TRACE_H_
+
+#include <cstdint>
+
+// Tracing of the SDK hot paths, compiled in only when CARDBOARD_ENABLE_TRACING
+// is defined. Otherwise the macros below expand to nothing.
+//
+// On Android, events are emitted through ATrace, so they show up in systrace
+// and Perfetto captures next to the engine ones. On other platforms they are
+// appended as Chrome trace events to the JSON file named by the
+// CARDBOARD_TRACE_FILE environment variable, cardboard_trace.json by default,
+// which chrome://tracing and ui.perfetto.dev can load. Timestamps are taken
+// from the monotonic clock.
+//
+// Names must be string literals without characters that need JSON escaping.
+
+#ifdef CARDBOARD_ENABLE_TRACING
+
+#define CARDBOARD_TRACE_CONCAT_INNER(a, b) a##b
+#define CARDBOARD_TRACE_CONCAT(a, b) CARDBOARD_TRACE_CONCAT_INNER(a, b)
+
+// @def Traces the enclosing scope as a slice called @p name.
+#define CARDBOARD_TRACE_SCOPE(name)     \
+  ::cardboard::trace::ScopedTrace       \
+  CARDBOARD_TRACE_CONCAT(cardboard_trace_scope_, __LINE__)(name)
+
+// @def Sets the counter called @p name to @p value.
+#define CARDBOARD_TRACE_COUNTER(name, value) \
+  ::cardboard::trace::SetCounter(name, static_cast<int64_t>(value))
+
+namespace cardboard {
+namespace trace {
+
+// Emits a slice spanning the lifetime of the object.
+class ScopedTrace {
+ public:
+  explicit ScopedTrace(const char* name);
+  ~ScopedTrace();
+
+ private:
+  const char* name_;
+  // Start of the slice, only used by the JSON output.
+  int64_t begin_time_ns_;
+
+  ScopedTrace(const ScopedTrace&) = delete;
+  ScopedTrace& operator=(const ScopedTrace&) = delete;
+};
+
+// Emits a counter value.
+//
+// @param name counter name.
+// @param value counter value.
+void SetCounter(const char* name, int64_t value);
+
+}  // namespace trace
+}  // namespace cardboard
+
+#else  // CARDBOARD_ENABLE_TRACING
+
+#define CARDBOARD_TRACE_SCOPE(name)
+#define CARDBOARD_TRACE_COUNTER(name, value)
+
+#endif  // CARDBOARD_ENABLE_TRACING
+
+#endif  // CARDBOARD_SDK_UTIL_TRACE_H_
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2020 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_TRIPLE_BUFFER_H_
+#define CARDBOARD_SDK_UTIL_TRIPLE_BUFFER_H_
+
+#include <array>
+#include <atomic>
+
+namespace cardboard {
+
+// Lock-free single producer, single consumer buffer publishing the latest
+// value of T. The producer writes into its own slot and atomically swaps it
+// with the shared one, so it never waits for the consumer and the consumer
+// never sees a partially written value. Intermediate values may be skipped.
+template <typename T>
+class TripleBuffer {
+ public:
+  // Creates a buffer whose three slots hold initial_value.
+  // @param initial_value value returned by Read() before the first Write().
+  explicit TripleBuffer(const T& initial_value)
+      : slots_{{initial_value, initial_value, initial_value}},
+        write_index_(0),
+        shared_index_(1),
+        read_index_(2) {}
+
+  // Publishes value. Must only be called from the producer thread.
+  //
+  // @param value value to publish.
+  void Write(const T& value) {
+    slots_[write_index_] = value;
+    write_index_ =
+        shared_index_.exchange(write_index_ | kFreshBit,
+                               std::memory_order_acq_rel) &
+        kIndexMask;
+  }
+
+  // Returns the latest published value. Must only be called from the consumer
+  // thread. The reference is valid until the next call to Read().
+  const T& Read() {
+    if (shared_index_.load(std::memory_order_relaxed) & kFreshBit) {
+      read_index_ =
+          shared_index_.exchange(read_index_, std::memory_order_acq_rel) &
+          kIndexMask;
+    }
+    return slots_[read_index_];
+  }
+
+ private:
+  // The shared index holds the slot index in its low bits and flags with
+  // kFreshBit whether it was written since the consumer last took it.
+  static constexpr int kIndexMask = 0x3;
+  static constexpr int kFreshBit = 0x4;
+
+  std::array<T, 3> slots_;
+  // Slot owned by the producer.
+  int write_index_;
+  // Slot exchanged between the producer and the consumer.
+  std::atomic<int> shared_index_;
+  // Slot owned by the consumer.
+  int read_index_;
+
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_TRIPLE_BUFFER_H_
@@ -42,8 +42,12 @@ class Vector {
   // Mutable element accessor.
   double& operator[](int index) { return elem_[index]; }
 
-  // Element accessor.
-  double operator[](int index) const { return elem_[index]; }
+  // Element accessor. It is constexpr for the constexpr constructors.
+  constexpr double operator[](int index) const { return elem_[index]; }
+
+  // Return a pointer to the data for interfacing with libraries.
+  double* Data() { return elem_.data(); }
+  const double* Data() const { return elem_.data(); }
 
   // Returns a Vector containing all zeroes.
   static Vector Zero();